@@ -0,0 +1,231 @@
+#include "../source/structures/audio-kernels.h"
+#include "../source/structures/waveform-data.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/*
+* headless benchmark of the audio reduction kernels, it only links the kernels and the waveform pyramid.
+* a synthetic stereo song gets generated from the settings below, every kernel set the cpu supports is checked against the scalar one and then timed.
+* every benchmark prints one json line to stdout, the timings are the fastest of all repetitions.
+*/
+
+struct BenchmarkSettings
+{
+	int DurationSeconds = 240;
+	int SampleRate = 44100;
+	int BlockFrameAmount = 32;
+	int Repetitions = 5;
+	unsigned int Seed = 1;
+};
+
+//a few tones with some noise on top, loud enough to use the whole range
+std::vector<float> GenerateSyntheticSong(const BenchmarkSettings& InSettings)
+{
+	const size_t frameAmount = size_t(InSettings.DurationSeconds) * InSettings.SampleRate;
+
+	std::vector<float> samples(frameAmount * 2);
+	std::mt19937 random(InSettings.Seed);
+	std::uniform_real_distribution<float> noiseDistribution(-0.1f, 0.1f);
+
+	const double tau = 6.283185307179586;
+
+	for (size_t frame = 0; frame < frameAmount; ++frame)
+	{
+		const double time = double(frame) / InSettings.SampleRate;
+
+		samples[frame * 2] = float(0.6 * std::sin(tau * 110.0 * time) + 0.2 * std::sin(tau * 1760.0 * time)) + noiseDistribution(random);
+		samples[frame * 2 + 1] = float(0.5 * std::sin(tau * 220.0 * time + 1.0)) + noiseDistribution(random);
+	}
+
+	return samples;
+}
+
+template<typename TWork>
+double RunBenchmark(const BenchmarkSettings& InSettings, TWork&& InWork)
+{
+	double seconds = std::numeric_limits<double>::max();
+
+	for (int repetition = 0; repetition < InSettings.Repetitions; ++repetition)
+	{
+		const auto timeBegin = std::chrono::steady_clock::now();
+		InWork();
+		const auto timeEnd = std::chrono::steady_clock::now();
+
+		seconds = std::min(seconds, std::chrono::duration<double>(timeEnd - timeBegin).count());
+	}
+
+	return seconds;
+}
+
+void PrintResult(const char* InName, const char* InKernelSetName, const size_t InSampleAmount, const double InSeconds)
+{
+	std::printf("{\"benchmark\":\"%s\",\"kernels\":\"%s\",\"samples\":%zu,\"seconds\":%.9f,\"samples_per_second\":%.1f}\n",
+		InName, InKernelSetName, InSampleAmount, InSeconds, InSeconds > 0.0 ? double(InSampleAmount) / InSeconds : 0.0);
+}
+
+bool ArePeaksEqual(const ChannelPeaks& InPeaks, const ChannelPeaks& InReferencePeaks)
+{
+	//the vector kernels sum up the squares in another order
+	return InPeaks.Min == InReferencePeaks.Min && InPeaks.Max == InReferencePeaks.Max && std::abs(InPeaks.SquareSum - InReferencePeaks.SquareSum) <= 1e-4 * InReferencePeaks.SquareSum + 1e-6;
+}
+
+//every block size from empty to a few vectors long, so the scalar tails get checked as well
+bool VerifyKernels(const AudioKernels& InKernels, const AudioKernels& InReferenceKernels, const std::vector<float>& InSamples)
+{
+	std::vector<float> mono(InSamples.size() / 2), referenceMono(InSamples.size() / 2);
+
+	for (size_t frameAmount = 0; frameAmount <= 67; ++frameAmount)
+	{
+		for (size_t offset = 0; offset < 3; ++offset)
+		{
+			const float* const samples = InSamples.data() + offset;
+
+			ChannelPeaks left, right, referenceLeft, referenceRight;
+			InKernels.ReduceStereo(samples, frameAmount, left, right);
+			InReferenceKernels.ReduceStereo(samples, frameAmount, referenceLeft, referenceRight);
+
+			ChannelPeaks channel, referenceChannel;
+			InKernels.ReduceChannel(samples, frameAmount, channel);
+			InReferenceKernels.ReduceChannel(samples, frameAmount, referenceChannel);
+
+			InKernels.DownmixStereo(samples, frameAmount, mono.data());
+			InReferenceKernels.DownmixStereo(samples, frameAmount, referenceMono.data());
+
+			const bool isEqual = ArePeaksEqual(left, referenceLeft) && ArePeaksEqual(right, referenceRight) && ArePeaksEqual(channel, referenceChannel)
+				&& InKernels.FindAbsMax(samples, frameAmount) == InReferenceKernels.FindAbsMax(samples, frameAmount)
+				&& std::memcmp(mono.data(), referenceMono.data(), frameAmount * sizeof(float)) == 0;
+
+			if (!isEqual)
+			{
+				std::fprintf(stderr, "%s kernels differ from %s ones on %zu frames at offset %zu\n", InKernels.Name, InReferenceKernels.Name, frameAmount, offset);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool ParseArgument(const char* InArgument, const char* InName, double& OutValue)
+{
+	const size_t nameLength = std::strlen(InName);
+
+	if (std::strncmp(InArgument, InName, nameLength) != 0 || InArgument[nameLength] != '=')
+		return false;
+
+	OutValue = std::atof(InArgument + nameLength + 1);
+
+	return true;
+}
+
+int main(int InArgumentCount, char** InArguments)
+{
+	BenchmarkSettings settings;
+
+	for (int index = 1; index < InArgumentCount; ++index)
+	{
+		double value = 0.0;
+
+		if (ParseArgument(InArguments[index], "--duration", value))
+			settings.DurationSeconds = std::max(1, int(value));
+		else if (ParseArgument(InArguments[index], "--sample-rate", value))
+			settings.SampleRate = std::max(1000, int(value));
+		else if (ParseArgument(InArguments[index], "--block", value))
+			settings.BlockFrameAmount = std::max(1, int(value));
+		else if (ParseArgument(InArguments[index], "--repetitions", value))
+			settings.Repetitions = std::max(1, int(value));
+		else if (ParseArgument(InArguments[index], "--seed", value))
+			settings.Seed = unsigned(value);
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--duration=240 (seconds)] [--sample-rate=44100] [--block=32 (frames per reduction)] [--repetitions=5] [--seed=1]\n", InArguments[0]);
+			return 1;
+		}
+	}
+
+	const std::vector<float> samples = GenerateSyntheticSong(settings);
+	const size_t frameAmount = samples.size() / 2;
+	const size_t blockFrameAmount = size_t(settings.BlockFrameAmount);
+
+	std::printf("{\"settings\":{\"duration\":%d,\"sample_rate\":%d,\"block\":%d,\"repetitions\":%d,\"seed\":%u,\"samples\":%zu,\"dispatched_kernels\":\"%s\"}}\n",
+		settings.DurationSeconds, settings.SampleRate, settings.BlockFrameAmount, settings.Repetitions, settings.Seed, samples.size(), GetAudioKernels().Name);
+
+	const AudioKernels& scalarKernels = GetAudioKernels(EAudioKernelSet::Scalar);
+
+	std::vector<float> mono(frameAmount);
+	double checkSum = 0.0;
+
+	for (const EAudioKernelSet kernelSet : { EAudioKernelSet::Scalar, EAudioKernelSet::Sse2, EAudioKernelSet::Avx2 })
+	{
+		if (!IsAudioKernelSetSupported(kernelSet))
+			continue;
+
+		const AudioKernels& kernels = GetAudioKernels(kernelSet);
+
+		if (!VerifyKernels(kernels, scalarKernels, samples))
+			return 1;
+
+		//one reduction per block like the waveform does it for its finest buckets
+		PrintResult("reduce_stereo", kernels.Name, samples.size(), RunBenchmark(settings, [&]()
+		{
+			for (size_t frame = 0; frame < frameAmount; frame += blockFrameAmount)
+			{
+				ChannelPeaks left, right;
+				kernels.ReduceStereo(samples.data() + frame * 2, std::min(blockFrameAmount, frameAmount - frame), left, right);
+
+				checkSum += left.Max + right.Max;
+			}
+		}));
+
+		PrintResult("reduce_channel", kernels.Name, samples.size(), RunBenchmark(settings, [&]()
+		{
+			for (size_t sample = 0; sample < samples.size(); sample += blockFrameAmount * 2)
+			{
+				ChannelPeaks channel;
+				kernels.ReduceChannel(samples.data() + sample, std::min(blockFrameAmount * 2, samples.size() - sample), channel);
+
+				checkSum += channel.SquareSum;
+			}
+		}));
+
+		PrintResult("find_abs_max", kernels.Name, samples.size(), RunBenchmark(settings, [&]()
+		{
+			checkSum += kernels.FindAbsMax(samples.data(), samples.size());
+		}));
+
+		PrintResult("downmix_stereo", kernels.Name, samples.size(), RunBenchmark(settings, [&]()
+		{
+			kernels.DownmixStereo(samples.data(), frameAmount, mono.data());
+
+			checkSum += mono[frameAmount / 2];
+		}));
+	}
+
+	//the whole waveform pyramid the way the decoder thread feeds it, with the kernels the cpu got dispatched to
+	const size_t chunkFrameAmount = 32768;
+
+	PrintResult("build_waveform", GetAudioKernels().Name, samples.size(), RunBenchmark(settings, [&]()
+	{
+		WaveFormData waveFormData;
+		waveFormData.Reset(frameAmount, 2, double(settings.SampleRate));
+
+		for (size_t frame = 0; frame < frameAmount; frame += chunkFrameAmount)
+			waveFormData.AppendFrames(samples.data() + frame * 2, std::min(chunkFrameAmount, frameAmount - frame));
+
+		waveFormData.Finish();
+
+		checkSum += double(waveFormData.GetBucketAmount(0));
+	}));
+
+	//keeps the reductions from being optimized away
+	std::fprintf(stderr, "checksum %f\n", checkSum);
+
+	return 0;
+}
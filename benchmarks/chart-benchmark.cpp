@@ -0,0 +1,290 @@
+#include "../source/structures/chart.h"
+#include "../source/modules/beat-module.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+
+/*
+* headless benchmark of the chart core, it only links the chart and beat code.
+* a synthetic chart gets generated from the settings below, every benchmark then prints one json line to stdout.
+* the timings are the fastest of all repetitions, the allocations are the ones of a single repetition.
+*/
+
+static size_t static_AllocationCount = 0;
+static size_t static_AllocatedBytes = 0;
+
+void* operator new(size_t InSize)
+{
+	static_AllocationCount++;
+	static_AllocatedBytes += InSize;
+
+	if (void* memory = std::malloc(InSize ? InSize : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* InMemory) noexcept
+{
+	std::free(InMemory);
+}
+
+void operator delete(void* InMemory, size_t InSize) noexcept
+{
+	std::free(InMemory);
+}
+
+struct BenchmarkSettings
+{
+	int KeyAmount = 4;
+	double NotesPerSecond = 20.0;
+	double HoldRatio = 0.2;
+	int BpmChangeAmount = 8;
+	int DurationSeconds = 180;
+	int Repetitions = 5;
+	unsigned int Seed = 1;
+};
+
+struct SyntheticChart
+{
+	std::vector<std::pair<Column, Note>> Notes;
+	std::vector<BpmPoint> BpmPoints;
+};
+
+struct BenchmarkResult
+{
+	double Seconds = 0.0;
+	size_t Allocations = 0;
+	size_t AllocatedBytes = 0;
+};
+
+SyntheticChart GenerateSyntheticChart(const BenchmarkSettings& InSettings)
+{
+	SyntheticChart syntheticChart;
+	std::mt19937 random(InSettings.Seed);
+
+	const Time duration = InSettings.DurationSeconds * 1000;
+
+	for (int index = 0; index <= InSettings.BpmChangeAmount; ++index)
+	{
+		BpmPoint bpmPoint;
+		bpmPoint.TimePoint = Time(double(duration) * index / (InSettings.BpmChangeAmount + 1));
+		bpmPoint.Bpm = std::uniform_real_distribution<double>(100.0, 250.0)(random);
+		bpmPoint.BeatLength = 60000.0 / bpmPoint.Bpm;
+
+		syntheticChart.BpmPoints.push_back(bpmPoint);
+	}
+
+	//every column gets an even share of the density, the gaps are spread around their mean
+	const double meanGap = 1000.0 * InSettings.KeyAmount / InSettings.NotesPerSecond;
+
+	std::uniform_real_distribution<double> gapDistribution(0.5 * meanGap, 1.5 * meanGap);
+	std::uniform_real_distribution<double> chanceDistribution(0.0, 1.0);
+	std::uniform_int_distribution<Time> holdLengthDistribution(100, 1000);
+
+	for (Column column = 0; column < Column(InSettings.KeyAmount); ++column)
+	{
+		for (Time time = Time(gapDistribution(random)); time < duration; time += std::max(Time(gapDistribution(random)), Time(30)))
+		{
+			Note note;
+			note.TimePoint = time;
+
+			if (chanceDistribution(random) < InSettings.HoldRatio)
+			{
+				note.Type = Note::EType::HoldBegin;
+				note.TimePointBegin = time;
+				note.TimePointEnd = time + holdLengthDistribution(random);
+
+				time = note.TimePointEnd;
+			}
+			else
+			{
+				note.Type = Note::EType::Common;
+				note.TimePointBegin = -1;
+				note.TimePointEnd = -1;
+			}
+
+			syntheticChart.Notes.push_back({ column, note });
+		}
+	}
+
+	return syntheticChart;
+}
+
+void SetupChart(Chart& OutChart, const SyntheticChart& InSyntheticChart, const BenchmarkSettings& InSettings, const bool InWithNotes)
+{
+	OutChart.KeyAmount = InSettings.KeyAmount;
+
+	for (const auto& bpmPoint : InSyntheticChart.BpmPoints)
+		OutChart.InjectBpmPoint(bpmPoint.TimePoint, bpmPoint.Bpm, bpmPoint.BeatLength);
+
+	if (InWithNotes)
+		OutChart.BulkPlaceNotes(InSyntheticChart.Notes, true, true);
+}
+
+template<typename TSetup, typename TWork>
+BenchmarkResult RunBenchmark(const BenchmarkSettings& InSettings, TSetup&& InSetup, TWork&& InWork)
+{
+	BenchmarkResult result;
+	result.Seconds = std::numeric_limits<double>::max();
+
+	for (int repetition = 0; repetition < InSettings.Repetitions; ++repetition)
+	{
+		Chart chart;
+		InSetup(chart);
+
+		const size_t allocationCount = static_AllocationCount;
+		const size_t allocatedBytes = static_AllocatedBytes;
+
+		const auto timeBegin = std::chrono::steady_clock::now();
+		InWork(chart);
+		const auto timeEnd = std::chrono::steady_clock::now();
+
+		result.Seconds = std::min(result.Seconds, std::chrono::duration<double>(timeEnd - timeBegin).count());
+		result.Allocations = static_AllocationCount - allocationCount;
+		result.AllocatedBytes = static_AllocatedBytes - allocatedBytes;
+	}
+
+	return result;
+}
+
+void PrintResult(const char* InName, const size_t InOperations, const BenchmarkResult& InResult)
+{
+	std::printf("{\"benchmark\":\"%s\",\"operations\":%zu,\"seconds\":%.9f,\"operations_per_second\":%.1f,\"allocations\":%zu,\"allocated_bytes\":%zu}\n",
+		InName, InOperations, InResult.Seconds, InResult.Seconds > 0.0 ? double(InOperations) / InResult.Seconds : 0.0, InResult.Allocations, InResult.AllocatedBytes);
+}
+
+bool ParseArgument(const char* InArgument, const char* InName, double& OutValue)
+{
+	const size_t nameLength = std::strlen(InName);
+
+	if (std::strncmp(InArgument, InName, nameLength) != 0 || InArgument[nameLength] != '=')
+		return false;
+
+	OutValue = std::atof(InArgument + nameLength + 1);
+
+	return true;
+}
+
+int main(int InArgumentCount, char** InArguments)
+{
+	BenchmarkSettings settings;
+
+	for (int index = 1; index < InArgumentCount; ++index)
+	{
+		double value = 0.0;
+
+		if (ParseArgument(InArguments[index], "--keys", value))
+			settings.KeyAmount = std::max(1, int(value));
+		else if (ParseArgument(InArguments[index], "--density", value))
+			settings.NotesPerSecond = std::max(0.1, value);
+		else if (ParseArgument(InArguments[index], "--hold-ratio", value))
+			settings.HoldRatio = value;
+		else if (ParseArgument(InArguments[index], "--bpm-changes", value))
+			settings.BpmChangeAmount = std::max(0, int(value));
+		else if (ParseArgument(InArguments[index], "--duration", value))
+			settings.DurationSeconds = std::max(1, int(value));
+		else if (ParseArgument(InArguments[index], "--repetitions", value))
+			settings.Repetitions = std::max(1, int(value));
+		else if (ParseArgument(InArguments[index], "--seed", value))
+			settings.Seed = unsigned(value);
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--keys=4] [--density=20 (notes per second)] [--hold-ratio=0.2] [--bpm-changes=8] [--duration=180 (seconds)] [--repetitions=5] [--seed=1]\n", InArguments[0]);
+			return 1;
+		}
+	}
+
+	const SyntheticChart syntheticChart = GenerateSyntheticChart(settings);
+
+	std::vector<std::pair<Column, Note>> commonNotes;
+	std::vector<std::pair<Column, Note>> holdNotes;
+
+	for (const auto& [column, note] : syntheticChart.Notes)
+		(note.Type == Note::EType::Common ? commonNotes : holdNotes).push_back({ column, note });
+
+	std::printf("{\"settings\":{\"keys\":%d,\"density\":%.2f,\"hold_ratio\":%.2f,\"bpm_changes\":%d,\"duration\":%d,\"repetitions\":%d,\"seed\":%u,\"notes\":%zu,\"holds\":%zu}}\n",
+		settings.KeyAmount, settings.NotesPerSecond, settings.HoldRatio, settings.BpmChangeAmount, settings.DurationSeconds, settings.Repetitions, settings.Seed, syntheticChart.Notes.size(), holdNotes.size());
+
+	auto setupEmpty = [&](Chart& OutChart) { SetupChart(OutChart, syntheticChart, settings, false); };
+	auto setupFilled = [&](Chart& OutChart) { SetupChart(OutChart, syntheticChart, settings, true); };
+
+	PrintResult("place_note", commonNotes.size(), RunBenchmark(settings, setupEmpty, [&](Chart& InOutChart)
+	{
+		for (const auto& [column, note] : commonNotes)
+			InOutChart.PlaceNote(note.TimePoint, column);
+	}));
+
+	PrintResult("place_hold", holdNotes.size(), RunBenchmark(settings, setupEmpty, [&](Chart& InOutChart)
+	{
+		for (const auto& [column, note] : holdNotes)
+			InOutChart.PlaceHold(note.TimePointBegin, note.TimePointEnd, column);
+	}));
+
+	PrintResult("bulk_place_notes", syntheticChart.Notes.size(), RunBenchmark(settings, setupEmpty, [&](Chart& InOutChart)
+	{
+		InOutChart.BulkPlaceNotes(syntheticChart.Notes);
+	}));
+
+	PrintResult("mirror_notes", syntheticChart.Notes.size(), RunBenchmark(settings, setupFilled, [&](Chart& InOutChart)
+	{
+		NoteReferenceCollection notes;
+		InOutChart.FillNoteCollectionWithAllNotes(notes);
+		InOutChart.MirrorNotes(notes);
+	}));
+
+	PrintResult("bulk_remove_notes", syntheticChart.Notes.size(), RunBenchmark(settings, setupFilled, [&](Chart& InOutChart)
+	{
+		NoteReferenceCollection notes;
+		InOutChart.FillNoteCollectionWithAllNotes(notes);
+		InOutChart.BulkRemoveNotes(notes);
+	}));
+
+	PrintResult("undo", syntheticChart.Notes.size(), RunBenchmark(settings, [&](Chart& OutChart)
+	{
+		setupFilled(OutChart);
+
+		NoteReferenceCollection notes;
+		OutChart.FillNoteCollectionWithAllNotes(notes);
+		OutChart.BulkRemoveNotes(notes);
+	},
+	[&](Chart& InOutChart)
+	{
+		InOutChart.Undo();
+	}));
+
+	//scrolling through the whole chart with a window of two seconds, one query per 60fps frame at regular speed
+	const Time windowLength = 2000;
+	const Time scrollStep = 16;
+	const size_t queryAmount = size_t(settings.DurationSeconds * 1000 / scrollStep);
+
+	size_t visitedNotes = 0;
+
+	PrintResult("iterate_notes_in_time_range", queryAmount, RunBenchmark(settings, setupFilled, [&](Chart& InOutChart)
+	{
+		for (size_t query = 0; query < queryAmount; ++query)
+		{
+			const Time timeBegin = Time(query) * scrollStep;
+
+			InOutChart.IterateNotesInTimeRange(timeBegin, timeBegin + windowLength, [&visitedNotes](const Note& InNote, const Column InColumn) { visitedNotes++; });
+		}
+	}));
+
+	BeatModule beatModule;
+	beatModule.StartUp();
+
+	PrintResult("assign_notes_to_snaps", syntheticChart.Notes.size(), RunBenchmark(settings, setupFilled, [&](Chart& InOutChart)
+	{
+		beatModule.AssignNotesToSnapsInChart(&InOutChart);
+	}));
+
+	//keeps the iteration from being optimized away
+	std::fprintf(stderr, "visited %zu notes\n", visitedNotes);
+
+	return 0;
+}
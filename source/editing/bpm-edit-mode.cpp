@@ -12,11 +12,18 @@ bool BpmEditMode::OnMouseLeftButtonClicked(const bool InIsShiftDown)
         _MovableBpmPoint = _HoveredBpmPoint;
         _MovableBpmPointInitialValue = *_MovableBpmPoint;
 
-        static_Chart->RegisterTimeSliceHistory(_MovableBpmPoint->TimePoint);
+        EditCoalesceKey coalesceKey;
+        coalesceKey.Type = EditCoalesceKey::EType::BpmPointDrag;
+        coalesceKey.TimePoint = _MovableBpmPoint->TimePoint;
+
+        static_Chart->BeginEditHistoryEntry(coalesceKey);
 
         _PreviousBpmPoint = static_Chart->GetPreviousBpmPointFromTimePoint(_MovableBpmPoint->TimePoint);
         _NextBpmPoint = static_Chart->GetNextBpmPointFromTimePoint(_MovableBpmPoint->TimePoint);
 
+        if(_PreviousBpmPoint)
+            _PreviousBpmPointInitialValue = *_PreviousBpmPoint;
+
         return false;
     }
 
@@ -33,8 +40,18 @@ bool BpmEditMode::OnMouseLeftButtonReleased()
 {
     if(_MovableBpmPoint != nullptr)
     {
+        //auto timing has been stretching the previous point along, which has to be recorded before the moved point might reallocate its slice
+        if(_PreviousBpmPoint && static_Flags.UseAutoTiming)
+            static_Chart->RegisterBpmPointModification(_PreviousBpmPointInitialValue, *_PreviousBpmPoint);
+
         static_Chart->RevaluateBpmPoint(_MovableBpmPointInitialValue, *_MovableBpmPoint);
 
+        EditCoalesceKey coalesceKey;
+        coalesceKey.Type = EditCoalesceKey::EType::BpmPointDrag;
+        coalesceKey.TimePoint = _MovableBpmPoint->TimePoint;
+
+        static_Chart->SetEditHistoryCoalesceKey(coalesceKey);
+
         _MovableBpmPoint = nullptr;
         return false;
     }
@@ -46,6 +63,8 @@ bool BpmEditMode::OnMouseRightButtonClicked(const bool InIsShiftDown)
 {
     if(_HoveredBpmPoint && !_MovableBpmPoint)
     {
+        static_Chart->BeginEditHistoryEntry();
+
         if(static_Flags.UseAutoTiming)
         {
             if(BpmPoint* previousBpmPoint = static_Chart->GetPreviousBpmPointFromTimePoint(_HoveredBpmPoint->TimePoint))
@@ -56,17 +75,21 @@ bool BpmEditMode::OnMouseRightButtonClicked(const bool InIsShiftDown)
 	
                     double beatLength = double(deltaTime);
                     double newBpm = 60000.0 / beatLength;
+
+                    BpmPoint formerBpmPoint = *previousBpmPoint;
     
                     previousBpmPoint->BeatLength = beatLength;
                     previousBpmPoint->Bpm = newBpm;
+
+                    static_Chart->RegisterBpmPointModification(formerBpmPoint, *previousBpmPoint);
                 }
             }
         }
 
-        static_Chart->RemoveBpmPoint(*_HoveredBpmPoint);
+        static_Chart->RemoveBpmPoint(*_HoveredBpmPoint, true);
         _HoveredBpmPoint = nullptr;
 
-        _VisibleBpmPoints->clear();
+        _VisibleBpmPoints.clear();
     }
 
     return false;
@@ -97,10 +120,9 @@ void BpmEditMode::SubmitToRenderGraph(TimefieldRenderGraph& InOutTimefieldRender
         });
     }
 
-    //a bit hacky but if it works and is isolated it works for now I guess
-	_VisibleBpmPoints = &(static_Chart->GetBpmPointsRelatedToTimeRange(InTimeBegin, InTimeEnd));
+	static_Chart->GetBpmPointsRelatedToTimeRange(InTimeBegin, InTimeEnd, _VisibleBpmPoints);
 
-	for (auto& bpmPointPtr : *_VisibleBpmPoints)
+	for (auto& bpmPointPtr : _VisibleBpmPoints)
 	{
         InOutTimefieldRenderGraph.SubmitTimefieldRenderCommand(0, bpmPointPtr->TimePoint, 
         [this, bpmPointPtr](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
@@ -161,7 +183,7 @@ void BpmEditMode::Tick()
         _MovableBpmPoint->TimePoint = GetCursorTime();
 
         if(!static_Flags.UseAutoTiming)
-            return;
+            return static_Chart->RefreshTempoMap();
 
         if(_PreviousBpmPoint)
         {
@@ -185,10 +207,12 @@ void BpmEditMode::Tick()
             _MovableBpmPoint->Bpm = newBpm;
         }
 
+        static_Chart->RefreshTempoMap();
+
         return;
     }
 
-    for (auto& bpmPointPtr : *_VisibleBpmPoints)
+    for (auto& bpmPointPtr : _VisibleBpmPoints)
 	{
         if(abs(GetCursorTime() - bpmPointPtr->TimePoint) < 20 && static_Cursor.TimefieldSide == Cursor::FieldPosition::Middle)
             return void(_HoveredBpmPoint = bpmPointPtr);
@@ -202,15 +226,21 @@ void BpmEditMode::PlaceAutoTimePoint()
     Time cursorTime = GetCursorTime() ;
     BpmPoint* placedBpmPoint = nullptr;
 
+    static_Chart->BeginEditHistoryEntry();
+
     if(BpmPoint* previousBpmPoint = static_Chart->GetPreviousBpmPointFromTimePoint(GetCursorTime()))
     {
         Time deltaTime = abs(previousBpmPoint->TimePoint - cursorTime);
 	
         double beatLength = double(deltaTime);
         double newBpm = 60000.0 / beatLength;
+
+        BpmPoint formerBpmPoint = *previousBpmPoint;
     
         previousBpmPoint->BeatLength = beatLength;
         previousBpmPoint->Bpm = newBpm;
+
+        static_Chart->RegisterBpmPointModification(formerBpmPoint, *previousBpmPoint);
     }
 
     if(BpmPoint* nextBpmPoint =  static_Chart->GetNextBpmPointFromTimePoint(cursorTime))
@@ -220,10 +250,10 @@ void BpmEditMode::PlaceAutoTimePoint()
         double beatLength = double(deltaTime);
         double newBpm = 60000.0 / beatLength;
     
-        static_Chart->PlaceBpmPoint(cursorTime, newBpm, beatLength);
+        static_Chart->PlaceBpmPoint(cursorTime, newBpm, beatLength, true);
     }
     else   
-        static_Chart->PlaceBpmPoint(cursorTime, 120.0, 60000.0 / 120.0);
+        static_Chart->PlaceBpmPoint(cursorTime, 120.0, 60000.0 / 120.0, true);
 }
 
 void BpmEditMode::PlaceTimePoint() 
@@ -269,10 +299,15 @@ void BpmEditMode::DisplayBpmNode(BpmPoint& InBpmPoint, const int InScreenX, cons
 	ImGui::SameLine();
 	ImGui::PushItemWidth(96);
 
+    const BpmPoint formerBpmPoint = InBpmPoint;
+
+    //only written back when dragged, the round trip through a float would change the point every frame
     float bpmFloat = float(InBpmPoint.Bpm);
-	ImGui::DragFloat(" ", &bpmFloat, 0.1f, 0.01f, 2000.0f);
-	InBpmPoint.Bpm = double(bpmFloat);
-    InBpmPoint.BeatLength = 60000.0 / InBpmPoint.Bpm;
+	if(ImGui::DragFloat(" ", &bpmFloat, 0.1f, 0.01f, 2000.0f))
+    {
+	    InBpmPoint.Bpm = double(bpmFloat);
+        InBpmPoint.BeatLength = 60000.0 / InBpmPoint.Bpm;
+    }
     
     if(InIsPinned)
     {
@@ -286,6 +321,21 @@ void BpmEditMode::DisplayBpmNode(BpmPoint& InBpmPoint, const int InScreenX, cons
     }
 
 	ImGui::End();
+
+    if(formerBpmPoint.TimePoint == InBpmPoint.TimePoint && formerBpmPoint.BeatLength == InBpmPoint.BeatLength)
+        return;
+
+    //edited in place, recorded like a drag of the point so it can be undone and reaches the journal
+    EditCoalesceKey coalesceKey;
+    coalesceKey.Type = EditCoalesceKey::EType::BpmPointDrag;
+    coalesceKey.TimePoint = formerBpmPoint.TimePoint;
+
+    static_Chart->BeginEditHistoryEntry(coalesceKey);
+    static_Chart->RegisterBpmPointModification(formerBpmPoint, InBpmPoint);
+
+    //dragging or nudging the same point on keeps extending one undo
+    coalesceKey.TimePoint = InBpmPoint.TimePoint;
+    static_Chart->SetEditHistoryCoalesceKey(coalesceKey);
 }
 
 Time BpmEditMode::GetCursorTime() 
@@ -23,11 +23,12 @@ private:
 
 	Time GetCursorTime();
 
-	std::vector<BpmPoint*>* _VisibleBpmPoints = nullptr;
+	std::vector<BpmPoint*> _VisibleBpmPoints;
 	BpmPoint* _HoveredBpmPoint = nullptr;
 	BpmPoint* _MovableBpmPoint = nullptr;
 
 	BpmPoint _MovableBpmPointInitialValue;
+	BpmPoint _PreviousBpmPointInitialValue;
 	
 	BpmPoint* _PreviousBpmPoint = nullptr;
 	BpmPoint* _NextBpmPoint = nullptr;
@@ -4,8 +4,8 @@ bool NoteEditMode::OnMouseRightButtonClicked(const bool InIsShiftDown)
 {
     if(static_Cursor.HoveredNotes.size() != 0)
     {
-        const Note& firstNote = *(static_Cursor.HoveredNotes.back());
-        static_Chart->RemoveNote(firstNote.TimePoint, static_Cursor.CursorColumn);
+        if(const Note* hoveredNote = static_Chart->ResolveNote(static_Cursor.HoveredNotes.back()))
+            static_Chart->RemoveNote(hoveredNote->TimePoint, static_Cursor.CursorColumn);
     }
 
     return false;
@@ -0,0 +1,138 @@
+#include "scroll-velocity-edit-mode.h"
+#include "imgui.h"
+
+#include <cmath>
+#include <cstdio>
+
+//how close the cursor has to be to a point to grab it, in ms
+#define SCROLL_VELOCITY_HOVER_DISTANCE 20.0
+
+bool ScrollVelocityEditMode::OnMouseLeftButtonClicked(const bool InIsShiftDown)
+{
+	if (static_Cursor.TimefieldSide != Cursor::FieldPosition::Middle || _IsHoveringScrollVelocity)
+		return false;
+
+	//a new point starts out with the multiplier already in effect, so placing one alone changes nothing about the scrolling
+	const ScrollVelocityMultiplier* previousScrollVelocity = static_Chart->GetScrollVelocityMap().GetPreviousPoint(GetCursorTime());
+
+	return static_Chart->PlaceScrollVelocity(GetCursorTime(), previousScrollVelocity ? previousScrollVelocity->Multiplier : 1.0);
+}
+
+bool ScrollVelocityEditMode::OnMouseRightButtonClicked(const bool InIsShiftDown)
+{
+	if (!_IsHoveringScrollVelocity)
+		return false;
+
+	static_Chart->RemoveScrollVelocity(_HoveredTimePoint);
+
+	_IsHoveringScrollVelocity = false;
+	_VisibleScrollVelocities.clear();
+
+	return false;
+}
+
+void ScrollVelocityEditMode::OnReset()
+{
+	_IsHoveringScrollVelocity = false;
+	_VisibleScrollVelocities.clear();
+}
+
+void ScrollVelocityEditMode::SubmitToRenderGraph(TimefieldRenderGraph& InOutTimefieldRenderGraph, const Time InTimeBegin, const Time InTimeEnd)
+{
+	_VisibleScrollVelocities.clear();
+	static_Chart->GetScrollVelocityMap().IterateInTimeRange(double(InTimeBegin), double(InTimeEnd), [this](const ScrollVelocityMultiplier& InScrollVelocity) { _VisibleScrollVelocities.push_back(InScrollVelocity); });
+
+	for (const ScrollVelocityMultiplier& scrollVelocity : _VisibleScrollVelocities)
+	{
+		const bool isHovered = _IsHoveringScrollVelocity && _HoveredTimePoint == scrollVelocity.TimePoint;
+
+		InOutTimefieldRenderGraph.SubmitTimefieldRenderCommand(0, Time(std::lround(scrollVelocity.TimePoint)),
+		[this, scrollVelocity, isHovered](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
+		{
+			sf::RectangleShape scrollVelocityLine;
+			scrollVelocityLine.setPosition(InTimefieldMetrics.LeftSidePosition, InScreenY - (isHovered ? 8 : 2));
+			scrollVelocityLine.setSize(sf::Vector2f(InTimefieldMetrics.FieldWidth, isHovered ? 8 : 4));
+			scrollVelocityLine.setFillColor(isHovered ? sf::Color(128, 255, 128, 255) : sf::Color(96, 192, 255, 255));
+
+			InRenderTarget->draw(scrollVelocityLine);
+
+			DisplayScrollVelocityNode(scrollVelocity, InTimefieldMetrics.LeftSidePosition + InTimefieldMetrics.FieldWidth + 8, InScreenY);
+		});
+	}
+
+	if (static_Cursor.TimefieldSide != Cursor::FieldPosition::Middle || _IsHoveringScrollVelocity)
+		return;
+
+	InOutTimefieldRenderGraph.SubmitTimefieldRenderCommand(0, GetCursorTime(),
+	[](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
+	{
+		sf::RectangleShape rectangle;
+
+		rectangle.setPosition(InTimefieldMetrics.LeftSidePosition, InScreenY);
+		rectangle.setSize(sf::Vector2f(InTimefieldMetrics.FieldWidth, 4));
+		rectangle.setFillColor(sf::Color(96, 192, 255, 255));
+
+		InRenderTarget->draw(rectangle);
+	});
+}
+
+void ScrollVelocityEditMode::Tick()
+{
+	for (const ScrollVelocityMultiplier& scrollVelocity : _VisibleScrollVelocities)
+	{
+		if (std::abs(double(GetCursorTime()) - scrollVelocity.TimePoint) < SCROLL_VELOCITY_HOVER_DISTANCE && static_Cursor.TimefieldSide == Cursor::FieldPosition::Middle)
+		{
+			_IsHoveringScrollVelocity = true;
+			_HoveredTimePoint = scrollVelocity.TimePoint;
+
+			return;
+		}
+	}
+
+	_IsHoveringScrollVelocity = false;
+}
+
+void ScrollVelocityEditMode::DisplayScrollVelocityNode(const ScrollVelocityMultiplier& InScrollVelocity, const int InScreenX, const int InScreenY)
+{
+	ImGuiWindowFlags windowFlags = 0;
+	windowFlags |= ImGuiWindowFlags_NoTitleBar;
+	windowFlags |= ImGuiWindowFlags_NoMove;
+	windowFlags |= ImGuiWindowFlags_NoResize;
+	windowFlags |= ImGuiWindowFlags_NoCollapse;
+	windowFlags |= ImGuiWindowFlags_AlwaysAutoResize;
+	windowFlags |= ImGuiWindowFlags_NoScrollbar;
+
+	bool open = true;
+
+	//every node is a window of its own, named after the time point of its point
+	char windowName[64];
+	std::snprintf(windowName, sizeof(windowName), "sv%.17g", InScrollVelocity.TimePoint);
+
+	ImGui::SetNextWindowPos({ float(InScreenX), float(InScreenY) });
+	ImGui::Begin(windowName, &open, windowFlags);
+
+	ImGui::Text("SV");
+	ImGui::SameLine();
+	ImGui::PushItemWidth(96);
+
+	float multiplier = float(InScrollVelocity.Multiplier);
+
+	if (ImGui::DragFloat(" ", &multiplier, 0.01f, -10.0f, 10.0f, "%.2fx") && double(multiplier) != InScrollVelocity.Multiplier)
+	{
+		//dragging the same point on keeps extending one undo
+		EditCoalesceKey coalesceKey;
+		coalesceKey.Type = EditCoalesceKey::EType::ScrollVelocityEdit;
+		coalesceKey.TimePoint = Time(std::lround(InScrollVelocity.TimePoint));
+
+		static_Chart->BeginEditHistoryEntry(coalesceKey);
+		static_Chart->PlaceScrollVelocity(InScrollVelocity.TimePoint, double(multiplier), true);
+	}
+
+	ImGui::PopItemWidth();
+	ImGui::End();
+}
+
+Time ScrollVelocityEditMode::GetCursorTime()
+{
+	return static_ShiftKeyState ? static_Cursor.TimePoint : static_Cursor.UnsnappedTimePoint;
+}
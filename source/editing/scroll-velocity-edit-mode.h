@@ -0,0 +1,27 @@
+#pragma once
+
+#include "base/edit-mode.h"
+
+class ScrollVelocityEditMode : public EditMode
+{
+public:
+
+	bool OnMouseLeftButtonClicked(const bool InIsShiftDown) override;
+	bool OnMouseRightButtonClicked(const bool InIsShiftDown) override;
+
+	void OnReset() override;
+	void SubmitToRenderGraph(TimefieldRenderGraph& InOutTimefieldRenderGraph, const Time InTimeBegin, const Time InTimeEnd) override;
+	void Tick() override;
+
+private:
+
+	void DisplayScrollVelocityNode(const ScrollVelocityMultiplier& InScrollVelocity, const int InScreenX, const int InScreenY);
+
+	Time GetCursorTime();
+
+	//copies, the points of the chart move around in memory as soon as one gets placed or removed
+	std::vector<ScrollVelocityMultiplier> _VisibleScrollVelocities;
+
+	bool _IsHoveringScrollVelocity = false;
+	double _HoveredTimePoint = 0.0;
+};
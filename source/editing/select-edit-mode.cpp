@@ -14,8 +14,13 @@ bool SelectEditMode::OnCopy()
 
     for(const auto [column, noteCollection] : _SelectedNotes.Notes)
     {
-        for(auto selectedNote : noteCollection)
+        for(auto selectedNoteHandle : noteCollection)
         {
+            const Note* selectedNote = static_Chart->ResolveNote(selectedNoteHandle);
+
+            if(!selectedNote)
+                continue;
+
             std::string noteSegment = "";
             switch(selectedNote->Type)
             {
@@ -215,24 +220,29 @@ void SelectEditMode::Tick()
     if(!static_Cursor.HoveredNotes.empty() && static_Cursor.TimefieldSide == Cursor::FieldPosition::Middle && !_IsAreaSelecting)
     {
         _HoveredNoteColumn = static_Cursor.CursorColumn;
-        _HoveredNote = static_Chart->FindNote(static_Cursor.HoveredNotes.back()->TimePoint, _HoveredNoteColumn);
+        _HoveredNote = static_Cursor.HoveredNotes.back();
     }
     else
-        _HoveredNote = nullptr;
+        _HoveredNote = NoteHandle();
 }
 
 bool SelectEditMode::OnMouseLeftButtonClicked(const bool InIsShiftDown)
 {
     _AnchoredCursor = static_Cursor;
 
-    if(_HoveredNote != nullptr)
+    if(static_Chart->ResolveNote(_HoveredNote))
     {
         if(_SelectedNotes.NoteAmount > 1)
         {
             Time smallestDis = INT32_MAX;
             for(auto& [column, notes] : _SelectedNotes.Notes)
-                for(auto& note : notes)
+                for(auto& noteHandle : notes)
                 {
+                    const Note* note = static_Chart->ResolveNote(noteHandle);
+
+                    if(!note)
+                        continue;
+
                     Note noteCopy = *note;
                     noteCopy.BeatSnap = -1;
 
@@ -240,7 +250,7 @@ bool SelectEditMode::OnMouseLeftButtonClicked(const bool InIsShiftDown)
                     _MostLeftColumn = std::min(_MostLeftColumn, column);
 
                     _PastePreviewNotes.push_back({column, noteCopy});
-                    _DraggingNotes.PushNote(column, note);
+                    _DraggingNotes.PushNote(column, *note);
 
                     if(abs(static_Cursor.UnsnappedTimePoint - note->TimePoint) < smallestDis)
                     {
@@ -282,12 +292,35 @@ bool SelectEditMode::OnMouseLeftButtonReleased()
         {   
             SetNewPreviewPasteLocation();
             
-            Time minTimePoint = (_HighestPasteTimepoint < _DraggingNotes.MaxTimePoint) ? _HighestPasteTimepoint - (_DraggingNotes.MaxTimePoint - _DraggingNotes.MinTimePoint) : _DraggingNotes.MinTimePoint;
-            Time maxTimePoint = (_HighestPasteTimepoint < _DraggingNotes.MaxTimePoint) ? _DraggingNotes.MaxTimePoint : _HighestPasteTimepoint;
-            
-            static_Chart->RegisterTimeSliceHistoryRanged(minTimePoint - TIMESLICE_LENGTH, maxTimePoint + TIMESLICE_LENGTH);
+            //the earliest, left most corner identifies the selection, dragging it again from where it got dropped continues the same undo
+            EditCoalesceKey coalesceKey;
+            coalesceKey.Type = EditCoalesceKey::EType::SelectionDrag;
+
+            auto resetCoalesceKey = [&coalesceKey]() { coalesceKey.TimePoint = INT32_MAX; coalesceKey.NoteColumn = SIZE_MAX; };
+            auto expandCoalesceKey = [&coalesceKey](const Column InColumn, const Time InTime)
+            {
+                coalesceKey.TimePoint = std::min(coalesceKey.TimePoint, InTime);
+                coalesceKey.NoteColumn = std::min(coalesceKey.NoteColumn, InColumn);
+            };
+
+            resetCoalesceKey();
+            for(auto& [column, notes] : _DraggingNotes.Notes)
+                for(auto& noteHandle : notes)
+                    if(const Note* note = static_Chart->ResolveNote(noteHandle))
+                        expandCoalesceKey(column, note->TimePoint);
+
+            //one transaction, so the snaps and the minimap of the source and the destination get refreshed in one go
+            static_Chart->BeginEditHistoryEntry(coalesceKey);
+            static_Chart->BeginTransaction();
             static_Chart->BulkRemoveNotes(_DraggingNotes, true);
             static_Chart->BulkPlaceNotes(_PastePreviewNotes, true);
+            static_Chart->CommitTransaction();
+
+            resetCoalesceKey();
+            for(auto& [column, note] : _PastePreviewNotes)
+                expandCoalesceKey(column, note.TimePoint);
+
+            static_Chart->SetEditHistoryCoalesceKey(coalesceKey);
 
             PUSH_NOTIFICATION("Moved %d Notes", _PastePreviewNotes.size());
 
@@ -302,27 +335,40 @@ bool SelectEditMode::OnMouseLeftButtonReleased()
             return _IsMovingNote = false;
         }
 
-        if (_DraggingNote->Type == Note::EType::HoldEnd && _DraggingNote->TimePointBegin >= static_Cursor.TimePoint)
+        const Note* draggingNote = static_Chart->ResolveNote(_DraggingNote);
+        const Note* hoveredNote = static_Chart->ResolveNote(_HoveredNote);
+
+        if(!draggingNote || !hoveredNote)
+            return _IsMovingNote = false;
+
+        if (draggingNote->Type == Note::EType::HoldEnd && draggingNote->TimePointBegin >= static_Cursor.TimePoint)
         {
-            // TODO : Make the one-undo implementation
-            Time TimePointBegin = _DraggingNote->TimePointBegin;
-            static_Chart->RemoveNote(_DraggingNote->TimePointBegin, static_Cursor.CursorColumn);
-            static_Chart->PlaceNote(TimePointBegin, static_Cursor.CursorColumn, static_Cursor.BeatSnap);
+            //the hold collapsing into a single note is one undo
+            Time TimePointBegin = draggingNote->TimePointBegin;
+            static_Chart->BeginEditHistoryEntry();
+            static_Chart->BeginTransaction();
+            static_Chart->RemoveNote(draggingNote->TimePointBegin, static_Cursor.CursorColumn, false, true);
+            static_Chart->PlaceNote(TimePointBegin, static_Cursor.CursorColumn, static_Cursor.BeatSnap, true);
+            static_Chart->CommitTransaction();
 
             return _IsMovingNote = false;
         }
 
-        if (_DraggingNote->Type == Note::EType::HoldBegin && _DraggingNote->TimePointEnd <= static_Cursor.TimePoint)
+        if (draggingNote->Type == Note::EType::HoldBegin && draggingNote->TimePointEnd <= static_Cursor.TimePoint)
         {
-            // TODO : Make the one-undo implementation
-            Time TimePointEnd = _DraggingNote->TimePointEnd;
-            static_Chart->RemoveNote(_DraggingNote->TimePointEnd, static_Cursor.CursorColumn);
-            static_Chart->PlaceNote(TimePointEnd, static_Cursor.CursorColumn, static_Cursor.BeatSnap);
+            Time TimePointEnd = draggingNote->TimePointEnd;
+            static_Chart->BeginEditHistoryEntry();
+            static_Chart->BeginTransaction();
+            static_Chart->RemoveNote(draggingNote->TimePointEnd, static_Cursor.CursorColumn, false, true);
+            static_Chart->PlaceNote(TimePointEnd, static_Cursor.CursorColumn, static_Cursor.BeatSnap, true);
+            static_Chart->CommitTransaction();
 
             return _IsMovingNote = false;
         }
 
-        _HoveredNote = static_Chart->MoveNote(_HoveredNote->TimePoint, static_Cursor.TimePoint, _HoveredNoteColumn, static_Cursor.CursorColumn, static_Cursor.BeatSnap);
+        if(const Note* movedNote = static_Chart->MoveNote(hoveredNote->TimePoint, static_Cursor.TimePoint, _HoveredNoteColumn, static_Cursor.CursorColumn, static_Cursor.BeatSnap))
+            _HoveredNote = movedNote->Handle;
+
         _HoveredNoteColumn = static_Cursor.CursorColumn;
 
         return _IsMovingNote = false;
@@ -342,10 +388,17 @@ bool SelectEditMode::OnMouseLeftButtonReleased()
     const Column columnMin = std::min(_AnchoredCursor.CursorColumn, static_Cursor.CursorColumn);
     const Column columnMax = std::max(_AnchoredCursor.CursorColumn, static_Cursor.CursorColumn);
 
-    static_Chart->IterateNotesInTimeRange(timeBegin, timeEnd, [this, &timeBegin, &timeEnd, &columnMin, &columnMax](Note& InOutNote, const Column& InColumn)
+    static_Chart->IterateNotesInTimeRange(timeBegin, timeEnd, [this, &timeBegin, &timeEnd, &columnMin, &columnMax](const Note& InNote, const Column& InColumn)
+    {
+        if((InNote.Type == Note::EType::Common || InNote.Type == Note::EType::HoldBegin) && (InColumn >= columnMin && InColumn <= columnMax))
+            _SelectedNotes.PushNote(InColumn, InNote);
+    });
+
+    //holds that begin before the box but run through it, the ones beginning inside of it were picked up above
+    static_Chart->IterateHoldsInTimeRange(timeBegin, timeEnd, [this, &timeBegin, &columnMin, &columnMax](const Note& InNote, const Column InColumn)
     {
-        if((InOutNote.Type == Note::EType::Common || InOutNote.Type == Note::EType::HoldBegin) && (InColumn >= columnMin && InColumn <= columnMax))
-            _SelectedNotes.PushNote(InColumn, &InOutNote);
+        if(InNote.TimePoint < timeBegin && InColumn >= columnMin && InColumn <= columnMax)
+            _SelectedNotes.PushNote(InColumn, InNote);
     });
 
     if(_SelectedNotes.NoteAmount != 0)
@@ -379,9 +432,14 @@ void SelectEditMode::SubmitToRenderGraph(TimefieldRenderGraph& InOutTimefieldRen
 
     for(const auto& [column, noteCollection] : _SelectedNotes.Notes)
     {
-        for(auto& selectedNote : noteCollection)
+        for(auto& selectedNoteHandle : noteCollection)
         {
-            if(selectedNote->TimePoint < InTimeBegin - TIMESLICE_LENGTH || selectedNote->TimePoint > InTimeEnd + TIMESLICE_LENGTH)
+            const Note* selectedNote = static_Chart->ResolveNote(selectedNoteHandle);
+
+            if(!selectedNote)
+                continue;
+
+            if(selectedNote->TimePoint < InTimeBegin - static_Chart->GetTimeSliceLength() || selectedNote->TimePoint > InTimeEnd + static_Chart->GetTimeSliceLength())
                 continue;
 
             InOutTimefieldRenderGraph.SubmitTimefieldRenderCommand(column, selectedNote->TimePoint,
@@ -432,24 +490,27 @@ void SelectEditMode::SubmitToRenderGraph(TimefieldRenderGraph& InOutTimefieldRen
          }
     }
 
-    if(_HoveredNote || _IsMovingNote)
+    const Note* hoveredNote = static_Chart->ResolveNote(_HoveredNote);
+    const Note* draggingNote = static_Chart->ResolveNote(_DraggingNote);
+
+    if(hoveredNote && (!_IsMovingNote || draggingNote))
     {
         Column column = _HoveredNoteColumn;
-        Time timePoint = _HoveredNote->TimePoint;
+        Time timePoint = hoveredNote->TimePoint;
 
         if(_IsMovingNote)
         {
             column = static_Cursor.CursorColumn;
             timePoint = static_Cursor.TimePoint;
 
-            switch (_DraggingNote->Type)
+            switch (draggingNote->Type)
             {
             case Note::EType::HoldBegin:
-                InOutTimefieldRenderGraph.SubmitHoldNoteRenderCommand(column, timePoint, _DraggingNote->TimePointEnd, -1, -1, 128);
+                InOutTimefieldRenderGraph.SubmitHoldNoteRenderCommand(column, timePoint, draggingNote->TimePointEnd, -1, -1, 128);
                 break;
 
             case Note::EType::HoldEnd:
-                InOutTimefieldRenderGraph.SubmitHoldNoteRenderCommand(column, _DraggingNote->TimePointBegin, timePoint, -1, -1, 128);
+                InOutTimefieldRenderGraph.SubmitHoldNoteRenderCommand(column, draggingNote->TimePointBegin, timePoint, -1, -1, 128);
                 break;
             
             default:
@@ -47,7 +47,7 @@ private:
 	Column _MostRightColumn = 0;
 	Column _MostLeftColumn = 0;
 
-	Note* _DraggingNote = nullptr;
-	Note* _HoveredNote = nullptr;
+	NoteHandle _DraggingNote;
+	NoteHandle _HoveredNote;
 	Column _HoveredNoteColumn = 0;
 };
\ No newline at end of file
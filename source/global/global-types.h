@@ -9,4 +9,5 @@
 #include "../structures/window-metrics.h"
 #include "../structures/timefield-metrics.h"
 #include "../structures/waveform-data.h"
+#include "../structures/spectrogram-data.h"
 #include "../structures/notification-message.h"
\ No newline at end of file
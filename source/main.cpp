@@ -1,7 +1,16 @@
 #include "program/program.h"
+#include "program/batch-program.h"
 
-int main()
+int main(int InArgumentCount, char** InArguments)
 {
+    //with arguments there is no window, the charts get processed on the command line instead
+    if (InArgumentCount > 1)
+    {
+        BatchProgram batchProgram;
+
+        return batchProgram.ParseArguments(InArgumentCount, InArguments) ? batchProgram.Run() : 2;
+    }
+
     Program program;
 
     program.Init();
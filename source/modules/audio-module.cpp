@@ -1,6 +1,26 @@
 #include "audio-module.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "../structures/mapset-archive.h"
+#include "../structures/mapped-file.h"
+#include "../structures/binary-io.h"
+
+//samples decoded at once for the waveform and the spectrogram, the pcm of a chunk is gone as soon as its peaks are reduced out of it
+#define WAVEFORM_CHUNK_SAMPLE_AMOUNT 65536
+
+#define WAVEFORM_CACHE_FOLDER_PATH "data/cache/waveforms"
+
+//one cache file per song content, the same song in another mapset or under another name shares it
+static std::filesystem::path GetWaveFormCachePath(const uint64_t InSourceHash)
+{
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "%016llx.lrw", (unsigned long long)InSourceHash);
+
+	return std::filesystem::path(WAVEFORM_CACHE_FOLDER_PATH) / fileName;
+}
 
 bool AudioModule::Tick(const float& InDeltaTime)
 {
@@ -10,12 +30,31 @@ bool AudioModule::Tick(const float& InDeltaTime)
 	return true;
 }
 
+bool AudioModule::ShutDown()
+{
+	StopWaveFormThread();
+	StopSpectrogramThread();
+
+	return true;
+}
+
 void AudioModule::LoadAudio(const std::filesystem::path& InPath)
 {
+	//the waveform and spectrogram decoders read from the song that is about to go away
+	StopWaveFormThread();
+	StopSpectrogramThread();
+
+	_SpectrogramData.Clear();
+	_SpectrogramPath.clear();
+
 	BASS_Free();
 	BASS_Init(_Device, _Freq, 0, 0, NULL);
 
-	_StreamHandle = BASS_FX_TempoCreate(BASS_StreamCreateFile(FALSE, InPath.string().c_str(), 0, 0, BASS_STREAM_DECODE | BASS_STREAM_PRESCAN), BASS_FX_FREESOURCE);
+	//every stream reading the previous song is gone now
+	_ArchivedSong.clear();
+	_ArchivedSongPath.clear();
+
+	_StreamHandle = BASS_FX_TempoCreate(CreateFileStream(InPath, BASS_STREAM_DECODE | BASS_STREAM_PRESCAN), BASS_FX_FREESOURCE);
 
 	auto error = BASS_ErrorGetCode();
 	if (error != 0)
@@ -131,45 +170,165 @@ float AudioModule::GetPlaybackSpeed()
 
 WaveFormData* AudioModule::GenerateAndGetWaveformData(const std::filesystem::path& InPath) 
 {
-	HSTREAM decoder = BASS_StreamCreateFile(FALSE, InPath.string().c_str(), 0, 0, BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE);
+	StopWaveFormThread();
+
+	_WaveFormData.Clear();
 
-	if (_WaveFormData != nullptr)
+	uint64_t sourceHash = 0;
+	uint64_t sourceSize = 0;
+
+	//the song that is loaded out of an archive is already in memory, a song on disk only gets mapped for hashing
 	{
-		delete[] _WaveFormData;
-		_WaveFormData = nullptr;
+		MappedFile songFile;
+		std::string_view songContent;
+
+		if (_ArchivedSongPath == InPath)
+			songContent = _ArchivedSong;
+		else if (songFile.Open(InPath))
+			songContent = songFile.GetView();
+
+		sourceHash = HashContent(songContent);
+		sourceSize = songContent.size();
 	}
 
-	if (_ReadableWaveFormData != nullptr)
+	//a changed song hashes differently and so never finds the cache of its previous version
+	if (sourceSize > 0 && _WaveFormData.LoadCache(GetWaveFormCachePath(sourceHash), sourceHash, sourceSize))
+		return &_WaveFormData;
+
+	//prescanning makes the length exact, every level of the waveform gets sized by it before the first chunk is decoded
+	HSTREAM decoder = CreateFileStream(InPath, BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE | BASS_STREAM_PRESCAN);
+
+	BASS_CHANNELINFO info;
+	if (!decoder || !BASS_ChannelGetInfo(decoder, &info) || info.chans == 0)
 	{
-		delete[] _ReadableWaveFormData;
-		_ReadableWaveFormData = nullptr;
+		BASS_StreamFree(decoder);
+		return &_WaveFormData;
 	}
 
-	_SongByteLength = BASS_ChannelGetLength(decoder, BASS_POS_BYTE);
-	_WaveFormData = (float*)std::malloc(_SongByteLength); 
-	_SongByteLength = BASS_ChannelGetData(decoder, _WaveFormData, _SongByteLength);
+	_WaveFormData.Reset(BASS_ChannelGetLength(decoder, BASS_POS_BYTE) / sizeof(float) / info.chans, int(info.chans), double(info.freq));
+
+	_ShouldStopWaveForm = false;
+	_WaveFormThread = std::thread(&AudioModule::RunWaveFormThread, this, decoder, sourceHash, sourceSize);
+
+	return &_WaveFormData;
+}
+
+void AudioModule::RunWaveFormThread(const HSTREAM InDecoder, const uint64_t InSourceHash, const uint64_t InSourceSize)
+{
+	BASS_CHANNELINFO info;
+	BASS_ChannelGetInfo(InDecoder, &info);
 
-	_ReadableWaveFormData = new WaveFormData[GetSongLengthMilliSeconds()]();
+	//whole frames only, a chunk never ends in between the channels of a frame
+	std::vector<float> samples(WAVEFORM_CHUNK_SAMPLE_AMOUNT / info.chans * info.chans);
 
-	for(Time time = 0; time < GetSongLengthMilliSeconds(); ++time)
+	while (!_ShouldStopWaveForm)
 	{
-		double timeSeconds = double(time) / 1000.0;
-		QWORD index = BASS_ChannelSeconds2Bytes(_StreamHandle, std::max(0.0, timeSeconds)) / 2;
+		const DWORD byteLength = BASS_ChannelGetData(InDecoder, samples.data(), DWORD(samples.size() * sizeof(float)));
 
-		if(index < _SongByteLength / sizeof(int))
-		{
-			float right = _WaveFormData[index + 1];
-			float left = _WaveFormData[index];
+		if (byteLength == DWORD(-1) || byteLength == 0)
+			break;
 
-			_ReadableWaveFormData[time].Right = right;
-			_ReadableWaveFormData[time].Left = left;
-		}
+		_WaveFormData.AppendFrames(samples.data(), byteLength / sizeof(float) / info.chans);
 	}
 
-	return _ReadableWaveFormData;
+	_WaveFormData.Finish();
+
+	BASS_StreamFree(InDecoder);
+
+	//a waveform that got cut off by loading another song is not worth keeping
+	if (_ShouldStopWaveForm || InSourceSize == 0)
+		return;
+
+	std::error_code errorCode;
+	std::filesystem::create_directories(WAVEFORM_CACHE_FOLDER_PATH, errorCode);
+
+	//the cache is only a shortcut, failing to write it simply means the song gets decoded again next time
+	_WaveFormData.StoreCache(GetWaveFormCachePath(InSourceHash), InSourceHash, InSourceSize);
+}
+
+void AudioModule::StopWaveFormThread()
+{
+	_ShouldStopWaveForm = true;
+
+	if (_WaveFormThread.joinable())
+		_WaveFormThread.join();
 }
 
-const WaveFormData& AudioModule::SampleWaveFormData(const Time InTimePoint) 
+SpectrogramData* AudioModule::GenerateAndGetSpectrogramData(const std::filesystem::path& InPath, const int InWindowSize, const int InHopSize)
 {
-	return _ReadableWaveFormData[std::max(0, std::min(GetSongLengthMilliSeconds(), InTimePoint))];
+	if (_SpectrogramPath == InPath && _SpectrogramData.GetColumnAmount() > 0 && _SpectrogramData.GetWindowSize() == InWindowSize && _SpectrogramData.GetHopSize() == InHopSize)
+		return &_SpectrogramData;
+
+	StopSpectrogramThread();
+
+	_SpectrogramData.Clear();
+	_SpectrogramPath = InPath;
+
+	HSTREAM decoder = CreateFileStream(InPath, BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE | BASS_STREAM_PRESCAN);
+
+	BASS_CHANNELINFO info;
+	if (!decoder || !BASS_ChannelGetInfo(decoder, &info) || info.chans == 0)
+	{
+		BASS_StreamFree(decoder);
+		return &_SpectrogramData;
+	}
+
+	_SpectrogramData.Reset(BASS_ChannelGetLength(decoder, BASS_POS_BYTE) / sizeof(float) / info.chans, int(info.chans), double(info.freq), InWindowSize, InHopSize);
+
+	_ShouldStopSpectrogram = false;
+	_SpectrogramThread = std::thread(&AudioModule::RunSpectrogramThread, this, decoder);
+
+	return &_SpectrogramData;
+}
+
+void AudioModule::RunSpectrogramThread(const HSTREAM InDecoder)
+{
+	BASS_CHANNELINFO info;
+	BASS_ChannelGetInfo(InDecoder, &info);
+
+	std::vector<float> samples(WAVEFORM_CHUNK_SAMPLE_AMOUNT / info.chans * info.chans);
+
+	while (!_ShouldStopSpectrogram)
+	{
+		const DWORD byteLength = BASS_ChannelGetData(InDecoder, samples.data(), DWORD(samples.size() * sizeof(float)));
+
+		if (byteLength == DWORD(-1) || byteLength == 0)
+			break;
+
+		_SpectrogramData.AppendFrames(samples.data(), byteLength / sizeof(float) / info.chans);
+	}
+
+	//padding out the rest of a song that got cut off would only hold up whoever is waiting on the thread
+	if (!_ShouldStopSpectrogram)
+		_SpectrogramData.Finish();
+
+	BASS_StreamFree(InDecoder);
+}
+
+void AudioModule::StopSpectrogramThread()
+{
+	_ShouldStopSpectrogram = true;
+
+	if (_SpectrogramThread.joinable())
+		_SpectrogramThread.join();
+}
+
+HSTREAM AudioModule::CreateFileStream(const std::filesystem::path& InPath, const DWORD InFlags)
+{
+	std::filesystem::path archivePath;
+	std::string entryName;
+
+	if (!SplitArchivePath(InPath, archivePath, entryName))
+		return BASS_StreamCreateFile(FALSE, InPath.string().c_str(), 0, 0, InFlags);
+
+	//only the song that is loaded can be streamed out of memory, replacing it would pull it away from under its stream
+	if (_ArchivedSongPath != InPath)
+	{
+		if (!_ArchivedSongPath.empty() || !ReadFileOrArchiveEntry(InPath, _ArchivedSong))
+			return 0;
+
+		_ArchivedSongPath = InPath;
+	}
+
+	return BASS_StreamCreateFile(TRUE, _ArchivedSong.data(), 0, _ArchivedSong.size(), InFlags);
 }
\ No newline at end of file
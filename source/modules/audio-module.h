@@ -5,12 +5,16 @@
 #include <bass.h>
 #include <bass_fx.h>
 
+#include <atomic>
 #include <filesystem>
+#include <string>
+#include <thread>
 class AudioModule : public Module
 {
 public:
 	
 	virtual bool Tick(const float& InDeltaTime) override;
+	virtual bool ShutDown() override;
 
 public:
 
@@ -31,20 +35,39 @@ public:
 	
 	[[nodiscard]] WaveFormData* GenerateAndGetWaveformData(const std::filesystem::path& InPath);
 
+	//keeps what is already computed for the same song and resolution
+	[[nodiscard]] SpectrogramData* GenerateAndGetSpectrogramData(const std::filesystem::path& InPath, const int InWindowSize, const int InHopSize);
+
 	bool UsePitch = true;
 
 private:
 
-	const WaveFormData& SampleWaveFormData(const Time InTimePoint);
+	HSTREAM CreateFileStream(const std::filesystem::path& InPath, const DWORD InFlags);
+
+	void RunWaveFormThread(const HSTREAM InDecoder, const uint64_t InSourceHash, const uint64_t InSourceSize);
+	void StopWaveFormThread();
+
+	void RunSpectrogramThread(const HSTREAM InDecoder);
+	void StopSpectrogramThread();
+
+	//filled in chunk by chunk on its own thread, so the chart can be edited while the song still decodes
+	WaveFormData _WaveFormData;
+	std::thread _WaveFormThread;
+	std::atomic<bool> _ShouldStopWaveForm = false;
 
-	WaveFormData* _ReadableWaveFormData = nullptr;
+	//decodes the song a second time, only once the spectrogram is shown
+	SpectrogramData _SpectrogramData;
+	std::filesystem::path _SpectrogramPath;
+	std::thread _SpectrogramThread;
+	std::atomic<bool> _ShouldStopSpectrogram = false;
 
 	double _CurrentTime = 0;
 	float _Speed = 1.f;
 	bool _Paused = true;
 
-	float* _WaveFormData = nullptr;
-	DWORD _SongByteLength;
+	//a song inside an archive is kept in memory for as long as bass streams from it
+	std::string _ArchivedSong;
+	std::filesystem::path _ArchivedSongPath;
 
 	//relevant BASS variables
 	int _Device = -1; // Default Sounddevice
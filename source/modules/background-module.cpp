@@ -1,5 +1,7 @@
 #include "background-module.h"
 
+#include "../structures/mapset-archive.h"
+
 bool BackgroundModule::RenderBack(sf::RenderTarget* const InOutRenderTarget) 
 {
 	float procentualChange = float(InOutRenderTarget->getView().getSize().y) / float(_BackgroundTexture.getSize().y);
@@ -19,6 +21,14 @@ void BackgroundModule::LoadBackground(const std::filesystem::path& InPath)
 	_BackgroundTexture = sf::Texture();
 	_BackgroundSprite = sf::Sprite();
 
-    _BackgroundTexture.loadFromFile(InPath.string());
+	std::filesystem::path archivePath;
+	std::string entryName;
+	std::string archivedBackground;
+
+	//a background inside an archive gets decoded straight out of memory
+	if (!SplitArchivePath(InPath, archivePath, entryName))
+		_BackgroundTexture.loadFromFile(InPath.string());
+	else if (ReadFileOrArchiveEntry(InPath, archivedBackground))
+		_BackgroundTexture.loadFromMemory(archivedBackground.data(), archivedBackground.size());
 	_BackgroundSprite.setTexture(_BackgroundTexture);
 }
\ No newline at end of file
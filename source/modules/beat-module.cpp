@@ -28,37 +28,30 @@ void BeatModule::AssignNotesToSnapsInChart(Chart* const InChart)
 	if(!InChart)
 		return;
 
-	if(InChart->TimeSlices.empty())
-		return;
-
 	Time timeBegin = 0;
-	Time timeEnd = InChart->TimeSlices.rbegin()->second.TimePoint + TIMESLICE_LENGTH;
-
-	for (Time time = timeBegin; time <= timeEnd; time += TIMESLICE_LENGTH)
-	{
-		auto& slice = InChart->FindOrAddTimeSlice(time);
+	Time timeEnd = InChart->GetLastNoteTimePoint() + InChart->GetTimeSliceLength() - 1;
 
-		AssignNotesToSnapsInTimeSlice(InChart, slice);
-	}
+	AssignNotesToSnapsInTimeRange(InChart, timeBegin, timeEnd);
 }
 
-void BeatModule::AssignNotesToSnapsInTimeSlice(Chart* const InChart, TimeSlice& InOutTimeSlice) 
+void BeatModule::AssignNotesToSnapsInTimeRange(Chart* const InChart, const Time InTimeBegin, const Time InTimeEnd) 
 {
-	GenerateTimeRangeBeatLines(InOutTimeSlice.TimePoint, InOutTimeSlice.TimePoint + TIMESLICE_LENGTH, InChart, 48);
-	GenerateTimeRangeBeatLines(InOutTimeSlice.TimePoint, InOutTimeSlice.TimePoint + TIMESLICE_LENGTH, InChart, 5, true);
-	GenerateTimeRangeBeatLines(InOutTimeSlice.TimePoint, InOutTimeSlice.TimePoint + TIMESLICE_LENGTH, InChart, 7, true);
-	GenerateTimeRangeBeatLines(InOutTimeSlice.TimePoint, InOutTimeSlice.TimePoint + TIMESLICE_LENGTH, InChart, 9, true);
+	//the beat lines of the whole range are generated and sorted once, the notes then look theirs up by binary search
+	GenerateTimeRangeBeatLines(InTimeBegin, InTimeEnd + 1, InChart, 48);
+	GenerateTimeRangeBeatLines(InTimeBegin, InTimeEnd + 1, InChart, 5, true);
+	GenerateTimeRangeBeatLines(InTimeBegin, InTimeEnd + 1, InChart, 7, true);
+	GenerateTimeRangeBeatLines(InTimeBegin, InTimeEnd + 1, InChart, 9, true);
+
+	if (_OnFieldBeatLines.empty())
+		return;
 
 	std::sort(_OnFieldBeatLines.begin(), _OnFieldBeatLines.end(), [](const auto& lhs, const auto& rhs) { return lhs.TimePoint < rhs.TimePoint; });
 
-	for (auto& column : InOutTimeSlice.Notes)
+	InChart->IterateNotesInTimeRange(InTimeBegin, InTimeEnd, [this](Note& InOutNote, const Column InColumn)
 	{
-		for (auto& note : column.second)
-		{
-			auto attachedBeatLine = GetClosestBeatLineToTimePoint(note.TimePoint);
-			note.BeatSnap = GetBeatSnap(attachedBeatLine, attachedBeatLine.BeatDivision);
-		}
-	}
+		auto attachedBeatLine = GetClosestBeatLineToTimePoint(InOutNote.TimePoint);
+		InOutNote.BeatSnap = GetBeatSnap(attachedBeatLine, attachedBeatLine.BeatDivision);
+	});
 
 	_OnFieldBeatLines.clear();
 }
@@ -69,7 +62,8 @@ void BeatModule::GenerateTimeRangeBeatLines(const Time InTimeBegin, const Time I
 	if(!InSkipClearCollection)
 		_OnFieldBeatLines.clear();
 
-	const auto& bpmPoints = InChart->GetBpmPointsRelatedToTimeRange(InTimeBegin, InTimeEnd);
+	InChart->GetBpmPointsRelatedToTimeRange(InTimeBegin, InTimeEnd, _RelatedBpmPoints);
+	const auto& bpmPoints = _RelatedBpmPoints;
 
 	size_t index = 0;
 	for (const auto& bpmPointPtr : bpmPoints)
@@ -120,7 +114,7 @@ void BeatModule::GenerateBeatLinesFromTimePointIfInvalid(Chart* const InChart, c
 
 	if(InTime < timeBegin)
 	{
-		Time deltaTime = abs(timeBegin - InTime) + TIMESLICE_LENGTH;
+		Time deltaTime = abs(timeBegin - InTime) + InChart->GetTimeSliceLength();
 
 		GenerateTimeRangeBeatLines(timeBegin - deltaTime, timeBegin, InChart, 48, true);
 		GenerateTimeRangeBeatLines(timeBegin - deltaTime, timeBegin, InChart, 5, true);
@@ -128,7 +122,7 @@ void BeatModule::GenerateBeatLinesFromTimePointIfInvalid(Chart* const InChart, c
 
 	if(InTime > timeEnd)
 	{
-		Time deltaTime = abs(timeEnd - InTime) + TIMESLICE_LENGTH;
+		Time deltaTime = abs(timeEnd - InTime) + InChart->GetTimeSliceLength();
 
 		GenerateTimeRangeBeatLines(timeEnd, timeEnd + deltaTime, InChart, 48, true);
 		GenerateTimeRangeBeatLines(timeEnd, timeEnd + deltaTime, InChart, 5, true);
@@ -249,15 +243,11 @@ bool BeatModule::IsBeatThisDivision(const int InBeatCount, const int InBeatDivis
 
 BeatLine BeatModule::GetClosestBeatLineToTimePoint(const Time InTimePoint) 
 {
-	BeatLine attachedBeatLine = _OnFieldBeatLines.back();
+	//the earliest line that is at most 2ms before the time point, the lines are sorted by then
+	auto beatLine = std::lower_bound(_OnFieldBeatLines.begin(), _OnFieldBeatLines.end(), InTimePoint, [](const BeatLine& InBeatLine, const Time InTime) { return InBeatLine.TimePoint + 2 < InTime; });
 
-	for (auto beatLine = _OnFieldBeatLines.rbegin(); beatLine != _OnFieldBeatLines.rend(); ++beatLine)
-	{
-		if (beatLine->TimePoint + 2 < InTimePoint)
-				break;
-
-		attachedBeatLine = *beatLine;
-	}
+	if (beatLine == _OnFieldBeatLines.end())
+		return _OnFieldBeatLines.back();
 
-	return attachedBeatLine;
+	return *beatLine;
 }
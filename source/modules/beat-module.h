@@ -27,7 +27,7 @@ public:
 public:
 
 	void AssignNotesToSnapsInChart(Chart* const InChart);
-	void AssignNotesToSnapsInTimeSlice(Chart* const InChart, TimeSlice& InOutTimeSlice);
+	void AssignNotesToSnapsInTimeRange(Chart* const InChart, const Time InTimeBegin, const Time InTimeEnd);
 	void GenerateTimeRangeBeatLines(const Time InTimeBegin, const Time InTimeEnd, Chart* const InChart, const int InBeatDivision, const bool InSkipClearCollection = false);
 	void IterateThroughBeatlines(std::function<void(const BeatLine&)> InWork);
 	
@@ -48,6 +48,7 @@ private:
 	void GenerateBeatLinesFromTimePointIfInvalid(Chart* const InChart, const Time InTime);
 
 	std::vector<BeatLine> _OnFieldBeatLines;
+	std::vector<BpmPoint*> _RelatedBpmPoints;
 	
 	std::set<int> _LegalSnaps;
 };
\ No newline at end of file
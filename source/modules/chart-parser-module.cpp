@@ -1,12 +1,111 @@
 #include "chart-parser-module.h"
 
-#include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <istream>
+#include <limits>
+#include <numeric>
 
 #include <math.h>
 
-#define PARSE_COMMA_VALUE(stringstream, target) stringstream >> target; if (stringstream.peek() == ',') stringstream.ignore()
-#define REMOVE_POTENTIAL_NEWLINE(str) if(str.find('\r') != std::string::npos) str.resize(str.size() - 1)
+#include "../structures/mapped-file.h"
+#include "../structures/atomic-file.h"
+#include "../structures/binary-io.h"
+#include "../structures/mapset-archive.h"
+
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/parser.h"
+
+#define CHART_CACHE_FOLDER_PATH "data/cache/charts"
+#define CHART_CACHE_MAGIC "LRC1"
+#define CHART_CACHE_VERSION 3
+#define CHART_CACHE_ALIGNMENT 16
+
+//stepmania places notes on 192nd measures at the finest
+#define STEPMANIA_ROWS_PER_BEAT 48
+#define STEPMANIA_ROWS_PER_MEASURE (4 * STEPMANIA_ROWS_PER_BEAT)
+//gaps between bpm points shorter than this are rounding, not a stop
+#define STEPMANIA_STOP_TOLERANCE 1.0
+
+//osu has no standing or reversed scroll velocity, anything below this becomes this almost standing one instead
+#define OSU_MIN_MULTIPLIER 0.01
+
+//one cache file per chart file, named after its absolute path
+static std::filesystem::path GetChartCachePath(const std::filesystem::path& InPath)
+{
+	std::error_code errorCode;
+	const std::string absolutePath = std::filesystem::absolute(InPath, errorCode).u8string();
+
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "%016llx.lrc", (unsigned long long)HashContent(absolutePath));
+
+	return std::filesystem::path(CHART_CACHE_FOLDER_PATH) / fileName;
+}
+
+static bool IsStepmaniaFile(const std::filesystem::path& InPath)
+{
+	return InPath.extension() == ".sm" || InPath.extension() == ".ssc";
+}
+
+//a stepmania file holds all difficulties of a song, "song.sm/2" is the third chart in song.sm
+static bool SplitStepmaniaPath(const std::filesystem::path& InPath, std::filesystem::path& OutFilePath, size_t& OutChartIndex)
+{
+	const std::filesystem::path filePath = InPath.parent_path();
+	const std::string chartIndex = InPath.filename().string();
+
+	if (!IsStepmaniaFile(filePath) || chartIndex.empty())
+		return false;
+
+	const auto result = std::from_chars(chartIndex.data(), chartIndex.data() + chartIndex.size(), OutChartIndex);
+
+	if (result.ec != std::errc() || result.ptr != chartIndex.data() + chartIndex.size())
+		return false;
+
+	OutFilePath = filePath;
+
+	return true;
+}
+
+//the note and bpm point arrays start aligned, so they can be read straight out of the mapped file
+static void AlignBuffer(std::string& OutBuffer)
+{
+	OutBuffer.resize((OutBuffer.size() + CHART_CACHE_ALIGNMENT - 1) / CHART_CACHE_ALIGNMENT * CHART_CACHE_ALIGNMENT, '\0');
+}
+
+static bool AlignView(std::string_view& InOutView, const char* InBase)
+{
+	const size_t offset = size_t(InOutView.data() - InBase);
+	const size_t padding = (CHART_CACHE_ALIGNMENT - offset % CHART_CACHE_ALIGNMENT) % CHART_CACHE_ALIGNMENT;
+
+	if (InOutView.size() < padding)
+		return false;
+
+	InOutView.remove_prefix(padding);
+
+	return true;
+}
+
+/*
+* layout: the header, the source path and the metadata, then the bpm points, the scroll velocities and every column as raw arrays.
+* the cache is only valid for the exact file it has been made from, which the header identifies by size, write time and content hash.
+*/
+struct ChartCacheHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint32_t NoteSize;
+	uint32_t BpmPointSize;
+	uint32_t ScrollVelocitySize;
+
+	uint64_t SourceSize;
+	int64_t SourceWriteTime;
+	uint64_t SourceHash;
+};
 
 void ChartParserModule::SetCurrentChartPath(const std::filesystem::path& InPath)
 {
@@ -18,6 +117,13 @@ ChartMetadata ChartParserModule::GetChartMetadata(Chart* InChart)
 	std::filesystem::path chartFolderPath = _CurrentChartPath;
 	chartFolderPath.remove_filename();
 
+	std::filesystem::path stepmaniaPath;
+	size_t chartIndex = 0;
+
+	//the folder of a stepmania chart is the one its file is in
+	if (SplitStepmaniaPath(_CurrentChartPath, stepmaniaPath, chartIndex))
+		chartFolderPath = stepmaniaPath.parent_path();
+
 	ChartMetadata outMetadata;
 
 	outMetadata.Artist = InChart->Artist;
@@ -43,7 +149,7 @@ std::string ChartParserModule::CreateNewChart(const ChartMetadata& InNewChartDat
 	return SetChartMetadata(&dummyChart, InNewChartData);
 }
 
-std::string ChartParserModule::SetChartMetadata(Chart* OutChart, const ChartMetadata& InChartMetadata)
+std::string ChartParserModule::SetChartMetadata(Chart* OutChart, const ChartMetadata& InChartMetadata, bool* OutHasSaved)
 {
 	std::filesystem::path audioPath = InChartMetadata.AudioPath;
 	std::filesystem::path backgroundPath = InChartMetadata.BackgroundPath;
@@ -84,411 +190,2200 @@ std::string ChartParserModule::SetChartMetadata(Chart* OutChart, const ChartMeta
 	if (!OutChart->KeyAmount) 
 		OutChart->KeyAmount = InChartMetadata.KeyAmount;
 
-	ExportChartSet(OutChart);
+	const bool hasSaved = ExportChartSet(OutChart);
+
+	if (OutHasSaved)
+		*OutHasSaved = hasSaved;
 
 	return chartFilePath.string();
 }
 
 Chart* ChartParserModule::ParseAndGenerateChartSet(const std::filesystem::path& InPath)
 {
-	std::ifstream chartFile(InPath);
-	if (!chartFile.is_open()) return nullptr;
-	
-	_CurrentChartPath = InPath;
+	ChartSetEntry entry;
+	entry.Path = InPath;
 
-	PUSH_NOTIFICATION("Opened %s", InPath.c_str());
+	if (!LoadChartSetEntry(entry))
+		return nullptr;
 
-	Chart* chart = nullptr;
+	SetCurrentChart(entry);
 
-	if(InPath.extension() == ".osu")
-		chart = ParseChartOsuImpl(chartFile, InPath);
-	else if(InPath.extension() == ".sm")
-		chart = ParseChartStepmaniaImpl(chartFile, InPath);
+	PUSH_NOTIFICATION("Opened %s", InPath.c_str());
 
-	return chart;
+	return entry.LoadedChart;
 }
 
-Chart* ChartParserModule::ParseChartOsuImpl(std::ifstream& InIfstream, std::filesystem::path InPath)
+std::vector<ChartSetEntry> ChartParserModule::ParseAndGenerateChartSetFolder(const std::filesystem::path& InPath)
 {
-	Chart* chart = new Chart();
+	std::vector<ChartSetEntry> entries;
+
+	std::filesystem::path setPath = InPath.parent_path();
+	std::string entryName;
+	size_t chartIndex = 0;
+
+	//a stepmania file already holds all of its difficulties, they all come out of a single parse of it
+	if (IsStepmaniaFile(InPath) || SplitStepmaniaPath(InPath, setPath, chartIndex))
+	{
+		if (IsStepmaniaFile(InPath))
+			setPath = InPath;
 
-	std::string line;
+		LoadStepmaniaChartSet(setPath, entries);
 
-	std::filesystem::path path = InPath;
-	std::string parentPath = path.parent_path().string();
+		if (!entries.empty())
+			PUSH_NOTIFICATION("Opened %s (%zu difficulties)", setPath.c_str(), entries.size());
 
-	while (std::getline(InIfstream, line))
+		return entries;
+	}
+
+	//an archive can be opened as a whole or through one of its charts
+	if (InPath.extension() == ".osz" || SplitArchivePath(InPath, setPath, entryName))
 	{
-		REMOVE_POTENTIAL_NEWLINE(line);
+		if (InPath.extension() == ".osz")
+			setPath = InPath;
 
-		if (line == "[General]")
-		{
-			std::string metadataLine;
+		ArchiveReader archiveReader;
 
-			while (std::getline(InIfstream, metadataLine))
+		if (archiveReader.Open(setPath))
+		{
+			for (const std::string& archivedFileName : archiveReader.GetEntryNames())
 			{
-				REMOVE_POTENTIAL_NEWLINE(metadataLine);
+				if (std::filesystem::u8path(archivedFileName).extension() == ".osu")
+					entries.emplace_back().Path = setPath / std::filesystem::u8path(archivedFileName);
+			}
+		}
+	}
+	//a folder is a mapset of the format of the opened chart
+	else if (InPath.extension() == ".osu" || InPath.extension() == ".qua")
+	{
+		std::error_code errorCode;
 
-				if (metadataLine.empty())
-					break;
+		for (const auto& directoryEntry : std::filesystem::directory_iterator(InPath.parent_path(), errorCode))
+		{
+			if (directoryEntry.is_regular_file(errorCode) && directoryEntry.path().extension() == InPath.extension())
+				entries.emplace_back().Path = directoryEntry.path();
+		}
+	}
 
-				std::string meta;
-				std::string value;
+	std::sort(entries.begin(), entries.end(), [](const ChartSetEntry& lhs, const ChartSetEntry& rhs) { return lhs.Path < rhs.Path; });
 
-				int pointer = 0;
+	if (entries.empty())
+		entries.emplace_back().Path = InPath;
 
-				while (metadataLine[pointer] != ':')
-					meta += metadataLine[pointer++];
+	const size_t workerAmount = std::min(entries.size(), size_t(std::max(1u, std::thread::hardware_concurrency())));
+	std::atomic<size_t> nextIndex = 0;
 
-				pointer++;
-				pointer++;
+	//the workers take the next unparsed difficulty until none is left, so one long chart doesn't hold up the others
+	auto loadEntries = [this, &entries, &nextIndex]()
+	{
+		for (size_t index = nextIndex++; index < entries.size(); index = nextIndex++)
+			LoadChartSetEntry(entries[index]);
+	};
 
-				while (metadataLine[pointer] != '\0')
-					value += metadataLine[pointer++];
+	std::vector<std::thread> workers;
+	workers.reserve(workerAmount - 1);
 
-				if (meta == "AudioFilename")
-				{
-					REMOVE_POTENTIAL_NEWLINE(value);
+	for (size_t worker = 1; worker < workerAmount; ++worker)
+		workers.emplace_back(loadEntries);
 
-					std::filesystem::path resultedParentPath = parentPath;
-					std::filesystem::path songPath = resultedParentPath / value;
+	loadEntries();
 
-					chart->AudioPath = songPath;
-				}
+	for (auto& worker : workers)
+		worker.join();
+
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [](const ChartSetEntry& InEntry) { return InEntry.LoadedChart == nullptr; }), entries.end());
+
+	if (!entries.empty())
+		PUSH_NOTIFICATION("Opened %s (%zu difficulties)", setPath.c_str(), entries.size());
+
+	return entries;
+}
+
+std::vector<ChartSetEntry> ChartParserModule::LoadChartFile(const std::filesystem::path& InPath)
+{
+	std::vector<ChartSetEntry> entries;
+
+	if (IsStepmaniaFile(InPath))
+	{
+		LoadStepmaniaChartSet(InPath, entries);
+		return entries;
+	}
+
+	if (InPath.extension() == ".osz")
+	{
+		ArchiveReader archiveReader;
+
+		if (archiveReader.Open(InPath))
+		{
+			for (const std::string& archivedFileName : archiveReader.GetEntryNames())
+			{
+				if (std::filesystem::u8path(archivedFileName).extension() == ".osu")
+					entries.emplace_back().Path = InPath / std::filesystem::u8path(archivedFileName);
 			}
 		}
+	}
+	else
+		entries.emplace_back().Path = InPath;
+
+	for (ChartSetEntry& entry : entries)
+		LoadChartSetEntry(entry);
+
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [](const ChartSetEntry& InEntry) { return InEntry.LoadedChart == nullptr; }), entries.end());
+
+	return entries;
+}
+
+bool ChartParserModule::SaveChartFile(const std::filesystem::path& InPath, const ChartSnapshot& InSnapshot)
+{
+	return SaveSnapshot(InPath, InSnapshot).HasSucceeded;
+}
+
+void ChartParserModule::SetCurrentChart(const ChartSetEntry& InEntry)
+{
+	_CurrentChartPath = InEntry.Path;
+	_CurrentChartSource = InEntry.Source;
+	_IsCurrentChartFromCache = InEntry.IsFromCache;
+}
+
+bool ChartParserModule::LoadStepmaniaChartSet(const std::filesystem::path& InPath, std::vector<ChartSetEntry>& OutEntries)
+{
+	MappedFile stepmaniaFile;
+
+	if (!stepmaniaFile.Open(InPath))
+		return false;
+
+	std::error_code errorCode;
+
+	//the charts share the file, so they share its source as well
+	ChartSource source;
+	source.Size = stepmaniaFile.GetView().size();
+	source.WriteTime = int64_t(std::filesystem::last_write_time(InPath, errorCode).time_since_epoch().count());
+	source.Hash = HashContent(stepmaniaFile.GetView());
+
+	std::vector<Chart*> charts;
+	ParseChartStepmaniaImpl(stepmaniaFile.GetView(), InPath, charts);
+
+	for (size_t index = 0; index < charts.size(); ++index)
+	{
+		if (!charts[index])
+			continue;
+
+		ChartSetEntry& entry = OutEntries.emplace_back();
+		entry.LoadedChart = charts[index];
+		entry.Path = InPath / std::to_string(index);
+		entry.Source = source;
+	}
+
+	return !OutEntries.empty();
+}
 
-		if (line == "[Metadata]")
+bool ChartParserModule::LoadChartSetEntry(ChartSetEntry& OutEntry)
+{
+	std::filesystem::path stepmaniaPath;
+	size_t chartIndex = 0;
+
+	//a single chart of a stepmania file still needs the whole file parsed, the other charts get dropped again
+	if (IsStepmaniaFile(OutEntry.Path) || SplitStepmaniaPath(OutEntry.Path, stepmaniaPath, chartIndex))
+	{
+		std::vector<ChartSetEntry> entries;
+		LoadStepmaniaChartSet(stepmaniaPath.empty() ? OutEntry.Path : stepmaniaPath, entries);
+
+		for (ChartSetEntry& entry : entries)
 		{
-			std::string metadataLine;
+			if (!OutEntry.LoadedChart && (stepmaniaPath.empty() || entry.Path == OutEntry.Path))
+				OutEntry = entry;
+			else
+				delete entry.LoadedChart;
+		}
 
-			while (std::getline(InIfstream, metadataLine))
-			{
-				REMOVE_POTENTIAL_NEWLINE(metadataLine);
+		return OutEntry.LoadedChart != nullptr;
+	}
 
-				if (metadataLine.empty())
-					break;
+	MappedFile chartFile;
+	std::string archivedChart;
+	std::string_view chartContent;
 
-				std::string meta;
-				std::string value;
+	std::filesystem::path archivePath;
+	std::string entryName;
 
-				int pointer = 0;
+	//a chart inside an archive gets inflated on its own, the rest of the archive stays untouched
+	if (SplitArchivePath(OutEntry.Path, archivePath, entryName))
+	{
+		ArchiveReader archiveReader;
+		if (!archiveReader.Open(archivePath) || !archiveReader.ReadEntry(entryName, archivedChart)) return false;
 
-				while (metadataLine[pointer] != ':')
-					meta += metadataLine[pointer++];
+		chartContent = archivedChart;
+	}
+	else
+	{
+		if (!chartFile.Open(OutEntry.Path)) return false;
 
-				pointer++;
+		chartContent = chartFile.GetView();
+	}
 
-				while (metadataLine[pointer] != '\0')
-					value += metadataLine[pointer++];
+	std::error_code errorCode;
 
-				if (meta == "Title")
-					chart->SongTitle = value;
+	OutEntry.Source.Size = chartContent.size();
+	OutEntry.Source.WriteTime = int64_t(std::filesystem::last_write_time(archivePath.empty() ? OutEntry.Path : archivePath, errorCode).time_since_epoch().count());
+	OutEntry.Source.Hash = HashContent(chartContent);
 
-				if (meta == "TitleUnicode")
-					chart->SongtitleUnicode = value;
+	MappedFile cacheFile;
 
-				if (meta == "Artist")
-					chart->Artist = value;
+	if (cacheFile.Open(GetChartCachePath(OutEntry.Path)))
+		OutEntry.LoadedChart = ParseChartCacheImpl(cacheFile.GetView(), OutEntry.Path, OutEntry.Source);
 
-				if (meta == "ArtistUnicode")
-					chart->ArtistUnicode = value;
+	OutEntry.IsFromCache = OutEntry.LoadedChart != nullptr;
 
-				if (meta == "Version")
-					chart->DifficultyName = value;
+	if (OutEntry.IsFromCache)
+		return true;
 
-				if (meta == "Creator")
-					chart->Charter = value;
+	if(OutEntry.Path.extension() == ".osu")
+		OutEntry.LoadedChart = ParseChartOsuImpl(chartContent, OutEntry.Path);
+	else if(OutEntry.Path.extension() == ".qua")
+		OutEntry.LoadedChart = ParseChartQuaverImpl(chartContent, OutEntry.Path);
 
-				if (meta == "Source")
-					chart->Source = value;
+	return OutEntry.LoadedChart != nullptr;
+}
 
-				if (meta == "Tags")
-					chart->Tags = value;
+bool ChartParserModule::IsCurrentChartFromCache() const
+{
+	return _IsCurrentChartFromCache;
+}
 
-				if (meta == "BeatmapID")
-					chart->BeatmapID = value;
+void ChartParserModule::StoreChartCache(Chart* InChart)
+{
+	std::filesystem::path stepmaniaPath;
+	size_t chartIndex = 0;
 
-				if (meta == "BeatmapSetID")
-					chart->BeatmapSetID = value;
-			}
-		}
+	//stepmania files get parsed as a whole, a cache of one of their charts would never be read
+	if (SplitStepmaniaPath(_CurrentChartPath, stepmaniaPath, chartIndex))
+		return;
 
-		if (line == "[Difficulty]")
-		{
-			std::string difficultyLine;
+	std::error_code errorCode;
+	std::filesystem::create_directories(CHART_CACHE_FOLDER_PATH, errorCode);
 
-			while (std::getline(InIfstream, difficultyLine))
-			{
-				REMOVE_POTENTIAL_NEWLINE(difficultyLine);
+	std::string cacheBuffer;
+	ExportChartCacheImpl(InChart, cacheBuffer);
 
-				std::string type;
-				std::string value;
+	//the cache is only a shortcut, failing to write it simply means the next open parses again
+	WriteFileAtomically(GetChartCachePath(_CurrentChartPath), cacheBuffer);
+}
 
-				int pointer = 0;
+Chart* ChartParserModule::ParseChartCacheImpl(std::string_view InContent, const std::filesystem::path& InPath, const ChartSource& InSource)
+{
+	const char* base = InContent.data();
 
-				if (difficultyLine.empty())
-					break;
+	ChartCacheHeader header;
 
-				while (difficultyLine[pointer] != ':')
-					type += difficultyLine[pointer++];
+	if (!ReadBinaryValue(InContent, header))
+		return nullptr;
 
-				pointer++;
+	if (std::memcmp(header.Magic, CHART_CACHE_MAGIC, sizeof(header.Magic)) != 0 || header.Version != CHART_CACHE_VERSION || header.NoteSize != sizeof(Note) || header.BpmPointSize != sizeof(BpmPoint) || header.ScrollVelocitySize != sizeof(ScrollVelocityMultiplier))
+		return nullptr;
 
-				while (difficultyLine[pointer] != '\0')
-					value += difficultyLine[pointer++];
+	if (header.SourceSize != InSource.Size || header.SourceWriteTime != InSource.WriteTime || header.SourceHash != InSource.Hash)
+		return nullptr;
 
-				if (type == "CircleSize")
-					chart->KeyAmount = int(std::stoi(value));
+	std::error_code errorCode;
+	std::string sourcePath;
 
-				if(type == "HPDrainRate")
-					chart->HP = std::stof(value);
+	//two paths sharing a name hash is unlikely, but it would hand out the wrong chart
+	if (!ReadBinaryString(InContent, sourcePath) || sourcePath != std::filesystem::absolute(InPath, errorCode).u8string())
+		return nullptr;
 
-				if(type == "OverallDifficulty")
-					chart->OD = std::stof(value);
+	Chart* chart = new Chart();
 
-				if (difficultyLine.empty())
-					break;
-			}
-		}
+	std::string audioPath;
+	std::string backgroundPath;
+
+	bool isValid = ReadBinaryString(InContent, chart->ArtistUnicode)
+				&& ReadBinaryString(InContent, chart->Artist)
+				&& ReadBinaryString(InContent, chart->SongtitleUnicode)
+				&& ReadBinaryString(InContent, chart->SongTitle)
+				&& ReadBinaryString(InContent, chart->Charter)
+				&& ReadBinaryString(InContent, chart->DifficultyName)
+				&& ReadBinaryString(InContent, chart->Source)
+				&& ReadBinaryString(InContent, chart->Tags)
+				&& ReadBinaryString(InContent, chart->BeatmapID)
+				&& ReadBinaryString(InContent, chart->BeatmapSetID)
+				&& ReadBinaryString(InContent, audioPath)
+				&& ReadBinaryString(InContent, backgroundPath)
+				&& ReadBinaryValue(InContent, chart->KeyAmount)
+				&& ReadBinaryValue(InContent, chart->HasScratchKey)
+				&& ReadBinaryValue(InContent, chart->HP)
+				&& ReadBinaryValue(InContent, chart->OD);
+
+	uint64_t bpmPointAmount = 0;
+	isValid = isValid && ReadBinaryValue(InContent, bpmPointAmount) && AlignView(InContent, base) && InContent.size() / sizeof(BpmPoint) >= bpmPointAmount;
+
+	if (isValid)
+	{
+		const BpmPoint* bpmPoints = reinterpret_cast<const BpmPoint*>(InContent.data());
 
-		if (line == "[Events]")
-		{
-			std::string timePointLine;
+		for (uint64_t index = 0; index < bpmPointAmount; ++index)
+			chart->InjectBpmPoint(bpmPoints[index].TimePoint, bpmPoints[index].Bpm, bpmPoints[index].BeatLength);
 
-			while (std::getline(InIfstream, timePointLine))
-			{
-				REMOVE_POTENTIAL_NEWLINE(timePointLine);
+		InContent.remove_prefix(size_t(bpmPointAmount) * sizeof(BpmPoint));
+	}
 
-				if (timePointLine == "")
-					continue;
+	uint64_t scrollVelocityAmount = 0;
+	isValid = isValid && ReadBinaryValue(InContent, scrollVelocityAmount) && AlignView(InContent, base) && InContent.size() / sizeof(ScrollVelocityMultiplier) >= scrollVelocityAmount;
 
-				if (timePointLine == "[TimingPoints]")
-				{
-					line = "[TimingPoints]";
-					break;
-				}
+	if (isValid)
+	{
+		const ScrollVelocityMultiplier* scrollVelocities = reinterpret_cast<const ScrollVelocityMultiplier*>(InContent.data());
+
+		//written in time order, so adopting them is a copy and a single pass over the positions
+		chart->AdoptScrollVelocities(std::vector<ScrollVelocityMultiplier>(scrollVelocities, scrollVelocities + scrollVelocityAmount));
+		InContent.remove_prefix(size_t(scrollVelocityAmount) * sizeof(ScrollVelocityMultiplier));
+	}
+
+	uint64_t columnAmount = 0;
+	isValid = isValid && ReadBinaryValue(InContent, columnAmount);
 
-				if (timePointLine[0] == '/' && timePointLine[1] == '/')
-					continue;
+	for (uint64_t column = 0; isValid && column < columnAmount; ++column)
+	{
+		uint64_t noteAmount = 0;
+		isValid = ReadBinaryValue(InContent, noteAmount) && AlignView(InContent, base) && InContent.size() / sizeof(Note) >= noteAmount;
 
-				std::string background;
-				int charIndex = 0;
+		if (!isValid)
+			break;
 
-				while (timePointLine[charIndex++] != '"');
+		chart->AdoptNoteColumn(Column(column), reinterpret_cast<const Note*>(InContent.data()), size_t(noteAmount));
+		InContent.remove_prefix(size_t(noteAmount) * sizeof(Note));
+	}
 
-				do
-					background += timePointLine[charIndex];
-				while (timePointLine[++charIndex] != '"');
+	if (!isValid)
+	{
+		delete chart;
+		return nullptr;
+	}
 
-				REMOVE_POTENTIAL_NEWLINE(background);
+	chart->AudioPath = std::filesystem::u8path(audioPath);
+	chart->BackgroundPath = std::filesystem::u8path(backgroundPath);
 
-				std::filesystem::path resultedParentPath = parentPath;
-				std::filesystem::path backgroundPath = resultedParentPath / background;
+	return chart;
+}
 
-				chart->BackgroundPath = backgroundPath;
-				
-				break;
-			}
+void ChartParserModule::ExportChartCacheImpl(Chart* InChart, std::string& OutBuffer)
+{
+	std::error_code errorCode;
+
+	ChartCacheHeader header;
+	std::memcpy(header.Magic, CHART_CACHE_MAGIC, sizeof(header.Magic));
+	header.Version = CHART_CACHE_VERSION;
+	header.NoteSize = sizeof(Note);
+	header.BpmPointSize = sizeof(BpmPoint);
+	header.ScrollVelocitySize = sizeof(ScrollVelocityMultiplier);
+	header.SourceSize = _CurrentChartSource.Size;
+	header.SourceWriteTime = _CurrentChartSource.WriteTime;
+	header.SourceHash = _CurrentChartSource.Hash;
+
+	size_t noteAmount = 0;
+	for (const auto& noteColumn : InChart->NoteColumns)
+		noteAmount += noteColumn.Notes.size();
+
+	OutBuffer.clear();
+	OutBuffer.reserve(4096 + InChart->GetBpmPointAmount() * sizeof(BpmPoint) + InChart->GetScrollVelocityMap().GetSize() * sizeof(ScrollVelocityMultiplier) + noteAmount * sizeof(Note) + InChart->NoteColumns.size() * CHART_CACHE_ALIGNMENT * 2);
+
+	WriteBinaryValue(OutBuffer, header);
+	WriteBinaryString(OutBuffer, std::filesystem::absolute(_CurrentChartPath, errorCode).u8string());
+
+	WriteBinaryString(OutBuffer, InChart->ArtistUnicode);
+	WriteBinaryString(OutBuffer, InChart->Artist);
+	WriteBinaryString(OutBuffer, InChart->SongtitleUnicode);
+	WriteBinaryString(OutBuffer, InChart->SongTitle);
+	WriteBinaryString(OutBuffer, InChart->Charter);
+	WriteBinaryString(OutBuffer, InChart->DifficultyName);
+	WriteBinaryString(OutBuffer, InChart->Source);
+	WriteBinaryString(OutBuffer, InChart->Tags);
+	WriteBinaryString(OutBuffer, InChart->BeatmapID);
+	WriteBinaryString(OutBuffer, InChart->BeatmapSetID);
+	WriteBinaryString(OutBuffer, InChart->AudioPath.u8string());
+	WriteBinaryString(OutBuffer, InChart->BackgroundPath.u8string());
+	WriteBinaryValue(OutBuffer, InChart->KeyAmount);
+	WriteBinaryValue(OutBuffer, InChart->HasScratchKey);
+	WriteBinaryValue(OutBuffer, InChart->HP);
+	WriteBinaryValue(OutBuffer, InChart->OD);
+
+	WriteBinaryValue(OutBuffer, uint64_t(InChart->GetBpmPointAmount()));
+	AlignBuffer(OutBuffer);
+
+	InChart->IterateAllBpmPoints([&OutBuffer](const BpmPoint& InBpmPoint) { WriteBinaryValue(OutBuffer, InBpmPoint); });
+
+	const std::vector<ScrollVelocityMultiplier>& scrollVelocities = InChart->GetScrollVelocityMap().GetPoints();
+
+	WriteBinaryValue(OutBuffer, uint64_t(scrollVelocities.size()));
+	AlignBuffer(OutBuffer);
+
+	OutBuffer.append(reinterpret_cast<const char*>(scrollVelocities.data()), scrollVelocities.size() * sizeof(ScrollVelocityMultiplier));
+
+	WriteBinaryValue(OutBuffer, uint64_t(InChart->NoteColumns.size()));
+
+	for (const auto& noteColumn : InChart->NoteColumns)
+	{
+		WriteBinaryValue(OutBuffer, uint64_t(noteColumn.Notes.size()));
+		AlignBuffer(OutBuffer);
+
+		OutBuffer.append(reinterpret_cast<const char*>(noteColumn.Notes.data()), noteColumn.Notes.size() * sizeof(Note));
+	}
+}
+
+//hands out the next line without its line break, the view is left with everything after it
+static bool ReadLine(std::string_view& InOutView, std::string_view& OutLine)
+{
+	if (InOutView.empty())
+		return false;
+
+	const size_t lineEnd = InOutView.find('\n');
+
+	OutLine = InOutView.substr(0, lineEnd);
+	InOutView.remove_prefix(lineEnd == std::string_view::npos ? InOutView.size() : lineEnd + 1);
+
+	if (!OutLine.empty() && OutLine.back() == '\r')
+		OutLine.remove_suffix(1);
+
+	return true;
+}
+
+//hands out everything up to the next separator, the view is left with everything after it
+static std::string_view SplitOff(std::string_view& InOutView, const char InSeparator)
+{
+	const size_t separator = InOutView.find(InSeparator);
+	const std::string_view token = InOutView.substr(0, separator);
+
+	InOutView.remove_prefix(separator == std::string_view::npos ? InOutView.size() : separator + 1);
+
+	return token;
+}
+
+static std::string_view TrimLeadingSpaces(std::string_view InView)
+{
+	while (!InView.empty() && (InView.front() == ' ' || InView.front() == '\t'))
+		InView.remove_prefix(1);
+
+	return InView;
+}
+
+template<typename T>
+static bool ParseValue(std::string_view InView, T& OutValue)
+{
+	InView = TrimLeadingSpaces(InView);
+
+	return std::from_chars(InView.data(), InView.data() + InView.size(), OutValue).ec == std::errc();
+}
+
+static void AppendText(std::string& OutBuffer, const std::string_view InText)
+{
+	OutBuffer.append(InText.data(), InText.size());
+}
+
+//to_chars gives the shortest text which reads back into the exact same value, independent of any locale
+template<typename T>
+static void AppendNumber(std::string& OutBuffer, const T InValue)
+{
+	char characters[32];
+	const auto result = std::to_chars(characters, characters + sizeof(characters), InValue);
+
+	OutBuffer.append(characters, result.ptr);
+}
+
+Chart* ChartParserModule::ParseChartOsuImpl(std::string_view InContent, std::filesystem::path InPath)
+{
+	Chart* chart = new Chart();
+
+	std::filesystem::path parentPath = InPath.parent_path();
+
+	//utf-8 byte order mark
+	if (InContent.substr(0, 3) == "\xEF\xBB\xBF")
+		InContent.remove_prefix(3);
+
+	std::string_view section;
+	std::string_view line;
+
+	bool hasFoundBackground = false;
+
+	//hit objects get gathered first and placed in one go, so every column is allocated and sorted once
+	std::vector<std::pair<Column, Note>> notes;
+	std::vector<ScrollVelocityMultiplier> scrollVelocities;
+
+	while (ReadLine(InContent, line))
+	{
+		if (line.empty())
+			continue;
+
+		if (line.front() == '[')
+		{
+			section = line;
+
+			//first pass over the remaining lines, which are at most as many as there are hit objects
+			if (section == "[HitObjects]")
+				notes.reserve(std::count(InContent.begin(), InContent.end(), '\n') + 1);
+
+			continue;
 		}
 
-		if (line == "[TimingPoints]")
+		if (section == "[General]")
 		{
-			std::string timePointLine;
-			while (InIfstream >> line)
-			{
-				if (line == "[HitObjects]" || line == "[Colours]")
-					break;
+			const std::string_view meta = SplitOff(line, ':');
+
+			if (meta == "AudioFilename")
+				chart->AudioPath = parentPath / std::string(TrimLeadingSpaces(line));
+		}
+		else if (section == "[Metadata]")
+		{
+			const std::string_view meta = SplitOff(line, ':');
+			const std::string value(line);
+
+			if (meta == "Title")
+				chart->SongTitle = value;
+			else if (meta == "TitleUnicode")
+				chart->SongtitleUnicode = value;
+			else if (meta == "Artist")
+				chart->Artist = value;
+			else if (meta == "ArtistUnicode")
+				chart->ArtistUnicode = value;
+			else if (meta == "Version")
+				chart->DifficultyName = value;
+			else if (meta == "Creator")
+				chart->Charter = value;
+			else if (meta == "Source")
+				chart->Source = value;
+			else if (meta == "Tags")
+				chart->Tags = value;
+			else if (meta == "BeatmapID")
+				chart->BeatmapID = value;
+			else if (meta == "BeatmapSetID")
+				chart->BeatmapSetID = value;
+		}
+		else if (section == "[Difficulty]")
+		{
+			const std::string_view type = SplitOff(line, ':');
+
+			if (type == "CircleSize")
+				ParseValue(line, chart->KeyAmount);
+			else if (type == "HPDrainRate")
+				ParseValue(line, chart->HP);
+			else if (type == "OverallDifficulty")
+				ParseValue(line, chart->OD);
+		}
+		else if (section == "[Events]")
+		{
+			if (hasFoundBackground || line.substr(0, 2) == "//")
+				continue;
 
-				std::stringstream timePointStream(line);
+			//only the background event is of interest, which is either of type 0 or "Background"
+			std::string_view event = line;
+			const std::string_view eventType = SplitOff(event, ',');
 
-				double timePoint;
-				double beatLength;
-				int meter, sampleSet, sampleIndex, volume, uninherited, effects;
+			if (eventType != "0" && eventType != "Background")
+				continue;
 
-				PARSE_COMMA_VALUE(timePointStream, timePoint);
-				PARSE_COMMA_VALUE(timePointStream, beatLength);
-				PARSE_COMMA_VALUE(timePointStream, meter);
-				PARSE_COMMA_VALUE(timePointStream, sampleSet);
-				PARSE_COMMA_VALUE(timePointStream, sampleIndex);
-				PARSE_COMMA_VALUE(timePointStream, volume);
-				PARSE_COMMA_VALUE(timePointStream, uninherited);
-				PARSE_COMMA_VALUE(timePointStream, effects);
+			SplitOff(event, ',');
+			std::string_view background = SplitOff(event, ',');
 
-				//BPMData* bpmData = new BPMData();
-				//bpmData->BPMSaved = bpm;
+			if (!background.empty() && background.front() == '"')
+				background = background.substr(1, background.find('"', 1) - 1);
 
-				if (beatLength < 0)
-				{
-					chart->InheritedTimingPoints.push_back(timePointLine);
-					continue;
-				}
+			chart->BackgroundPath = parentPath / std::string(background);
+			hasFoundBackground = true;
+		}
+		else if (section == "[TimingPoints]")
+		{
+			std::string_view values = line;
+
+			double timePoint = 0.0;
+			double beatLength = 0.0;
+
+			if (!ParseValue(SplitOff(values, ','), timePoint) || !ParseValue(SplitOff(values, ','), beatLength))
+				continue;
 
-				double bpm = 60000.0 / beatLength;
+			//inherited points have a negative beat length, -100 divided by it is their multiplier
+			if (beatLength < 0)
+			{
+				ScrollVelocityMultiplier& scrollVelocity = scrollVelocities.emplace_back();
+				scrollVelocity.TimePoint = timePoint;
+				scrollVelocity.Multiplier = -100.0 / beatLength;
+				scrollVelocity.BeatLength = beatLength;
+
+				int uninherited = 0;
 
-				//bpmData->BPM = bpm;
-				//bpmData->timePoint = int(timePoint);
-				//bpmData->meter = meter;
-				//bpmData->uninherited = uninherited;
+				ParseValue(SplitOff(values, ','), scrollVelocity.Meter);
+				ParseValue(SplitOff(values, ','), scrollVelocity.SampleSet);
+				ParseValue(SplitOff(values, ','), scrollVelocity.SampleIndex);
+				ParseValue(SplitOff(values, ','), scrollVelocity.Volume);
+				ParseValue(SplitOff(values, ','), uninherited);
+				ParseValue(SplitOff(values, ','), scrollVelocity.Effects);
 
-				chart->InjectBpmPoint(Time(timePoint), bpm, beatLength);
+				continue;
 			}
-		}
 
-		if (line == "[HitObjects]")
+			chart->InjectBpmPoint(Time(timePoint), 60000.0 / beatLength, beatLength);
+		}
+		else if (section == "[HitObjects]")
 		{
-			std::string noteLine;
-			while (std::getline(InIfstream, noteLine))
-			{
-				REMOVE_POTENTIAL_NEWLINE(noteLine);
+			std::string_view values = line;
 
-				if (noteLine == "")
-					continue;
+			int column = 0, y = 0, timePoint = 0, noteType = 0, hitSound = 0, timePointEnd = 0;
 
-				std::stringstream noteStream(noteLine);
-				int column, y, timePoint, noteType, hitSound, timePointEnd;
+			ParseValue(SplitOff(values, ','), column);
+			ParseValue(SplitOff(values, ','), y);
+			ParseValue(SplitOff(values, ','), timePoint);
+			ParseValue(SplitOff(values, ','), noteType);
+			ParseValue(SplitOff(values, ','), hitSound);
+			ParseValue(SplitOff(values, ':'), timePointEnd);
 
-				PARSE_COMMA_VALUE(noteStream, column);
-				PARSE_COMMA_VALUE(noteStream, y);
-				PARSE_COMMA_VALUE(noteStream, timePoint);
-				PARSE_COMMA_VALUE(noteStream, noteType);
-				PARSE_COMMA_VALUE(noteStream, hitSound);
-				PARSE_COMMA_VALUE(noteStream, timePointEnd);
+			const Column parsedColumn = Column(std::clamp(floor(float(column) * (float(chart->KeyAmount) / 512.f)), 0.f, float(chart->KeyAmount) - 1.f));
 
-				int parsedColumn = std::clamp(floor(float(column) * (float(chart->KeyAmount) / 512.f)), 0.f, float(chart->KeyAmount) - 1.f);
+			Note note;
+			note.TimePoint = timePoint;
 
-				if (noteType == 128)
-				{
-					chart->InjectHold(timePoint, timePointEnd, parsedColumn);
-				}
-				else if (noteType == 1 || noteType == 5)
-				{
-					chart->InjectNote(timePoint, parsedColumn, Note::EType::Common);
-				}
+			if (noteType == 128)
+			{
+				note.Type = Note::EType::HoldBegin;
+				note.TimePointBegin = timePoint;
+				note.TimePointEnd = timePointEnd;
+			}
+			else if (noteType == 1 || noteType == 5)
+			{
+				note.Type = Note::EType::Common;
 			}
+			else
+				continue;
+
+			notes.push_back({ parsedColumn, note });
 		}
 	}
 
+	chart->BulkPlaceNotes(notes, true, true);
+	chart->AdoptScrollVelocities(std::move(scrollVelocities));
 
 	return chart;
 }
 
-Chart* ChartParserModule::ParseChartStepmaniaImpl(std::ifstream& InIfstream, std::filesystem::path InPath)
+/*
+* stepmania files are a list of #KEY:VALUE; tags. in .sm every #NOTES tag is a whole chart, in .ssc a chart starts at #NOTEDATA and the tags up to the next one belong to it.
+* the notes are laid out in measures of four beats, a measure of n rows has a row every 4/n beats. the timing is shared by all charts of the file, an .ssc chart may bring its own.
+*/
+
+struct StepmaniaTag
 {
-	return nullptr;
-}
+	std::string_view Key;
+	std::string_view Value;
+};
 
-void ChartParserModule::ExportChartSet(Chart* InChart)
+//a stretch of constant tempo, its time point is the one after any stop on its first beat is over
+struct StepmaniaTempoSegment
 {
-	std::ofstream chartFile(_CurrentChartPath);
+	double Beat = 0.0;
+	double TimePoint = 0.0;
+	double BeatLength = 0.0;
+};
 
-	ExportChartOsuImpl(InChart, chartFile);
+struct StepmaniaTiming
+{
+	std::string_view Offset;
+	std::string_view Bpms;
+	std::string_view Stops;
+};
 
-	PUSH_NOTIFICATION("Saved to %s", _CurrentChartPath.c_str());
-}
+struct StepmaniaChartTags
+{
+	std::string_view StepsType;
+	std::string_view Description;
+	std::string_view Difficulty;
+	std::string_view Credit;
+	std::string_view NoteData;
 
-void ChartParserModule::ExportChartOsuImpl(Chart* InChart, std::ofstream& InOfStream)
-{	
-	std::string backgroundFileName = InChart->BackgroundPath.filename().string();
-	std::string audioFileName = InChart->AudioPath.filename().string();
-	
-	std::stringstream chartStream;
-
-	chartStream << "osu file format v14" << "\n"
-						  << "\n"
-						  << "[General]" << "\n"
-						  << "AudioFilename: " << audioFileName << "\n"
-						  << "AudioLeadIn: 0" << "\n"
-						  << "PreviewTime: 0" << "\n"
-						  << "Countdown: 0" << "\n"
-						  << "SampleSet: Soft" << "\n"
-						  << "StackLeniency: 0.7" << "\n"
-						  << "Mode: 3" << "\n"
-						  << "LetterboxInBreaks: 0" << "\n"
-						  << "SpecialStyle: 0" << "\n"
-						  << "WidescreenStoryboard: 0" << "\n"
-						  << "\n"
-						  << "[Editor]" << "\n"
-						  << "DistanceSpacing: 1" << "\n"
-						  << "BeatDivisor: 4" << "\n"
-						  << "GridSize: 16" << "\n"
-						  << "TimelineZoom: 1" << "\n"
-						  << "\n"
-						  << "[Metadata]" << "\n"
-						  << "Title:" << InChart->SongTitle << "\n"
-						  << "TitleUnicode:" << InChart->SongtitleUnicode << "\n"
-						  << "Artist:" << InChart->Artist << "\n"
-						  << "ArtistUnicode:" << InChart->ArtistUnicode << "\n"
-						  << "Creator:" << InChart->Charter << "\n"
-						  << "Version:" << InChart->DifficultyName << "\n"
-						  << "Source:" << InChart->Source << "\n"
-						  << "Tags:" << InChart->Tags <<  "\n"
-						  << "BeatmapID:" << InChart->BeatmapID << "\n"
-						  << "BeatmapSetID:" << InChart->BeatmapSetID << "\n"
-						  << "\n"
-						  << "[Difficulty]" << "\n"
-						  << "HPDrainRate:" << InChart->HP << "\n"
-						  << "CircleSize:" << InChart->KeyAmount << "\n"
-						  << "OverallDifficulty:" << InChart->OD << "\n"
-						  << "ApproachRate:9" << "\n"
-						  << "SliderMultiplier:1.4" << "\n"
-						  << "SliderTickRate:1" << "\n"
-						  << "\n"
-						  << "[Events]" << "\n"
-							<< "//Background and Video events" << "\n";
+	//only .ssc charts with their own timing have these
+	StepmaniaTiming Timing;
+};
 
-	if (backgroundFileName != "")
-		chartStream << "0,0,\"" << backgroundFileName << "\",0,0" << "\n";
-
-	chartStream << "//Break Periods" << "\n"
-							<< "//Storyboard Layer 0 (Background)" << "\n"
-							<< "//Storyboard Layer 1 (Fail)" << "\n"
-							<< "//Storyboard Layer 2 (Pass)" << "\n"
-							<< "//Storyboard Layer 3 (Foreground)" << "\n"
-							<< "//Storyboard Layer 4 (Overlay)" << "\n"
-							<< "//Storyboard Sound Samples" << "\n"
-							<< "\n"
-							<< "[TimingPoints]" << "\n";
-
-	for (std::string inheritedPoint : InChart->InheritedTimingPoints)
-		chartStream << inheritedPoint;
-	
-	InChart->IterateAllBpmPoints([&chartStream](BpmPoint& InBpmPoint)
+static std::string_view TrimWhitespace(std::string_view InView)
+{
+	while (!InView.empty() && std::isspace(static_cast<unsigned char>(InView.front())))
+		InView.remove_prefix(1);
+
+	while (!InView.empty() && std::isspace(static_cast<unsigned char>(InView.back())))
+		InView.remove_suffix(1);
+
+	return InView;
+}
+
+//the value runs up to its semicolon, files which forgot one end it where the next tag starts
+static bool ReadStepmaniaTag(std::string_view& InOutView, StepmaniaTag& OutTag)
+{
+	while (!InOutView.empty() && InOutView.front() != '#')
 	{
-		chartStream << InBpmPoint.TimePoint << "," << InBpmPoint.BeatLength << "," << "4" << ",0,0,10,1,0\n";
-	});
+		if (InOutView.substr(0, 2) == "//")
+			InOutView.remove_prefix(std::min(InOutView.find('\n'), InOutView.size()));
+		else
+			InOutView.remove_prefix(1);
+	}
 
-	// leaving the "4" there since we will want to set custom snap divisor
-	
-	chartStream << "\n"
-							<< "\n"
-							<< "[HitObjects]" << "\n";
+	const size_t keyEnd = InOutView.find(':');
+
+	if (InOutView.empty() || keyEnd == std::string_view::npos)
+		return false;
+
+	OutTag.Key = InOutView.substr(1, keyEnd - 1);
+	InOutView.remove_prefix(keyEnd + 1);
+
+	const size_t valueEnd = std::min(InOutView.find(';'), InOutView.find("\n#"));
+
+	OutTag.Value = InOutView.substr(0, valueEnd);
+	InOutView.remove_prefix(valueEnd == std::string_view::npos ? InOutView.size() : valueEnd + 1);
+
+	return true;
+}
+
+//"beat=value,beat=value", sorted by beat
+static std::vector<std::pair<double, double>> ParseStepmaniaBeatValues(std::string_view InValue)
+{
+	std::vector<std::pair<double, double>> beatValues;
 
-	int keyAmount = InChart->KeyAmount;
-	InChart->IterateAllNotes([keyAmount, &chartStream](const Note InOutNote, const Column InColumn)
+	while (!InValue.empty())
 	{
-		int column = float(float((InColumn + 1)) * 512.f) / float(keyAmount) - (512.f / float(keyAmount) / 2.f);
+		std::string_view beatValue = SplitOff(InValue, ',');
+		const std::string_view beat = TrimWhitespace(SplitOff(beatValue, '='));
 
-		switch (InOutNote.Type)
-		{
-		case Note::EType::Common:
-			chartStream << column << ",192," << InOutNote.TimePoint << ",1,0,0:0:0:0:\n";
-			break;
-		
-		case Note::EType::HoldBegin:
-			chartStream << column << ",192," << InOutNote.TimePoint << ",128,0," << InOutNote.TimePointEnd << ":0:0:0:0:\n";
-			break;
+		std::pair<double, double> parsedBeatValue;
 
-		default:
-			break;
-		}
-	});
+		if (ParseValue(beat, parsedBeatValue.first) && ParseValue(TrimWhitespace(beatValue), parsedBeatValue.second) && parsedBeatValue.first >= 0.0)
+			beatValues.push_back(parsedBeatValue);
+	}
+
+	std::stable_sort(beatValues.begin(), beatValues.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
 
-	InOfStream.clear();
-	InOfStream << chartStream.str();
-	InOfStream.close();
+	return beatValues;
 }
-void ChartParserModule::ExportChartStepmaniaImpl(Chart* InChart, std::ofstream& InOfStream)
+
+/*
+* walks the bpm changes and stops once in beat order, every change of either starts a new segment.
+* a stop and a bpm change on the same beat become a single segment, which starts once the stop is over.
+* warps and other negative values aren't supported, they get ignored.
+*/
+static std::vector<StepmaniaTempoSegment> BuildStepmaniaTempoMap(const StepmaniaTiming& InTiming)
 {
-	return;
+	std::vector<StepmaniaTempoSegment> tempoMap;
+
+	const std::vector<std::pair<double, double>> bpms = ParseStepmaniaBeatValues(InTiming.Bpms);
+	const std::vector<std::pair<double, double>> stops = ParseStepmaniaBeatValues(InTiming.Stops);
+
+	double offset = 0.0;
+	ParseValue(TrimWhitespace(InTiming.Offset), offset);
+
+	if (bpms.empty() || bpms.front().second <= 0.0)
+		return tempoMap;
+
+	StepmaniaTempoSegment segment;
+	segment.TimePoint = -offset * 1000.0;
+	segment.BeatLength = 60000.0 / bpms.front().second;
+
+	tempoMap.push_back(segment);
+
+	size_t bpmIndex = 1;
+	size_t stopIndex = 0;
+
+	while (bpmIndex < bpms.size() || stopIndex < stops.size())
+	{
+		const double beat = std::min(bpmIndex < bpms.size() ? bpms[bpmIndex].first : INFINITY, stopIndex < stops.size() ? stops[stopIndex].first : INFINITY);
+		const StepmaniaTempoSegment previousSegment = segment;
+
+		segment.TimePoint += (beat - segment.Beat) * segment.BeatLength;
+		segment.Beat = beat;
+
+		for (; bpmIndex < bpms.size() && bpms[bpmIndex].first == beat; ++bpmIndex)
+		{
+			if (bpms[bpmIndex].second > 0.0)
+				segment.BeatLength = 60000.0 / bpms[bpmIndex].second;
+		}
+
+		for (; stopIndex < stops.size() && stops[stopIndex].first == beat; ++stopIndex)
+			segment.TimePoint += std::max(stops[stopIndex].second, 0.0) * 1000.0;
+
+		if (segment.BeatLength != previousSegment.BeatLength || segment.TimePoint != previousSegment.TimePoint + (beat - previousSegment.Beat) * previousSegment.BeatLength)
+			tempoMap.push_back(segment);
+	}
+
+	return tempoMap;
+}
+
+//a row may be followed by a comment, and lines may only hold whitespace
+static std::string_view GetStepmaniaRow(std::string_view InLine)
+{
+	return TrimWhitespace(InLine.substr(0, InLine.find("//")));
+}
+
+//the row width is what counts, the steps type only decides it when there are no rows to measure
+static int GetStepmaniaKeyAmount(const std::string_view InStepsType, std::string_view InNoteData)
+{
+	std::string_view line;
+
+	while (ReadLine(InNoteData, line))
+	{
+		const std::string_view row = GetStepmaniaRow(line);
+
+		if (!row.empty() && row.front() != ',')
+			return int(row.size());
+	}
+
+	static const std::pair<std::string_view, int> keyAmounts[] =
+	{
+		{ "dance-threepanel", 3 }, { "dance-single", 4 }, { "pump-single", 5 }, { "dance-solo", 6 }, { "pump-halfdouble", 6 },
+		{ "kb7-single", 7 }, { "dance-double", 8 }, { "dance-couple", 8 }, { "pnm-nine", 9 }, { "pump-double", 10 }, { "pump-couple", 10 },
+	};
+
+	for (const auto& [stepsType, keyAmount] : keyAmounts)
+	{
+		if (stepsType == InStepsType)
+			return keyAmount;
+	}
+
+	return 0;
+}
+
+//rows come in beat order, so the segment of a row is always the one of the previous row or a later one
+static void ParseStepmaniaNoteData(std::string_view InNoteData, const int InKeyAmount, const std::vector<StepmaniaTempoSegment>& InTempoMap, std::vector<std::pair<Column, Note>>& OutNotes)
+{
+	std::vector<Time> holdBegins(InKeyAmount, -1);
+	std::string_view line;
+
+	size_t segmentIndex = 0;
+
+	for (int measure = 0; !InNoteData.empty(); ++measure)
+	{
+		std::string_view measureData = SplitOff(InNoteData, ',');
+
+		//a row's beat depends on how many rows its measure has, so those get counted first
+		int rowAmount = 0;
+
+		for (std::string_view rows = measureData; ReadLine(rows, line);)
+			rowAmount += !GetStepmaniaRow(line).empty();
+
+		for (int rowIndex = 0; ReadLine(measureData, line);)
+		{
+			const std::string_view row = GetStepmaniaRow(line);
+
+			if (row.empty())
+				continue;
+
+			const double beat = 4.0 * measure + 4.0 * rowIndex++ / rowAmount;
+
+			//a note on the beat of a stop is hit before the stop, so the segment starting after it only counts for later beats
+			while (segmentIndex + 1 < InTempoMap.size() && InTempoMap[segmentIndex + 1].Beat < beat)
+				segmentIndex++;
+
+			const StepmaniaTempoSegment& segment = InTempoMap[segmentIndex];
+			const Time time = Time(std::lround(segment.TimePoint + (beat - segment.Beat) * segment.BeatLength));
+
+			for (Column column = 0; column < Column(std::min<size_t>(row.size(), InKeyAmount)); ++column)
+			{
+				Note note;
+				note.TimePoint = time;
+
+				switch (row[column])
+				{
+				case '1':
+				case 'L':
+					note.Type = Note::EType::Common;
+					OutNotes.push_back({ column, note });
+					break;
+
+				//rolls are played like holds
+				case '2':
+				case '4':
+					holdBegins[column] = time;
+					break;
+
+				case '3':
+					if (holdBegins[column] < 0)
+						break;
+
+					note.Type = Note::EType::HoldBegin;
+					note.TimePoint = holdBegins[column];
+					note.TimePointBegin = holdBegins[column];
+					note.TimePointEnd = time;
+					OutNotes.push_back({ column, note });
+
+					holdBegins[column] = -1;
+					break;
+
+				//mines, fakes and lifts aren't notes to play
+				default:
+					break;
+				}
+			}
+		}
+	}
+}
+
+void ChartParserModule::ParseChartStepmaniaImpl(std::string_view InContent, const std::filesystem::path& InPath, std::vector<Chart*>& OutCharts)
+{
+	const std::filesystem::path parentPath = InPath.parent_path();
+	const bool isSsc = InPath.extension() == ".ssc";
+
+	//utf-8 byte order mark
+	if (InContent.substr(0, 3) == "\xEF\xBB\xBF")
+		InContent.remove_prefix(3);
+
+	std::string_view title, titleTransliterated, artist, artistTransliterated, credit, music, background;
+
+	StepmaniaTiming timing;
+	std::vector<StepmaniaChartTags> chartTags;
+
+	//one pass over the tags, the values stay views into the file until every tag is known
+	StepmaniaTag tag;
+
+	while (ReadStepmaniaTag(InContent, tag))
+	{
+		const bool isInChart = isSsc && !chartTags.empty();
+		StepmaniaTiming& currentTiming = isInChart ? chartTags.back().Timing : timing;
+
+		if (tag.Key == "NOTEDATA" && isSsc)
+			chartTags.emplace_back();
+		else if (tag.Key == "NOTES" && isSsc && isInChart)
+			chartTags.back().NoteData = tag.Value;
+		else if (tag.Key == "NOTES" && !isSsc)
+		{
+			StepmaniaChartTags& chart = chartTags.emplace_back();
+			std::string_view fields = tag.Value;
+
+			chart.StepsType = TrimWhitespace(SplitOff(fields, ':'));
+			chart.Description = TrimWhitespace(SplitOff(fields, ':'));
+			chart.Difficulty = TrimWhitespace(SplitOff(fields, ':'));
+			SplitOff(fields, ':');
+			SplitOff(fields, ':');
+			chart.NoteData = fields;
+		}
+		else if (tag.Key == "STEPSTYPE" && isInChart)
+			chartTags.back().StepsType = TrimWhitespace(tag.Value);
+		else if (tag.Key == "DESCRIPTION" && isInChart)
+			chartTags.back().Description = TrimWhitespace(tag.Value);
+		else if (tag.Key == "DIFFICULTY" && isInChart)
+			chartTags.back().Difficulty = TrimWhitespace(tag.Value);
+		else if (tag.Key == "CREDIT" && isInChart)
+			chartTags.back().Credit = TrimWhitespace(tag.Value);
+		else if (tag.Key == "OFFSET")
+			currentTiming.Offset = tag.Value;
+		else if (tag.Key == "BPMS")
+			currentTiming.Bpms = tag.Value;
+		else if (tag.Key == "STOPS")
+			currentTiming.Stops = tag.Value;
+		else if (tag.Key == "TITLE")
+			title = TrimWhitespace(tag.Value);
+		else if (tag.Key == "TITLETRANSLIT")
+			titleTransliterated = TrimWhitespace(tag.Value);
+		else if (tag.Key == "ARTIST")
+			artist = TrimWhitespace(tag.Value);
+		else if (tag.Key == "ARTISTTRANSLIT")
+			artistTransliterated = TrimWhitespace(tag.Value);
+		else if (tag.Key == "CREDIT")
+			credit = TrimWhitespace(tag.Value);
+		else if (tag.Key == "MUSIC")
+			music = TrimWhitespace(tag.Value);
+		else if (tag.Key == "BACKGROUND")
+			background = TrimWhitespace(tag.Value);
+	}
+
+	//the tempo map of the file is built once and shared by every chart which doesn't have its own
+	const std::vector<StepmaniaTempoSegment> tempoMap = BuildStepmaniaTempoMap(timing);
+
+	OutCharts.reserve(chartTags.size());
+
+	for (const StepmaniaChartTags& tags : chartTags)
+	{
+		const bool hasOwnTiming = !tags.Timing.Offset.empty() || !tags.Timing.Bpms.empty() || !tags.Timing.Stops.empty();
+
+		StepmaniaTiming chartTiming = timing;
+
+		if (!tags.Timing.Offset.empty()) chartTiming.Offset = tags.Timing.Offset;
+		if (!tags.Timing.Bpms.empty()) chartTiming.Bpms = tags.Timing.Bpms;
+		if (!tags.Timing.Stops.empty()) chartTiming.Stops = tags.Timing.Stops;
+
+		const std::vector<StepmaniaTempoSegment> ownTempoMap = hasOwnTiming ? BuildStepmaniaTempoMap(chartTiming) : std::vector<StepmaniaTempoSegment>();
+		const std::vector<StepmaniaTempoSegment>& chartTempoMap = hasOwnTiming ? ownTempoMap : tempoMap;
+
+		const int keyAmount = GetStepmaniaKeyAmount(tags.StepsType, tags.NoteData);
+
+		//the index of a chart in the file is its path, a broken one still takes up its index
+		if (chartTempoMap.empty() || keyAmount <= 0)
+		{
+			OutCharts.push_back(nullptr);
+			continue;
+		}
+
+		Chart* chart = new Chart();
+
+		chart->SongtitleUnicode = std::string(title);
+		chart->SongTitle = std::string(titleTransliterated.empty() ? title : titleTransliterated);
+		chart->ArtistUnicode = std::string(artist);
+		chart->Artist = std::string(artistTransliterated.empty() ? artist : artistTransliterated);
+		chart->KeyAmount = keyAmount;
+
+		//an edit is named by its description, for the other difficulties the description usually is the charter
+		if (tags.Difficulty == "Edit" && !tags.Description.empty())
+		{
+			chart->DifficultyName = std::string(tags.Description);
+			chart->Charter = std::string(!tags.Credit.empty() ? tags.Credit : credit);
+		}
+		else
+		{
+			chart->DifficultyName = std::string(tags.Difficulty);
+			chart->Charter = std::string(!tags.Credit.empty() ? tags.Credit : !tags.Description.empty() && !isSsc ? tags.Description : credit);
+		}
+
+		if (!music.empty())
+			chart->AudioPath = parentPath / std::filesystem::u8path(music);
+
+		if (!background.empty())
+			chart->BackgroundPath = parentPath / std::filesystem::u8path(background);
+
+		//several segments on the same beat only differ in the stops between them, the last one is where the tempo continues from
+		for (size_t index = 0; index < chartTempoMap.size(); ++index)
+		{
+			if (index + 1 < chartTempoMap.size() && chartTempoMap[index + 1].Beat == chartTempoMap[index].Beat)
+				continue;
+
+			chart->InjectBpmPoint(Time(std::lround(chartTempoMap[index].TimePoint)), 60000.0 / chartTempoMap[index].BeatLength, chartTempoMap[index].BeatLength);
+		}
+
+		std::vector<std::pair<Column, Note>> notes;
+		notes.reserve(std::count(tags.NoteData.begin(), tags.NoteData.end(), '\n') * 2);
+
+		ParseStepmaniaNoteData(tags.NoteData, keyAmount, chartTempoMap, notes);
+
+		chart->BulkPlaceNotes(notes, true, true);
+
+		OutCharts.push_back(chart);
+	}
+}
+
+/*
+* puts the timing and notes of a chart exported on its own into its place in the whole file, so the other charts and every tag the editor doesn't know stay as they were.
+* the timing goes where the chart reads it from, which is its own timing tag in an .ssc chart that has one and the tag of the file otherwise.
+*/
+static bool SpliceStepmaniaChart(std::string_view InContent, const bool InIsSsc, const size_t InChartIndex, std::string_view InExportedChart, std::string& OutBuffer)
+{
+	StepmaniaTiming exportedTiming;
+	std::string_view exportedNoteData;
+
+	StepmaniaTag tag;
+
+	while (ReadStepmaniaTag(InExportedChart, tag))
+	{
+		if (tag.Key == "OFFSET")
+			exportedTiming.Offset = tag.Value;
+		else if (tag.Key == "BPMS")
+			exportedTiming.Bpms = tag.Value;
+		else if (tag.Key == "STOPS")
+			exportedTiming.Stops = tag.Value;
+		else if (tag.Key == "NOTES")
+		{
+			exportedNoteData = tag.Value;
+
+			for (int field = 0; field < 5; ++field)
+				SplitOff(exportedNoteData, ':');
+		}
+	}
+
+	const std::string_view timingKeys[] = { "OFFSET", "BPMS", "STOPS" };
+	const std::string_view exportedTimingValues[] = { exportedTiming.Offset, exportedTiming.Bpms, exportedTiming.Stops };
+
+	std::string_view fileTimingValues[3];
+	std::string_view chartTimingValues[3];
+	std::string_view noteData;
+
+	const char* firstChartBegin = nullptr;
+
+	std::string_view view = InContent;
+	size_t chartAmount = 0;
+
+	while (ReadStepmaniaTag(view, tag))
+	{
+		const bool isChartBegin = tag.Key == (InIsSsc ? "NOTEDATA" : "NOTES");
+
+		if (isChartBegin && !firstChartBegin)
+			firstChartBegin = tag.Key.data() - 1;
+
+		chartAmount += isChartBegin;
+
+		const bool isInChart = chartAmount > 0 && InIsSsc;
+		const bool isInSplicedChart = chartAmount == InChartIndex + 1;
+
+		for (size_t index = 0; index < 3; ++index)
+		{
+			if (tag.Key != timingKeys[index])
+				continue;
+
+			if (!isInChart)
+				fileTimingValues[index] = tag.Value;
+			else if (isInSplicedChart)
+				chartTimingValues[index] = tag.Value;
+		}
+
+		if (tag.Key == "NOTES" && isInSplicedChart)
+		{
+			noteData = tag.Value;
+
+			//.sm notes start with five fields describing the chart, those are kept
+			for (int field = 0; field < 5 && !InIsSsc; ++field)
+			{
+				if (noteData.find(':') == std::string_view::npos)
+					return false;
+
+				SplitOff(noteData, ':');
+			}
+		}
+	}
+
+	if (noteData.data() == nullptr || !firstChartBegin)
+		return false;
+
+	//each replacement is a range of the file and what goes there instead, an empty range inserts a whole new tag
+	std::vector<std::pair<std::string_view, std::string>> replacements;
+	replacements.push_back({ noteData, std::string(exportedNoteData) });
+
+	for (size_t index = 0; index < 3; ++index)
+	{
+		if (chartTimingValues[index].data())
+			replacements.push_back({ chartTimingValues[index], std::string(exportedTimingValues[index]) });
+		else if (fileTimingValues[index].data())
+			replacements.push_back({ fileTimingValues[index], std::string(exportedTimingValues[index]) });
+		else if (!exportedTimingValues[index].empty())
+			replacements.push_back({ std::string_view(firstChartBegin, 0), "#" + std::string(timingKeys[index]) + ":" + std::string(exportedTimingValues[index]) + ";\n" });
+	}
+
+	std::sort(replacements.begin(), replacements.end(), [](const auto& lhs, const auto& rhs) { return lhs.first.data() < rhs.first.data(); });
+
+	OutBuffer.clear();
+	OutBuffer.reserve(InContent.size() + exportedNoteData.size());
+
+	const char* copiedUntil = InContent.data();
+
+	for (const auto& [range, replacement] : replacements)
+	{
+		OutBuffer.append(copiedUntil, range.data());
+		OutBuffer.append(replacement);
+
+		copiedUntil = range.data() + range.size();
+	}
+
+	OutBuffer.append(copiedUntil, InContent.data() + InContent.size());
+
+	return true;
+}
+
+//yaml-cpp only reads from streams, this one reads straight out of the mapped file instead of a copy of it
+struct ViewStreamBuffer : public std::streambuf
+{
+	ViewStreamBuffer(std::string_view InView)
+	{
+		char* begin = const_cast<char*>(InView.data());
+		setg(begin, begin, begin + InView.size());
+	}
+};
+
+/*
+* quaver charts are yaml, they get read event by event instead of being loaded as a node tree, which takes several times the size of the file for a long chart.
+* only the keys of the top level map and the fields of the items of the object lists matter, anything nested deeper than that gets skipped.
+*/
+class QuaverEventHandler : public YAML::EventHandler
+{
+public:
+
+	QuaverEventHandler(Chart* OutChart, const std::filesystem::path& InParentPath, std::vector<std::pair<Column, Note>>& OutNotes)
+		: _Chart(OutChart)
+		, _ParentPath(InParentPath)
+		, _Notes(OutNotes)
+	{
+	}
+
+	void OnDocumentStart(const YAML::Mark& InMark) override {}
+	void OnDocumentEnd() override {}
+
+	void OnNull(const YAML::Mark& InMark, YAML::anchor_t InAnchor) override { OnValue(""); }
+	void OnAlias(const YAML::Mark& InMark, YAML::anchor_t InAnchor) override { OnValue(""); }
+	void OnScalar(const YAML::Mark& InMark, const std::string& InTag, YAML::anchor_t InAnchor, const std::string& InValue) override { OnValue(InValue); }
+
+	void OnSequenceStart(const YAML::Mark& InMark, const std::string& InTag, YAML::anchor_t InAnchor, YAML::EmitterStyle::value InStyle) override { BeginContainer(false); }
+	void OnSequenceEnd() override { EndContainer(); }
+
+	void OnMapStart(const YAML::Mark& InMark, const std::string& InTag, YAML::anchor_t InAnchor, YAML::EmitterStyle::value InStyle) override { BeginContainer(true); }
+	void OnMapEnd() override { EndContainer(); }
+
+	int KeyAmount = 0;
+	bool HasScratchKey = false;
+
+	std::vector<ScrollVelocityMultiplier> ScrollVelocities;
+
+private:
+
+	enum class EList
+	{
+		None,
+		TimingPoints,
+		SliderVelocities,
+		HitObjects,
+	};
+
+	struct Container
+	{
+		bool IsMap = false;
+		bool IsExpectingKey = true;
+		std::string Key;
+	};
+
+	//the fields of the list item being read, they only make an object once the item is over
+	struct Item
+	{
+		double StartTime = 0.0;
+		double Bpm = 0.0;
+		double Multiplier = 0.0;
+		int Lane = 0;
+		int EndTime = 0;
+	};
+
+	void OnValue(const std::string& InValue)
+	{
+		if (_Containers.empty() || !_Containers.back().IsMap)
+			return;
+
+		Container& container = _Containers.back();
+
+		if (container.IsExpectingKey)
+		{
+			container.Key = InValue;
+			container.IsExpectingKey = false;
+
+			return;
+		}
+
+		container.IsExpectingKey = true;
+
+		if (_Containers.size() == 1)
+			OnMetadata(container.Key, InValue);
+		else if (_Containers.size() == 3 && _List != EList::None)
+			OnItemField(container.Key, InValue);
+	}
+
+	void BeginContainer(const bool InIsMap)
+	{
+		if (_Containers.size() == 1 && !InIsMap)
+		{
+			const std::string& key = _Containers.back().Key;
+			_List = key == "TimingPoints" ? EList::TimingPoints : key == "SliderVelocities" ? EList::SliderVelocities : key == "HitObjects" ? EList::HitObjects : EList::None;
+		}
+
+		if (_Containers.size() == 2 && InIsMap)
+			_Item = Item();
+
+		_Containers.push_back({ InIsMap, true, {} });
+	}
+
+	void EndContainer()
+	{
+		if (_Containers.size() == 3 && _Containers.back().IsMap && _List != EList::None)
+			OnItemEnd();
+
+		if (_Containers.size() == 2)
+			_List = EList::None;
+
+		_Containers.pop_back();
+
+		//a map or list that was the value of a key is over, the next scalar is a key again
+		if (!_Containers.empty() && _Containers.back().IsMap)
+			_Containers.back().IsExpectingKey = true;
+	}
+
+	void OnMetadata(const std::string& InKey, const std::string& InValue)
+	{
+		if (InKey == "AudioFile")
+			_Chart->AudioPath = _ParentPath / std::filesystem::u8path(InValue);
+		else if (InKey == "BackgroundFile" && !InValue.empty())
+			_Chart->BackgroundPath = _ParentPath / std::filesystem::u8path(InValue);
+		else if (InKey == "MapId")
+			_Chart->BeatmapID = InValue;
+		else if (InKey == "MapSetId")
+			_Chart->BeatmapSetID = InValue;
+		else if (InKey == "Mode" && InValue.rfind("Keys", 0) == 0)
+			ParseValue(std::string_view(InValue).substr(4), KeyAmount);
+		else if (InKey == "HasScratchKey")
+			HasScratchKey = InValue == "true";
+		else if (InKey == "Title")
+			_Chart->SongTitle = _Chart->SongtitleUnicode = InValue;
+		else if (InKey == "Artist")
+			_Chart->Artist = _Chart->ArtistUnicode = InValue;
+		else if (InKey == "Source")
+			_Chart->Source = InValue;
+		else if (InKey == "Tags")
+			_Chart->Tags = InValue;
+		else if (InKey == "Creator")
+			_Chart->Charter = InValue;
+		else if (InKey == "DifficultyName")
+			_Chart->DifficultyName = InValue;
+	}
+
+	//quaver leaves out every field that has its default value
+	void OnItemField(const std::string& InKey, const std::string& InValue)
+	{
+		if (InKey == "StartTime")
+			ParseValue(InValue, _Item.StartTime);
+		else if (InKey == "Bpm")
+			ParseValue(InValue, _Item.Bpm);
+		else if (InKey == "Multiplier")
+			ParseValue(InValue, _Item.Multiplier);
+		else if (InKey == "Lane")
+			ParseValue(InValue, _Item.Lane);
+		else if (InKey == "EndTime")
+			ParseValue(InValue, _Item.EndTime);
+	}
+
+	void OnItemEnd()
+	{
+		switch (_List)
+		{
+		case EList::TimingPoints:
+			if (_Item.Bpm > 0.0)
+				_Chart->InjectBpmPoint(Time(std::lround(_Item.StartTime)), _Item.Bpm, 60000.0 / _Item.Bpm);
+			break;
+
+		case EList::SliderVelocities:
+		{
+			ScrollVelocityMultiplier& scrollVelocity = ScrollVelocities.emplace_back();
+			scrollVelocity.TimePoint = _Item.StartTime;
+			scrollVelocity.Multiplier = _Item.Multiplier;
+			break;
+		}
+
+		case EList::HitObjects:
+		{
+			if (_Item.Lane < 1)
+				break;
+
+			Note note;
+			note.TimePoint = Time(std::lround(_Item.StartTime));
+
+			if (_Item.EndTime > note.TimePoint)
+			{
+				note.Type = Note::EType::HoldBegin;
+				note.TimePointBegin = note.TimePoint;
+				note.TimePointEnd = _Item.EndTime;
+			}
+			else
+				note.Type = Note::EType::Common;
+
+			_Notes.push_back({ Column(_Item.Lane - 1), note });
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	Chart* _Chart;
+	std::filesystem::path _ParentPath;
+	std::vector<std::pair<Column, Note>>& _Notes;
+
+	std::vector<Container> _Containers;
+	EList _List = EList::None;
+	Item _Item;
+};
+
+Chart* ChartParserModule::ParseChartQuaverImpl(std::string_view InContent, std::filesystem::path InPath)
+{
+	Chart* chart = new Chart();
+
+	std::vector<std::pair<Column, Note>> notes;
+	QuaverEventHandler eventHandler(chart, InPath.parent_path(), notes);
+
+	ViewStreamBuffer streamBuffer(InContent);
+	std::istream stream(&streamBuffer);
+
+	try
+	{
+		YAML::Parser parser(stream);
+		parser.HandleNextDocument(eventHandler);
+	}
+	catch (const YAML::Exception& InException)
+	{
+		delete chart;
+		return nullptr;
+	}
+
+	//the scratch lane comes after the regular ones
+	chart->KeyAmount = eventHandler.KeyAmount + (eventHandler.HasScratchKey ? 1 : 0);
+	chart->HasScratchKey = eventHandler.HasScratchKey;
+
+	if (chart->KeyAmount <= 0)
+	{
+		delete chart;
+		return nullptr;
+	}
+
+	for (auto& [column, note] : notes)
+		column = std::min(column, Column(chart->KeyAmount - 1));
+
+	chart->BulkPlaceNotes(notes, true, true);
+	chart->AdoptScrollVelocities(std::move(eventHandler.ScrollVelocities));
+
+	return chart;
+}
+
+bool ChartParserModule::Tick(const float& InDeltaTime)
+{
+	ReportFinishedSaves();
+
+	return true;
+}
+
+void ChartParserModule::ReportFinishedSaves()
+{
+	std::vector<FinishedSave> finishedSaves;
+
+	{
+		std::lock_guard<std::mutex> lock(_SaveMutex);
+		finishedSaves.swap(_FinishedSaves);
+	}
+
+	//notifications aren't thread safe, so they only get pushed from here
+	for (const FinishedSave& finishedSave : finishedSaves)
+	{
+		if (finishedSave.HasSucceeded)
+			PUSH_NOTIFICATION("Saved to %s (%zu bytes in %.1f ms)", finishedSave.Path.c_str(), finishedSave.Bytes, finishedSave.Milliseconds);
+		else
+			PUSH_NOTIFICATION("Failed to save %s", finishedSave.Path.c_str());
+
+		if (_OnSaveFinished)
+			_OnSaveFinished(finishedSave.Index, finishedSave.HasSucceeded);
+	}
+}
+
+void ChartParserModule::RegisterOnSaveFinishedCallback(std::function<void(const size_t InSaveIndex, const bool InHasSucceeded)> InCallback)
+{
+	_OnSaveFinished = InCallback;
+}
+
+bool ChartParserModule::ShutDown()
+{
+	{
+		std::lock_guard<std::mutex> lock(_SaveMutex);
+		_ShouldStopSaving = true;
+	}
+
+	_SaveCondition.notify_one();
+
+	//the thread finishes every pending save before it stops, nothing the user saved gets dropped on exit
+	if (_SaveThread.joinable())
+		_SaveThread.join();
+
+	//the modules shutting down after this one still get to know which saves made it
+	ReportFinishedSaves();
+
+	return true;
+}
+
+bool ChartParserModule::ExportChartSet(Chart* InChart)
+{
+	//a save of the same file that is still waiting would otherwise overwrite this one with older data
+	{
+		std::lock_guard<std::mutex> lock(_SaveMutex);
+		_PendingSaves.erase(std::remove_if(_PendingSaves.begin(), _PendingSaves.end(), [this](const PendingSave& InPendingSave) { return InPendingSave.Path == _CurrentChartPath; }), _PendingSaves.end());
+	}
+
+	const FinishedSave finishedSave = SaveSnapshot(_CurrentChartPath, InChart->TakeSnapshot());
+
+	if (finishedSave.HasSucceeded)
+		PUSH_NOTIFICATION("Saved to %s (%zu bytes in %.1f ms)", finishedSave.Path.c_str(), finishedSave.Bytes, finishedSave.Milliseconds);
+	else
+		PUSH_NOTIFICATION("Failed to save %s", finishedSave.Path.c_str());
+
+	return finishedSave.HasSucceeded;
+}
+
+size_t ChartParserModule::ExportChartSetInBackground(Chart* InChart)
+{
+	PendingSave pendingSave = { ++_SaveAmount, _CurrentChartPath, InChart->TakeSnapshot() };
+	const size_t saveIndex = pendingSave.Index;
+
+	{
+		std::lock_guard<std::mutex> lock(_SaveMutex);
+
+		auto pendingSaveIt = std::find_if(_PendingSaves.begin(), _PendingSaves.end(), [&pendingSave](const PendingSave& InPendingSave) { return InPendingSave.Path == pendingSave.Path; });
+
+		if (pendingSaveIt != _PendingSaves.end())
+			*pendingSaveIt = std::move(pendingSave);
+		else
+			_PendingSaves.push_back(std::move(pendingSave));
+
+		if (!_SaveThread.joinable())
+			_SaveThread = std::thread(&ChartParserModule::RunSaveThread, this);
+	}
+
+	_SaveCondition.notify_one();
+
+	return saveIndex;
+}
+
+void ChartParserModule::ExportMapsetArchiveInBackground(Chart* InChart, const std::filesystem::path& InArchivePath)
+{
+	PendingSave pendingSave = { ++_SaveAmount, InArchivePath, InChart->TakeSnapshot(), _CurrentChartPath };
+
+	{
+		std::lock_guard<std::mutex> lock(_SaveMutex);
+
+		_PendingSaves.push_back(std::move(pendingSave));
+
+		if (!_SaveThread.joinable())
+			_SaveThread = std::thread(&ChartParserModule::RunSaveThread, this);
+	}
+
+	_SaveCondition.notify_one();
+}
+
+void ChartParserModule::RunSaveThread()
+{
+	std::unique_lock<std::mutex> lock(_SaveMutex);
+
+	while (true)
+	{
+		_SaveCondition.wait(lock, [this]() { return _ShouldStopSaving || !_PendingSaves.empty(); });
+
+		if (_PendingSaves.empty())
+			return;
+
+		PendingSave pendingSave = std::move(_PendingSaves.front());
+		_PendingSaves.erase(_PendingSaves.begin());
+
+		lock.unlock();
+		FinishedSave finishedSave = pendingSave.ChartPath.empty() ? SaveSnapshot(pendingSave.Path, pendingSave.Snapshot) : ExportMapsetArchive(pendingSave.Path, pendingSave.ChartPath, pendingSave.Snapshot);
+		lock.lock();
+
+		finishedSave.Index = pendingSave.Index;
+		_FinishedSaves.push_back(std::move(finishedSave));
+	}
+}
+
+ChartParserModule::FinishedSave ChartParserModule::SaveSnapshot(const std::filesystem::path& InPath, const ChartSnapshot& InSnapshot)
+{
+	const auto timeBegin = std::chrono::steady_clock::now();
+
+	std::filesystem::path stepmaniaPath;
+	size_t chartIndex = 0;
+
+	const bool isStepmaniaChart = SplitStepmaniaPath(InPath, stepmaniaPath, chartIndex);
+
+	std::string chartBuffer;
+	bool isExportable = true;
+
+	if (isStepmaniaChart || IsStepmaniaFile(InPath))
+		ExportChartStepmaniaImpl(InSnapshot, chartBuffer);
+	else if (InPath.extension() == ".qua")
+		isExportable = ExportChartQuaverImpl(InSnapshot, chartBuffer);
+	else
+		ExportChartOsuImpl(InSnapshot, chartBuffer);
+
+	FinishedSave finishedSave;
+	finishedSave.Path = InPath;
+	finishedSave.Bytes = chartBuffer.size();
+
+	//the file on disk is left as it is rather than replaced with one that can't be opened anymore
+	if (!isExportable)
+	{
+		finishedSave.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeBegin).count();
+		return finishedSave;
+	}
+
+	std::filesystem::path archivePath;
+	std::string entryName;
+
+	{
+		//both threads write through the same temporary file, so only one of them may write at a time
+		std::lock_guard<std::mutex> lock(_WriteMutex);
+
+		//the chart replaces its part of the stepmania file, the other charts of it are read back from the file as they are now
+		if (isStepmaniaChart)
+		{
+			std::string stepmaniaBuffer;
+			MappedFile stepmaniaFile;
+
+			finishedSave.HasSucceeded = stepmaniaFile.Open(stepmaniaPath) && SpliceStepmaniaChart(stepmaniaFile.GetView(), stepmaniaPath.extension() == ".ssc", chartIndex, chartBuffer, stepmaniaBuffer);
+
+			//windows can't rename over a file that is still mapped
+			stepmaniaFile.Close();
+
+			finishedSave.HasSucceeded = finishedSave.HasSucceeded && WriteFileAtomically(stepmaniaPath, stepmaniaBuffer);
+			finishedSave.Bytes = stepmaniaBuffer.size();
+		}
+		//a chart inside an archive gets saved by rewriting the archive, the other entries are copied over without recompressing them
+		else if (SplitArchivePath(InPath, archivePath, entryName))
+			finishedSave.HasSucceeded = ReplaceArchiveEntry(archivePath, entryName, chartBuffer);
+		else
+			finishedSave.HasSucceeded = WriteFileAtomically(InPath, chartBuffer);
+	}
+
+	finishedSave.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeBegin).count();
+
+	return finishedSave;
+}
+
+ChartParserModule::FinishedSave ChartParserModule::ExportMapsetArchive(const std::filesystem::path& InArchivePath, const std::filesystem::path& InChartPath, const ChartSnapshot& InSnapshot)
+{
+	const auto timeBegin = std::chrono::steady_clock::now();
+
+	std::string chartBuffer;
+	ExportChartOsuImpl(InSnapshot, chartBuffer);
+
+	FinishedSave finishedSave;
+	finishedSave.Path = InArchivePath;
+
+	std::filesystem::path sourceArchivePath;
+	std::string chartEntryName;
+
+	std::filesystem::path stepmaniaPath;
+	size_t chartIndex = 0;
+
+	//exporting over the archive the chart is in shares its temporary file with the saves
+	std::lock_guard<std::mutex> lock(_WriteMutex);
+
+	ArchiveWriter archiveWriter;
+	bool hasSucceeded = archiveWriter.Open(InArchivePath);
+
+	if (SplitArchivePath(InChartPath, sourceArchivePath, chartEntryName))
+	{
+		ArchiveReader archiveReader;
+		hasSucceeded = hasSucceeded && archiveReader.Open(sourceArchivePath);
+
+		for (const std::string& entryName : archiveReader.GetEntryNames())
+		{
+			if (hasSucceeded && entryName != chartEntryName)
+				hasSucceeded = archiveWriter.CopyEntry(archiveReader, entryName);
+		}
+	}
+	else
+	{
+		std::filesystem::path folderPath = InChartPath.parent_path();
+		chartEntryName = InChartPath.filename().u8string();
+
+		//an archive only holds osu charts, a stepmania chart goes in as one named after its difficulty
+		if (SplitStepmaniaPath(InChartPath, stepmaniaPath, chartIndex))
+		{
+			folderPath = stepmaniaPath.parent_path();
+			chartEntryName = stepmaniaPath.stem().u8string() + " [" + InSnapshot.DifficultyName + "].osu";
+		}
+		else if (InChartPath.extension() != ".osu")
+			chartEntryName = InChartPath.stem().u8string() + ".osu";
+
+		std::error_code errorCode;
+
+		for (const auto& directoryEntry : std::filesystem::directory_iterator(folderPath, errorCode))
+		{
+			const std::filesystem::path& filePath = directoryEntry.path();
+			const std::filesystem::path extension = filePath.extension();
+
+			//the journals and half written files of the editor, as well as other archives, don't belong into a release
+			if (!directoryEntry.is_regular_file(errorCode) || filePath.filename() == InChartPath.filename() || filePath.filename().u8string() == chartEntryName || extension == ".journal" || extension == ".tmp" || extension == ".osz")
+				continue;
+
+			hasSucceeded = hasSucceeded && archiveWriter.AddFile(filePath.filename().u8string(), filePath);
+		}
+	}
+
+	hasSucceeded = hasSucceeded && archiveWriter.AddEntry(chartEntryName, chartBuffer);
+	hasSucceeded = hasSucceeded && archiveWriter.Commit();
+
+	std::error_code errorCode;
+
+	finishedSave.HasSucceeded = hasSucceeded;
+	finishedSave.Bytes = hasSucceeded ? size_t(std::filesystem::file_size(InArchivePath, errorCode)) : 0;
+	finishedSave.Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeBegin).count();
+
+	return finishedSave;
+}
+
+void ChartParserModule::ExportChartOsuImpl(const ChartSnapshot& InSnapshot, std::string& OutBuffer)
+{	
+	std::string backgroundFileName = InSnapshot.BackgroundPath.filename().string();
+	std::string audioFileName = InSnapshot.AudioPath.filename().string();
+
+	//the fixed part is about a kilobyte, a timing point line stays below 64 characters and a hit object line below 48
+	OutBuffer.clear();
+	OutBuffer.reserve(2048
+					+ backgroundFileName.size() + audioFileName.size()
+					+ InSnapshot.SongTitle.size() + InSnapshot.SongtitleUnicode.size() + InSnapshot.Artist.size() + InSnapshot.ArtistUnicode.size()
+					+ InSnapshot.Charter.size() + InSnapshot.DifficultyName.size() + InSnapshot.Source.size() + InSnapshot.Tags.size()
+					+ InSnapshot.BeatmapID.size() + InSnapshot.BeatmapSetID.size()
+					+ (InSnapshot.BpmPoints.size() + InSnapshot.ScrollVelocities.size()) * 64
+					+ InSnapshot.Notes.size() * 48);
+
+	AppendText(OutBuffer, "osu file format v14\n"
+						  "\n"
+						  "[General]\n"
+						  "AudioFilename: ");
+	AppendText(OutBuffer, audioFileName);
+	AppendText(OutBuffer, "\n"
+						  "AudioLeadIn: 0\n"
+						  "PreviewTime: 0\n"
+						  "Countdown: 0\n"
+						  "SampleSet: Soft\n"
+						  "StackLeniency: 0.7\n"
+						  "Mode: 3\n"
+						  "LetterboxInBreaks: 0\n"
+						  "SpecialStyle: 0\n"
+						  "WidescreenStoryboard: 0\n"
+						  "\n"
+						  "[Editor]\n"
+						  "DistanceSpacing: 1\n"
+						  "BeatDivisor: 4\n"
+						  "GridSize: 16\n"
+						  "TimelineZoom: 1\n"
+						  "\n"
+						  "[Metadata]\n");
+
+	const std::pair<std::string_view, const std::string&> metadata[] =
+	{
+		{ "Title:", InSnapshot.SongTitle },
+		{ "TitleUnicode:", InSnapshot.SongtitleUnicode },
+		{ "Artist:", InSnapshot.Artist },
+		{ "ArtistUnicode:", InSnapshot.ArtistUnicode },
+		{ "Creator:", InSnapshot.Charter },
+		{ "Version:", InSnapshot.DifficultyName },
+		{ "Source:", InSnapshot.Source },
+		{ "Tags:", InSnapshot.Tags },
+		{ "BeatmapID:", InSnapshot.BeatmapID },
+		{ "BeatmapSetID:", InSnapshot.BeatmapSetID },
+	};
+
+	for (const auto& [key, value] : metadata)
+	{
+		AppendText(OutBuffer, key);
+		AppendText(OutBuffer, value);
+		AppendText(OutBuffer, "\n");
+	}
+
+	AppendText(OutBuffer, "\n"
+						  "[Difficulty]\n"
+						  "HPDrainRate:");
+	AppendNumber(OutBuffer, InSnapshot.HP);
+	AppendText(OutBuffer, "\nCircleSize:");
+	AppendNumber(OutBuffer, InSnapshot.KeyAmount);
+	AppendText(OutBuffer, "\nOverallDifficulty:");
+	AppendNumber(OutBuffer, InSnapshot.OD);
+	AppendText(OutBuffer, "\n"
+						  "ApproachRate:9\n"
+						  "SliderMultiplier:1.4\n"
+						  "SliderTickRate:1\n"
+						  "\n"
+						  "[Events]\n"
+						  "//Background and Video events\n");
+
+	if (backgroundFileName != "")
+	{
+		AppendText(OutBuffer, "0,0,\"");
+		AppendText(OutBuffer, backgroundFileName);
+		AppendText(OutBuffer, "\",0,0\n");
+	}
+
+	AppendText(OutBuffer, "//Break Periods\n"
+						  "//Storyboard Layer 0 (Background)\n"
+						  "//Storyboard Layer 1 (Fail)\n"
+						  "//Storyboard Layer 2 (Pass)\n"
+						  "//Storyboard Layer 3 (Foreground)\n"
+						  "//Storyboard Layer 4 (Overlay)\n"
+						  "//Storyboard Sound Samples\n"
+						  "\n"
+						  "[TimingPoints]\n");
+
+	//both kinds merged in time order, on the same time point the bpm point has to come first for the scroll velocity to apply
+	auto scrollVelocityIt = InSnapshot.ScrollVelocities.begin();
+
+	auto appendScrollVelocitiesBefore = [&OutBuffer, &scrollVelocityIt, &InSnapshot](const double InTime)
+	{
+		for (; scrollVelocityIt != InSnapshot.ScrollVelocities.end() && scrollVelocityIt->TimePoint < InTime; ++scrollVelocityIt)
+		{
+			const double beatLength = scrollVelocityIt->BeatLength < 0.0 ? scrollVelocityIt->BeatLength : -100.0 / std::max(scrollVelocityIt->Multiplier, OSU_MIN_MULTIPLIER);
+
+			AppendNumber(OutBuffer, scrollVelocityIt->TimePoint);
+			AppendText(OutBuffer, ",");
+			AppendNumber(OutBuffer, beatLength);
+			AppendText(OutBuffer, ",");
+			AppendNumber(OutBuffer, scrollVelocityIt->Meter);
+			AppendText(OutBuffer, ",");
+			AppendNumber(OutBuffer, scrollVelocityIt->SampleSet);
+			AppendText(OutBuffer, ",");
+			AppendNumber(OutBuffer, scrollVelocityIt->SampleIndex);
+			AppendText(OutBuffer, ",");
+			AppendNumber(OutBuffer, scrollVelocityIt->Volume);
+			AppendText(OutBuffer, ",0,");
+			AppendNumber(OutBuffer, scrollVelocityIt->Effects);
+			AppendText(OutBuffer, "\n");
+		}
+	};
+	
+	for (const BpmPoint& bpmPoint : InSnapshot.BpmPoints)
+	{
+		appendScrollVelocitiesBefore(bpmPoint.TimePoint);
+
+		AppendNumber(OutBuffer, bpmPoint.TimePoint);
+		AppendText(OutBuffer, ",");
+		AppendNumber(OutBuffer, bpmPoint.BeatLength);
+		AppendText(OutBuffer, ",4,0,0,10,1,0\n");
+	}
+
+	appendScrollVelocitiesBefore(std::numeric_limits<double>::infinity());
+
+	// leaving the "4" there since we will want to set custom snap divisor
+	
+	AppendText(OutBuffer, "\n"
+						  "\n"
+						  "[HitObjects]\n");
+
+	int keyAmount = InSnapshot.KeyAmount;
+	for (const auto& [noteColumn, note] : InSnapshot.Notes)
+	{
+		int column = float(float((noteColumn + 1)) * 512.f) / float(keyAmount) - (512.f / float(keyAmount) / 2.f);
+
+		switch (note.Type)
+		{
+		case Note::EType::Common:
+			AppendNumber(OutBuffer, column);
+			AppendText(OutBuffer, ",192,");
+			AppendNumber(OutBuffer, note.TimePoint);
+			AppendText(OutBuffer, ",1,0,0:0:0:0:\n");
+			break;
+		
+		case Note::EType::HoldBegin:
+			AppendNumber(OutBuffer, column);
+			AppendText(OutBuffer, ",192,");
+			AppendNumber(OutBuffer, note.TimePoint);
+			AppendText(OutBuffer, ",128,0,");
+			AppendNumber(OutBuffer, note.TimePointEnd);
+			AppendText(OutBuffer, ":0:0:0:0:\n");
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+void ChartParserModule::ExportChartStepmaniaImpl(const ChartSnapshot& InSnapshot, std::string& OutBuffer)
+{
+	const std::string backgroundFileName = InSnapshot.BackgroundPath.filename().u8string();
+	const std::string audioFileName = InSnapshot.AudioPath.filename().u8string();
+
+	//beat zero is the first bpm point, moved back by whole measures while there are notes before it since rows can't go before the first measure
+	BpmPoint firstBpmPoint = InSnapshot.BpmPoints.empty() ? BpmPoint{ 0, 500.0, 120.0 } : InSnapshot.BpmPoints.front();
+
+	Time earliestTime = firstBpmPoint.TimePoint;
+	for (const auto& [column, note] : InSnapshot.Notes)
+		earliestTime = std::min(earliestTime, note.TimePoint);
+
+	const double measureLength = 4.0 * firstBpmPoint.BeatLength;
+	const double beatZeroTime = firstBpmPoint.TimePoint - std::ceil((firstBpmPoint.TimePoint - earliestTime) / measureLength) * measureLength;
+
+	/*
+	* stepmania changes the tempo on rows only, a bpm point between two rows changes it on the row before and waits out the rest of the gap as a stop.
+	* that is the inverse of what the parser does with stops, so a chart from a stepmania file keeps its stops.
+	*/
+	std::vector<StepmaniaTempoSegment> tempoMap = { { 0.0, beatZeroTime, firstBpmPoint.BeatLength } };
+	std::vector<std::pair<double, double>> stops;
+
+	for (size_t index = 1; index < InSnapshot.BpmPoints.size(); ++index)
+	{
+		const BpmPoint& bpmPoint = InSnapshot.BpmPoints[index];
+		StepmaniaTempoSegment& previousSegment = tempoMap.back();
+
+		const double gap = double(bpmPoint.TimePoint) - previousSegment.TimePoint;
+		double rows = std::round(gap / previousSegment.BeatLength * STEPMANIA_ROWS_PER_BEAT);
+		double stopLength = gap - rows * previousSegment.BeatLength / STEPMANIA_ROWS_PER_BEAT;
+
+		if (std::abs(stopLength) <= STEPMANIA_STOP_TOLERANCE)
+			stopLength = 0.0;
+		else
+		{
+			rows = std::floor(gap / previousSegment.BeatLength * STEPMANIA_ROWS_PER_BEAT);
+			stopLength = gap - rows * previousSegment.BeatLength / STEPMANIA_ROWS_PER_BEAT;
+		}
+
+		const double beat = previousSegment.Beat + rows / STEPMANIA_ROWS_PER_BEAT;
+
+		if (stopLength > 0.0 && !stops.empty() && stops.back().first == beat)
+			stops.back().second += stopLength;
+		else if (stopLength > 0.0)
+			stops.push_back({ beat, stopLength });
+
+		//bpm points closer together than a row end up on the same one, only the last of them is kept
+		if (rows <= 0.0)
+			previousSegment = { beat, double(bpmPoint.TimePoint), bpmPoint.BeatLength };
+		else
+			tempoMap.push_back({ beat, double(bpmPoint.TimePoint), bpmPoint.BeatLength });
+	}
+
+	//a note on the beat of a stop is before the stop, so it belongs to the segment before the one starting after the stop
+	auto getRow = [&tempoMap](const Time InTime)
+	{
+		auto segmentIt = std::upper_bound(tempoMap.begin(), tempoMap.end(), double(InTime), [](const double InTimePoint, const StepmaniaTempoSegment& InSegment) { return InTimePoint < InSegment.TimePoint; });
+
+		if (segmentIt != tempoMap.begin())
+			--segmentIt;
+
+		return std::max(0ll, std::llround((segmentIt->Beat + (double(InTime) - segmentIt->TimePoint) / segmentIt->BeatLength) * STEPMANIA_ROWS_PER_BEAT));
+	};
+
+	//one entry per arrow of a row, ordered by row
+	std::vector<std::tuple<long long, Column, char>> arrows;
+	arrows.reserve(InSnapshot.Notes.size() * 2);
+
+	for (const auto& [column, note] : InSnapshot.Notes)
+	{
+		if (note.Type == Note::EType::Common)
+			arrows.push_back({ getRow(note.TimePoint), column, '1' });
+		else if (note.Type == Note::EType::HoldBegin)
+		{
+			arrows.push_back({ getRow(note.TimePointBegin), column, '2' });
+			arrows.push_back({ getRow(note.TimePointEnd), column, '3' });
+		}
+	}
+
+	std::sort(arrows.begin(), arrows.end());
+
+	const int keyAmount = std::max(InSnapshot.KeyAmount, 1);
+	const long long measureAmount = arrows.empty() ? 1 : std::get<0>(arrows.back()) / STEPMANIA_ROWS_PER_MEASURE + 1;
+
+	//stepmania only knows a few step types, any other key amount is still read back by its row width
+	static const std::pair<int, std::string_view> stepsTypes[] =
+	{
+		{ 3, "dance-threepanel" }, { 4, "dance-single" }, { 5, "pump-single" }, { 6, "dance-solo" },
+		{ 7, "kb7-single" }, { 8, "dance-double" }, { 9, "pnm-nine" }, { 10, "pump-double" },
+	};
+
+	std::string_view stepsType = "dance-single";
+	for (const auto& [stepsTypeKeyAmount, stepsTypeName] : stepsTypes)
+	{
+		if (stepsTypeKeyAmount == keyAmount)
+			stepsType = stepsTypeName;
+	}
+
+	//any difficulty stepmania doesn't know becomes an edit, which is named by its description
+	const std::string_view difficulties[] = { "Beginner", "Easy", "Medium", "Hard", "Challenge", "Edit" };
+	const bool isKnownDifficulty = std::find(std::begin(difficulties), std::end(difficulties), InSnapshot.DifficultyName) != std::end(difficulties);
+
+	//a measure with only quarter notes is four rows, the densest one is a row for every 192nd
+	OutBuffer.clear();
+	OutBuffer.reserve(1024
+					+ backgroundFileName.size() + audioFileName.size()
+					+ InSnapshot.SongTitle.size() + InSnapshot.SongtitleUnicode.size() + InSnapshot.Artist.size() + InSnapshot.ArtistUnicode.size()
+					+ InSnapshot.Charter.size() * 2 + InSnapshot.DifficultyName.size()
+					+ (tempoMap.size() + stops.size()) * 48
+					+ size_t(measureAmount) * 4 * (keyAmount + 1)
+					+ arrows.size() * 4 * (keyAmount + 1));
+
+	const std::pair<std::string_view, std::string_view> metadata[] =
+	{
+		{ "#TITLE:", InSnapshot.SongtitleUnicode.empty() ? InSnapshot.SongTitle : InSnapshot.SongtitleUnicode },
+		{ "#TITLETRANSLIT:", InSnapshot.SongTitle },
+		{ "#ARTIST:", InSnapshot.ArtistUnicode.empty() ? InSnapshot.Artist : InSnapshot.ArtistUnicode },
+		{ "#ARTISTTRANSLIT:", InSnapshot.Artist },
+		{ "#CREDIT:", InSnapshot.Charter },
+		{ "#MUSIC:", audioFileName },
+		{ "#BACKGROUND:", backgroundFileName },
+	};
+
+	for (const auto& [key, value] : metadata)
+	{
+		AppendText(OutBuffer, key);
+		AppendText(OutBuffer, value);
+		AppendText(OutBuffer, ";\n");
+	}
+
+	AppendText(OutBuffer, "#OFFSET:");
+	AppendNumber(OutBuffer, 0.0 - beatZeroTime / 1000.0);
+	AppendText(OutBuffer, ";\n#BPMS:");
+
+	for (size_t index = 0; index < tempoMap.size(); ++index)
+	{
+		AppendText(OutBuffer, index ? ",\n" : "");
+		AppendNumber(OutBuffer, tempoMap[index].Beat);
+		AppendText(OutBuffer, "=");
+		AppendNumber(OutBuffer, 60000.0 / tempoMap[index].BeatLength);
+	}
+
+	AppendText(OutBuffer, ";\n#STOPS:");
+
+	for (size_t index = 0; index < stops.size(); ++index)
+	{
+		AppendText(OutBuffer, index ? ",\n" : "");
+		AppendNumber(OutBuffer, stops[index].first);
+		AppendText(OutBuffer, "=");
+		AppendNumber(OutBuffer, stops[index].second / 1000.0);
+	}
+
+	AppendText(OutBuffer, ";\n\n#NOTES:\n     ");
+	AppendText(OutBuffer, stepsType);
+	AppendText(OutBuffer, ":\n     ");
+	AppendText(OutBuffer, isKnownDifficulty ? InSnapshot.Charter : InSnapshot.DifficultyName);
+	AppendText(OutBuffer, ":\n     ");
+	AppendText(OutBuffer, isKnownDifficulty ? InSnapshot.DifficultyName : "Edit");
+	AppendText(OutBuffer, ":\n     1:\n     0,0,0,0,0:\n");
+
+	size_t arrowIndex = 0;
+
+	for (long long measure = 0; measure < measureAmount; ++measure)
+	{
+		const long long measureBegin = measure * STEPMANIA_ROWS_PER_MEASURE;
+
+		size_t measureArrowEnd = arrowIndex;
+		while (measureArrowEnd < arrows.size() && std::get<0>(arrows[measureArrowEnd]) < measureBegin + STEPMANIA_ROWS_PER_MEASURE)
+			measureArrowEnd++;
+
+		//the coarsest row spacing that still has a row for every arrow of the measure
+		long long rowSpacing = STEPMANIA_ROWS_PER_BEAT;
+		for (size_t index = arrowIndex; index < measureArrowEnd; ++index)
+			rowSpacing = std::gcd(rowSpacing, std::get<0>(arrows[index]) - measureBegin);
+
+		for (long long row = measureBegin; row < measureBegin + STEPMANIA_ROWS_PER_MEASURE; row += rowSpacing)
+		{
+			const size_t rowBegin = OutBuffer.size();
+			OutBuffer.append(size_t(keyAmount), '0');
+
+			for (; arrowIndex < measureArrowEnd && std::get<0>(arrows[arrowIndex]) == row; ++arrowIndex)
+			{
+				const auto& [arrowRow, column, arrow] = arrows[arrowIndex];
+
+				if (column < Column(keyAmount))
+					OutBuffer[rowBegin + column] = arrow;
+			}
+
+			AppendText(OutBuffer, "\n");
+		}
+
+		AppendText(OutBuffer, measure + 1 < measureAmount ? ",\n" : ";\n");
+	}
+}
+
+//single quoted, so no title or tag can break the yaml
+static void AppendYamlText(std::string& OutBuffer, const std::string_view InText)
+{
+	AppendText(OutBuffer, "'");
+
+	for (const char character : InText)
+		AppendText(OutBuffer, character == '\'' ? std::string_view("''") : std::string_view(&character, 1));
+
+	AppendText(OutBuffer, "'");
+}
+
+bool ChartParserModule::ExportChartQuaverImpl(const ChartSnapshot& InSnapshot, std::string& OutBuffer)
+{
+	const std::string backgroundFileName = InSnapshot.BackgroundPath.filename().u8string();
+	const std::string audioFileName = InSnapshot.AudioPath.filename().u8string();
+
+	//quaver has 4 and 7 keys, either one with a scratch lane. a 5 or 8 key chart without one has no mode there
+	const bool hasScratchKey = InSnapshot.HasScratchKey;
+	const int keyAmount = InSnapshot.KeyAmount - (hasScratchKey ? 1 : 0);
+
+	OutBuffer.clear();
+
+	if (keyAmount != 4 && keyAmount != 7)
+		return false;
+
+	//the fixed part is about half a kilobyte, a timing point or scroll velocity stays below 64 characters and a hit object below 80
+	OutBuffer.reserve(1024
+					+ backgroundFileName.size() + audioFileName.size()
+					+ InSnapshot.SongtitleUnicode.size() + InSnapshot.SongTitle.size() + InSnapshot.ArtistUnicode.size() + InSnapshot.Artist.size()
+					+ InSnapshot.Charter.size() + InSnapshot.DifficultyName.size() + InSnapshot.Source.size() + InSnapshot.Tags.size()
+					+ (InSnapshot.BpmPoints.size() + InSnapshot.ScrollVelocities.size()) * 64
+					+ InSnapshot.Notes.size() * 80);
+
+	AppendText(OutBuffer, "AudioFile: ");
+	AppendYamlText(OutBuffer, audioFileName);
+	AppendText(OutBuffer, "\nSongPreviewTime: 0\nBackgroundFile: ");
+	AppendYamlText(OutBuffer, backgroundFileName);
+	AppendText(OutBuffer, "\nMapId: ");
+	AppendText(OutBuffer, InSnapshot.BeatmapID.empty() ? "-1" : InSnapshot.BeatmapID);
+	AppendText(OutBuffer, "\nMapSetId: ");
+	AppendText(OutBuffer, InSnapshot.BeatmapSetID.empty() ? "-1" : InSnapshot.BeatmapSetID);
+	AppendText(OutBuffer, "\nMode: Keys");
+	AppendNumber(OutBuffer, keyAmount);
+	AppendText(OutBuffer, "\n");
+
+	const std::pair<std::string_view, std::string_view> metadata[] =
+	{
+		{ "Title: ", InSnapshot.SongtitleUnicode.empty() ? InSnapshot.SongTitle : InSnapshot.SongtitleUnicode },
+		{ "Artist: ", InSnapshot.ArtistUnicode.empty() ? InSnapshot.Artist : InSnapshot.ArtistUnicode },
+		{ "Source: ", InSnapshot.Source },
+		{ "Tags: ", InSnapshot.Tags },
+		{ "Creator: ", InSnapshot.Charter },
+		{ "DifficultyName: ", InSnapshot.DifficultyName },
+		{ "Description: ", "" },
+	};
+
+	for (const auto& [key, value] : metadata)
+	{
+		AppendText(OutBuffer, key);
+		AppendYamlText(OutBuffer, value);
+		AppendText(OutBuffer, "\n");
+	}
+
+	AppendText(OutBuffer, "BPMDoesNotAffectScrollVelocity: true\n"
+						  "InitialScrollVelocity: 1\n"
+						  "HasScratchKey: ");
+	AppendText(OutBuffer, hasScratchKey ? "true" : "false");
+	AppendText(OutBuffer, "\n"
+						  "EditorLayers: []\n"
+						  "CustomAudioSamples: []\n"
+						  "SoundEffects: []\n"
+						  "TimingPoints:\n");
+
+	for (const BpmPoint& bpmPoint : InSnapshot.BpmPoints)
+	{
+		AppendText(OutBuffer, "- StartTime: ");
+		AppendNumber(OutBuffer, bpmPoint.TimePoint);
+		AppendText(OutBuffer, "\n  Bpm: ");
+		AppendNumber(OutBuffer, 60000.0 / bpmPoint.BeatLength);
+		AppendText(OutBuffer, "\n");
+	}
+
+	AppendText(OutBuffer, "SliderVelocities:");
+
+	if (InSnapshot.ScrollVelocities.empty())
+		AppendText(OutBuffer, " []");
+
+	AppendText(OutBuffer, "\n");
+
+	for (const ScrollVelocityMultiplier& scrollVelocity : InSnapshot.ScrollVelocities)
+	{
+		AppendText(OutBuffer, "- StartTime: ");
+		AppendNumber(OutBuffer, scrollVelocity.TimePoint);
+		AppendText(OutBuffer, "\n  Multiplier: ");
+		AppendNumber(OutBuffer, scrollVelocity.Multiplier);
+		AppendText(OutBuffer, "\n");
+	}
+
+	AppendText(OutBuffer, "HitObjects:");
+
+	if (InSnapshot.Notes.empty())
+		AppendText(OutBuffer, " []");
+
+	AppendText(OutBuffer, "\n");
+
+	for (const auto& [column, note] : InSnapshot.Notes)
+	{
+		if (note.Type != Note::EType::Common && note.Type != Note::EType::HoldBegin)
+			continue;
+
+		AppendText(OutBuffer, "- StartTime: ");
+		AppendNumber(OutBuffer, note.TimePoint);
+		AppendText(OutBuffer, "\n  Lane: ");
+		AppendNumber(OutBuffer, column + 1);
+
+		if (note.Type == Note::EType::HoldBegin)
+		{
+			AppendText(OutBuffer, "\n  EndTime: ");
+			AppendNumber(OutBuffer, note.TimePointEnd);
+		}
+
+		AppendText(OutBuffer, "\n  KeySounds: []\n");
+	}
+
+	return true;
 }
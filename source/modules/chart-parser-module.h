@@ -2,10 +2,18 @@
 
 #include "base/module.h"
 
-#include <fstream>
 #include <filesystem>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "../structures/chart-metadata.h"
+#include "../structures/chart-set.h"
 
 
 /*
@@ -14,24 +22,101 @@
 class ChartParserModule : public Module
 {
 public:
+
+	bool Tick(const float& InDeltaTime) override;
+	bool ShutDown() override;
 	
 	Chart* ParseAndGenerateChartSet(const std::filesystem::path& InPath);
-	void ExportChartSet(Chart* InChart);
+	//saves on the calling thread, true once the file has been written
+	bool ExportChartSet(Chart* InChart);
+
+	//parses every difficulty in the folder or archive of the given chart at once, one per worker thread, the ones that fail to parse are left out
+	std::vector<ChartSetEntry> ParseAndGenerateChartSetFolder(const std::filesystem::path& InPath);
+	//makes the entry the one that gets saved, cached and described by the metadata
+	void SetCurrentChart(const ChartSetEntry& InEntry);
+
+	//a chart from the cache comes with its beat snaps already assigned
+	bool IsCurrentChartFromCache() const;
+	void StoreChartCache(Chart* InChart);
+
+	//snapshots the chart and saves it on the saving thread, a newer save of the same file replaces one that hasn't started yet.
+	//the returned index comes back with the finished save, a replaced save never finishes
+	size_t ExportChartSetInBackground(Chart* InChart);
+	//packs the mapset of the chart into an .osz on the saving thread, with the chart as it is now instead of its file
+	void ExportMapsetArchiveInBackground(Chart* InChart, const std::filesystem::path& InArchivePath);
 	
 	void SetCurrentChartPath(const std::filesystem::path& InPath);
 
+	//called from Tick for every save the saving thread has finished, and once more on shut down for the ones finished while stopping
+	void RegisterOnSaveFinishedCallback(std::function<void(const size_t InSaveIndex, const bool InHasSucceeded)> InCallback);
+
 	ChartMetadata GetChartMetadata(Chart* InChart);
 
+	//for batch work without the editor, both run on the calling thread and push no notifications
+	std::vector<ChartSetEntry> LoadChartFile(const std::filesystem::path& InPath);
+	bool SaveChartFile(const std::filesystem::path& InPath, const ChartSnapshot& InSnapshot);
+
 	//this is for now osu impl only, in the future I'll make some template magic for which format is present
-	std::string SetChartMetadata(Chart* Outchart, const ChartMetadata& InMetadata);
+	std::string SetChartMetadata(Chart* Outchart, const ChartMetadata& InMetadata, bool* OutHasSaved = nullptr);
 	std::string CreateNewChart(const ChartMetadata& InNewChartData);
 private:
 
+	struct PendingSave
+	{
+		size_t Index = 0;
+		std::filesystem::path Path;
+		ChartSnapshot Snapshot;
+
+		//only set for a mapset export, the path is then the archive and the snapshot replaces this chart in it
+		std::filesystem::path ChartPath;
+	};
+
+	struct FinishedSave
+	{
+		size_t Index = 0;
+		std::filesystem::path Path;
+		size_t Bytes = 0;
+		double Milliseconds = 0.0;
+		bool HasSucceeded = false;
+	};
+
 	std::filesystem::path _CurrentChartPath;
+	ChartSource _CurrentChartSource;
+	bool _IsCurrentChartFromCache = false;
+
+	std::thread _SaveThread;
+	std::mutex _SaveMutex;
+	std::mutex _WriteMutex;
+	std::condition_variable _SaveCondition;
+	std::vector<PendingSave> _PendingSaves;
+	std::vector<FinishedSave> _FinishedSaves;
+	bool _ShouldStopSaving = false;
+
+	//only counted on the ui thread
+	size_t _SaveAmount = 0;
+	std::function<void(const size_t, const bool)> _OnSaveFinished;
+
+	void ReportFinishedSaves();
+
+	void RunSaveThread();
+	FinishedSave SaveSnapshot(const std::filesystem::path& InPath, const ChartSnapshot& InSnapshot);
+	FinishedSave ExportMapsetArchive(const std::filesystem::path& InArchivePath, const std::filesystem::path& InChartPath, const ChartSnapshot& InSnapshot);
+
+	//only touches the entry, so several of them can be loaded at the same time
+	bool LoadChartSetEntry(ChartSetEntry& OutEntry);
+	//one entry per chart of the file, addressed as "song.sm/<index of the chart>"
+	bool LoadStepmaniaChartSet(const std::filesystem::path& InPath, std::vector<ChartSetEntry>& OutEntries);
+
+	Chart* ParseChartCacheImpl(std::string_view InContent, const std::filesystem::path& InPath, const ChartSource& InSource);
+	void ExportChartCacheImpl(Chart* InChart, std::string& OutBuffer);
 
-	Chart* ParseChartOsuImpl(std::ifstream& InIfstream, std::filesystem::path InPath);
-	Chart* ParseChartStepmaniaImpl(std::ifstream& InIfstream, std::filesystem::path InPath);
+	Chart* ParseChartOsuImpl(std::string_view InContent, std::filesystem::path InPath);
+	Chart* ParseChartQuaverImpl(std::string_view InContent, std::filesystem::path InPath);
+	//every chart of the file in one pass, a chart that can't be read leaves a nullptr at its index
+	void ParseChartStepmaniaImpl(std::string_view InContent, const std::filesystem::path& InPath, std::vector<Chart*>& OutCharts);
 
-	void ExportChartOsuImpl(Chart* InChart, std::ofstream& InOfStream);
-	void ExportChartStepmaniaImpl(Chart* InChart, std::ofstream& InOfStream);
+	void ExportChartOsuImpl(const ChartSnapshot& InSnapshot, std::string& OutBuffer);
+	//false for a key amount quaver has no mode for, nothing is written then
+	bool ExportChartQuaverImpl(const ChartSnapshot& InSnapshot, std::string& OutBuffer);
+	void ExportChartStepmaniaImpl(const ChartSnapshot& InSnapshot, std::string& OutBuffer);
 };
\ No newline at end of file
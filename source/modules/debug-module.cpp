@@ -7,9 +7,17 @@ void DebugModule::RenderTimeSliceBoundaries(TimefieldRenderGraph& OutRenderGraph
     if(!ShowTimeSliceBoundaries)
         return;
 
-	InSelectedChart->IterateTimeSlicesInTimeRange(InTimeBegin, InTimeEnd, [&OutRenderGraph, this](TimeSlice InTimeSlice)
+    const Time timeSliceLength = InSelectedChart->GetTimeSliceLength();
+
+    //the boundaries are the multiples of the slice length, starting at the last one before the window
+    Time firstTimePoint = InTimeBegin / timeSliceLength * timeSliceLength;
+
+    if(firstTimePoint > InTimeBegin)
+        firstTimePoint -= timeSliceLength;
+
+	for(Time timePoint = firstTimePoint; timePoint <= InTimeEnd; timePoint += timeSliceLength)
 	{
-        OutRenderGraph.SubmitTimefieldRenderCommand(0, InTimeSlice.TimePoint, [InTimeSlice, this](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
+        OutRenderGraph.SubmitTimefieldRenderCommand(0, timePoint, [timePoint, this](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
         {
 		    const auto& timeFieldMetrics = InTimefieldMetrics;
 
@@ -27,10 +35,10 @@ void DebugModule::RenderTimeSliceBoundaries(TimefieldRenderGraph& OutRenderGraph
 
 		    ImGui::SetNextWindowPos({line.getPosition().x + timeFieldMetrics.FieldWidth + 6.f, line.getPosition().y});
 
-		    ImGui::Begin(std::to_string(InTimeSlice.TimePoint).c_str(), &ShowTimeSliceBoundaries, flags);			
-		    ImGui::Text(std::to_string(InTimeSlice.TimePoint).c_str());
+		    ImGui::Begin(std::to_string(timePoint).c_str(), &ShowTimeSliceBoundaries, flags);			
+		    ImGui::Text(std::to_string(timePoint).c_str());
 		    ImGui::End();
         });
-	});
+	}
 	
 }
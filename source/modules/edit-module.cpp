@@ -57,6 +57,9 @@ void EditModule::SubmitToRenderGraph(TimefieldRenderGraph& InOutTimefieldRenderG
 
 void EditModule::SetChart(Chart* const InOutChart)
 {
+	//the selection refers to the notes of the previous chart
+	_EditModes[_SelectedEditMode]->OnReset();
+
 	EditMode::SetChart(InOutChart);
 }
 
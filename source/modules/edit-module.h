@@ -7,6 +7,7 @@
 #include "../editing/note-edit-mode.h"
 #include "../editing/select-edit-mode.h"
 #include "../editing/bpm-edit-mode.h"
+#include "../editing/scroll-velocity-edit-mode.h"
 
 /*
 * special edit-mode actions cannot be directly called by the program, but must be interfaced through the edit module.
@@ -58,5 +59,5 @@ private:
 
 	size_t _SelectedEditMode = 0;
 
-	EditModeCollection<SelectEditMode, NoteEditMode, BpmEditMode> _EditModes;
+	EditModeCollection<SelectEditMode, NoteEditMode, BpmEditMode, ScrollVelocityEditMode> _EditModes;
 };
\ No newline at end of file
@@ -0,0 +1,616 @@
+#include "journal-module.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+#include "../structures/mapped-file.h"
+#include "../structures/atomic-file.h"
+#include "../structures/binary-io.h"
+#include "../structures/mapset-archive.h"
+
+#define JOURNAL_MAGIC "LRJ1"
+#define JOURNAL_FLUSH_INTERVAL 0.25f
+#define JOURNAL_CHECKPOINT_BYTES (8 * 1024 * 1024)
+
+//the record types are the edit action types, a checkpoint clears the chart of all notes and bpm points and is followed by the whole chart
+#define JOURNAL_RECORD_CHECKPOINT uint8_t(0xFE)
+#define JOURNAL_RECORD_SAVED_CHECKPOINT uint8_t(0xFF)
+
+/*
+* layout: the magic, followed by frames of [uint32 payload size][uint32 payload checksum][records].
+* a frame is one batch, a crash while appending leaves a torn last frame which fails its checksum and gets ignored.
+* values are stored in the byte order of the machine, the journal is never meant to move to another one.
+*/
+
+//nothing can be written next to a chart inside an archive, its journal goes next to the archive instead
+static std::filesystem::path GetJournalPath(const std::filesystem::path& InChartPath)
+{
+	std::filesystem::path archivePath;
+	std::string entryName;
+
+	std::filesystem::path journalPath = InChartPath;
+	std::error_code errorCode;
+
+	if (SplitArchivePath(InChartPath, archivePath, entryName))
+	{
+		std::replace(entryName.begin(), entryName.end(), '/', '_');
+
+		journalPath = archivePath;
+		journalPath += std::filesystem::u8path("." + entryName);
+	}
+	//a chart of a stepmania file is addressed as if the file was a folder, so it goes next to the file as well
+	else if (std::filesystem::is_regular_file(InChartPath.parent_path(), errorCode))
+	{
+		journalPath = InChartPath.parent_path();
+		journalPath += std::filesystem::u8path("." + InChartPath.filename().u8string());
+	}
+
+	journalPath += ".journal";
+
+	return journalPath;
+}
+
+static uint32_t CalculateChecksum(const std::string_view InBytes)
+{
+	//fnv-1a, it only has to catch torn and garbage frames
+	uint32_t checksum = 2166136261u;
+
+	for (const char byte : InBytes)
+		checksum = (checksum ^ uint8_t(byte)) * 16777619u;
+
+	return checksum;
+}
+
+static size_t GetRecordSize(const EditAction& InAction)
+{
+	switch (InAction.Type)
+	{
+	case EditAction::EType::PlaceNote:
+	case EditAction::EType::RemoveNote:
+		return 1 + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(Time) * 3;
+
+	case EditAction::EType::ModifyBpmPoint:
+		return 1 + (sizeof(Time) + sizeof(double) * 2) * 2;
+
+	case EditAction::EType::PlaceScrollVelocity:
+	case EditAction::EType::RemoveScrollVelocity:
+		return 1 + sizeof(double) * 3 + sizeof(int) * 5;
+
+	default:
+		return 1 + sizeof(Time) + sizeof(double) * 2;
+	}
+}
+
+static void WriteBpmPoint(std::string& OutBuffer, const BpmPoint& InBpmPoint)
+{
+	WriteBinaryValue(OutBuffer, InBpmPoint.TimePoint);
+	WriteBinaryValue(OutBuffer, InBpmPoint.Bpm);
+	WriteBinaryValue(OutBuffer, InBpmPoint.BeatLength);
+}
+
+static bool ReadBpmPoint(std::string_view& InOutView, BpmPoint& OutBpmPoint)
+{
+	return ReadBinaryValue(InOutView, OutBpmPoint.TimePoint) && ReadBinaryValue(InOutView, OutBpmPoint.Bpm) && ReadBinaryValue(InOutView, OutBpmPoint.BeatLength);
+}
+
+static void WriteScrollVelocity(std::string& OutBuffer, const ScrollVelocityMultiplier& InScrollVelocity)
+{
+	WriteBinaryValue(OutBuffer, InScrollVelocity.TimePoint);
+	WriteBinaryValue(OutBuffer, InScrollVelocity.Multiplier);
+	WriteBinaryValue(OutBuffer, InScrollVelocity.BeatLength);
+	WriteBinaryValue(OutBuffer, InScrollVelocity.Meter);
+	WriteBinaryValue(OutBuffer, InScrollVelocity.SampleSet);
+	WriteBinaryValue(OutBuffer, InScrollVelocity.SampleIndex);
+	WriteBinaryValue(OutBuffer, InScrollVelocity.Volume);
+	WriteBinaryValue(OutBuffer, InScrollVelocity.Effects);
+}
+
+static bool ReadScrollVelocity(std::string_view& InOutView, ScrollVelocityMultiplier& OutScrollVelocity)
+{
+	return ReadBinaryValue(InOutView, OutScrollVelocity.TimePoint)
+		&& ReadBinaryValue(InOutView, OutScrollVelocity.Multiplier)
+		&& ReadBinaryValue(InOutView, OutScrollVelocity.BeatLength)
+		&& ReadBinaryValue(InOutView, OutScrollVelocity.Meter)
+		&& ReadBinaryValue(InOutView, OutScrollVelocity.SampleSet)
+		&& ReadBinaryValue(InOutView, OutScrollVelocity.SampleIndex)
+		&& ReadBinaryValue(InOutView, OutScrollVelocity.Volume)
+		&& ReadBinaryValue(InOutView, OutScrollVelocity.Effects);
+}
+
+static void WriteRecord(std::string& OutBuffer, const EditAction& InAction)
+{
+	WriteBinaryValue(OutBuffer, uint8_t(InAction.Type));
+
+	switch (InAction.Type)
+	{
+	case EditAction::EType::PlaceNote:
+	case EditAction::EType::RemoveNote:
+		WriteBinaryValue(OutBuffer, uint16_t(InAction.NoteColumn));
+		WriteBinaryValue(OutBuffer, uint8_t(InAction.ActionNote.Type));
+		WriteBinaryValue(OutBuffer, InAction.ActionNote.TimePoint);
+		WriteBinaryValue(OutBuffer, InAction.ActionNote.TimePointBegin);
+		WriteBinaryValue(OutBuffer, InAction.ActionNote.TimePointEnd);
+		break;
+
+	case EditAction::EType::ModifyBpmPoint:
+		WriteBpmPoint(OutBuffer, InAction.FormerBpmPoint);
+		WriteBpmPoint(OutBuffer, InAction.LatterBpmPoint);
+		break;
+
+	case EditAction::EType::PlaceScrollVelocity:
+	case EditAction::EType::RemoveScrollVelocity:
+		WriteScrollVelocity(OutBuffer, InAction.ActionScrollVelocity);
+		break;
+
+	default:
+		WriteBpmPoint(OutBuffer, InAction.FormerBpmPoint);
+		break;
+	}
+}
+
+static bool ReadRecord(std::string_view& InOutView, const uint8_t InRecordType, EditAction& OutAction)
+{
+	if (InRecordType >= uint8_t(EditAction::EType::COUNT))
+		return false;
+
+	OutAction = {};
+	OutAction.Type = EditAction::EType(InRecordType);
+
+	switch (OutAction.Type)
+	{
+	case EditAction::EType::PlaceNote:
+	case EditAction::EType::RemoveNote:
+	{
+		uint16_t column = 0;
+		uint8_t noteType = 0;
+
+		if (!ReadBinaryValue(InOutView, column) || !ReadBinaryValue(InOutView, noteType) || noteType >= uint8_t(Note::EType::COUNT))
+			return false;
+
+		OutAction.NoteColumn = column;
+		OutAction.ActionNote.Type = Note::EType(noteType);
+
+		return ReadBinaryValue(InOutView, OutAction.ActionNote.TimePoint) && ReadBinaryValue(InOutView, OutAction.ActionNote.TimePointBegin) && ReadBinaryValue(InOutView, OutAction.ActionNote.TimePointEnd);
+	}
+
+	case EditAction::EType::ModifyBpmPoint:
+		return ReadBpmPoint(InOutView, OutAction.FormerBpmPoint) && ReadBpmPoint(InOutView, OutAction.LatterBpmPoint);
+
+	case EditAction::EType::PlaceScrollVelocity:
+	case EditAction::EType::RemoveScrollVelocity:
+		return ReadScrollVelocity(InOutView, OutAction.ActionScrollVelocity);
+
+	default:
+		return ReadBpmPoint(InOutView, OutAction.FormerBpmPoint);
+	}
+}
+
+//the frame header gets reserved first and filled in once the payload is known, so the records are encoded in place
+static size_t BeginFrame(std::string& OutBuffer)
+{
+	const size_t frameBegin = OutBuffer.size();
+	OutBuffer.append(sizeof(uint32_t) * 2, '\0');
+
+	return frameBegin;
+}
+
+static void EndFrame(std::string& OutBuffer, const size_t InFrameBegin)
+{
+	const size_t payloadBegin = InFrameBegin + sizeof(uint32_t) * 2;
+
+	const uint32_t payloadSize = uint32_t(OutBuffer.size() - payloadBegin);
+	const uint32_t checksum = CalculateChecksum(std::string_view(OutBuffer).substr(payloadBegin));
+
+	std::memcpy(&OutBuffer[InFrameBegin], &payloadSize, sizeof(uint32_t));
+	std::memcpy(&OutBuffer[InFrameBegin + sizeof(uint32_t)], &checksum, sizeof(uint32_t));
+}
+
+bool JournalModule::Tick(const float& InDeltaTime)
+{
+	bool hasWriteFailed = false;
+
+	{
+		std::lock_guard<std::mutex> lock(_WriteMutex);
+		std::swap(hasWriteFailed, _HasWriteFailed);
+	}
+
+	if (hasWriteFailed)
+		PUSH_NOTIFICATION("Failed to write the edit journal");
+
+	if (!_Chart)
+		return true;
+
+	_TimeSinceFlush += InDeltaTime;
+
+	if (_TimeSinceFlush < JOURNAL_FLUSH_INTERVAL)
+		return true;
+
+	_TimeSinceFlush = 0.f;
+	FlushPendingActions();
+
+	return true;
+}
+
+bool JournalModule::ShutDown()
+{
+	Close();
+
+	{
+		std::lock_guard<std::mutex> lock(_WriteMutex);
+		_ShouldStopWriting = true;
+	}
+
+	_WriteCondition.notify_one();
+
+	if (_WriteThread.joinable())
+		_WriteThread.join();
+
+	return true;
+}
+
+bool JournalModule::Open(Chart* const InOutChart, const std::filesystem::path& InChartPath)
+{
+	Close();
+
+	_Chart = InOutChart;
+	_JournalPath = GetJournalPath(InChartPath);
+
+	_TimeSinceFlush = 0.f;
+	_BytesSinceCheckpoint = 0;
+	_HasUnsavedEdits = false;
+
+	const bool hasRecovered = Recover(_JournalPath);
+
+	if (hasRecovered)
+	{
+		PUSH_NOTIFICATION("Recovered the unsaved edits of the last session");
+
+		//from here on the journal doesn't depend on the chart file anymore, saving over it can't break a later recovery
+		_HasUnsavedEdits = true;
+		Checkpoint();
+	}
+	else if (std::error_code errorCode; std::filesystem::exists(_JournalPath, errorCode))
+	{
+		//a journal that is unreadable or matches the chart file would only get appended to
+		QueueWrite({ JournalWrite::EType::Remove, _JournalPath });
+	}
+
+	ListenToChart();
+
+	return hasRecovered;
+}
+
+void JournalModule::Resume(Chart* const InChart, const std::filesystem::path& InChartPath, const bool InHasUnsavedEdits)
+{
+	Close();
+
+	_Chart = InChart;
+	_JournalPath = GetJournalPath(InChartPath);
+
+	_TimeSinceFlush = 0.f;
+	_BytesSinceCheckpoint = 0;
+	_HasUnsavedEdits = InHasUnsavedEdits;
+
+	//the chart in memory is the newest state, the journal gets rewritten to it or removed if there is nothing to keep
+	if (_HasUnsavedEdits)
+		Checkpoint();
+	else if (std::error_code errorCode; std::filesystem::exists(_JournalPath, errorCode))
+		QueueWrite({ JournalWrite::EType::Remove, _JournalPath });
+
+	ListenToChart();
+}
+
+void JournalModule::ListenToChart()
+{
+	_Chart->RegisterOnEditActionCallback([this](const EditAction& InAction)
+	{
+		_PendingActions.push_back(InAction);
+		_HasUnsavedEdits = true;
+		++_EditAmount;
+	});
+}
+
+bool JournalModule::Close()
+{
+	if (!_Chart)
+		return false;
+
+	FlushPendingActions();
+
+	if (!_HasUnsavedEdits)
+		QueueWrite({ JournalWrite::EType::Remove, _JournalPath });
+
+	_Chart->RegisterOnEditActionCallback(nullptr);
+	_Chart = nullptr;
+
+	//a save of this chart that finishes later is about a chart the journal isn't following anymore
+	_QueuedSaves.clear();
+
+	//the next chart might be the same file again, its recovery has to see the journal as it has been left here
+	std::unique_lock<std::mutex> lock(_WriteMutex);
+	_IdleCondition.wait(lock, [this]() { return _QueuedWrites.empty() && !_IsWriting; });
+
+	return _HasUnsavedEdits;
+}
+
+void JournalModule::OnChartSaved()
+{
+	if (!_Chart)
+		return;
+
+	_HasUnsavedEdits = false;
+	Checkpoint();
+}
+
+void JournalModule::OnChartSaveQueued(const size_t InSaveIndex)
+{
+	if (!_Chart)
+		return;
+
+	_QueuedSaves.push_back({ InSaveIndex, _EditAmount });
+}
+
+void JournalModule::OnChartSaveFinished(const size_t InSaveIndex, const bool InHasSucceeded)
+{
+	auto queuedSaveIt = std::find_if(_QueuedSaves.begin(), _QueuedSaves.end(), [InSaveIndex](const QueuedSave& InQueuedSave) { return InQueuedSave.SaveIndex == InSaveIndex; });
+
+	if (queuedSaveIt == _QueuedSaves.end())
+		return;
+
+	const QueuedSave queuedSave = *queuedSaveIt;
+
+	//saves finish in the order they have been queued, the earlier ones have either finished or been replaced by this one
+	_QueuedSaves.erase(_QueuedSaves.begin(), queuedSaveIt + 1);
+
+	//until the file has the edits, the journal keeps writing them as unsaved
+	if (!InHasSucceeded || queuedSave.EditAmount != _EditAmount)
+		return;
+
+	OnChartSaved();
+}
+
+void JournalModule::Checkpoint()
+{
+	//the snapshot already contains everything that is still pending
+	_PendingActions.clear();
+	_BytesSinceCheckpoint = 0;
+
+	QueueWrite({ JournalWrite::EType::Checkpoint, _JournalPath, {}, _Chart->TakeSnapshot(), !_HasUnsavedEdits });
+}
+
+void JournalModule::FlushPendingActions()
+{
+	if (_PendingActions.empty())
+		return;
+
+	for (const EditAction& action : _PendingActions)
+		_BytesSinceCheckpoint += GetRecordSize(action);
+
+	if (_BytesSinceCheckpoint >= JOURNAL_CHECKPOINT_BYTES)
+		return Checkpoint();
+
+	JournalWrite journalWrite = { JournalWrite::EType::Append, _JournalPath };
+	journalWrite.Actions.swap(_PendingActions);
+
+	QueueWrite(std::move(journalWrite));
+}
+
+void JournalModule::QueueWrite(JournalWrite&& InWrite)
+{
+	{
+		std::lock_guard<std::mutex> lock(_WriteMutex);
+
+		_QueuedWrites.push_back(std::move(InWrite));
+
+		if (!_WriteThread.joinable())
+			_WriteThread = std::thread(&JournalModule::RunWriteThread, this);
+	}
+
+	_WriteCondition.notify_one();
+}
+
+bool JournalModule::Recover(const std::filesystem::path& InJournalPath)
+{
+	MappedFile journalFile;
+
+	if (!journalFile.Open(InJournalPath))
+		return false;
+
+	std::string_view content = journalFile.GetView();
+
+	if (content.substr(0, sizeof(JOURNAL_MAGIC) - 1) != JOURNAL_MAGIC)
+		return false;
+
+	content.remove_prefix(sizeof(JOURNAL_MAGIC) - 1);
+
+	std::vector<EditAction> actions;
+
+	bool hasCheckpoint = false;
+	bool isCheckpointSaved = false;
+	size_t checkpointActionAmount = 0;
+
+	uint32_t payloadSize = 0;
+	uint32_t checksum = 0;
+
+	while (ReadBinaryValue(content, payloadSize) && ReadBinaryValue(content, checksum))
+	{
+		if (content.size() < payloadSize || CalculateChecksum(content.substr(0, payloadSize)) != checksum)
+			break;
+
+		std::string_view payload = content.substr(0, payloadSize);
+		content.remove_prefix(payloadSize);
+
+		uint8_t recordType = 0;
+		bool isCheckpointFrame = false;
+
+		while (ReadBinaryValue(payload, recordType))
+		{
+			if (recordType == JOURNAL_RECORD_CHECKPOINT || recordType == JOURNAL_RECORD_SAVED_CHECKPOINT)
+			{
+				actions.clear();
+
+				hasCheckpoint = true;
+				isCheckpointSaved = recordType == JOURNAL_RECORD_SAVED_CHECKPOINT;
+				isCheckpointFrame = true;
+
+				continue;
+			}
+
+			EditAction action;
+
+			if (!ReadRecord(payload, recordType, action))
+				break;
+
+			actions.push_back(action);
+		}
+
+		if (isCheckpointFrame)
+			checkpointActionAmount = actions.size();
+	}
+
+	//a saved checkpoint without anything after it is exactly what the chart file holds
+	if (actions.size() == checkpointActionAmount && (!hasCheckpoint || isCheckpointSaved))
+		return false;
+
+	//a checkpoint stands on its own, whatever the chart file holds gets taken out before
+	if (hasCheckpoint)
+	{
+		std::vector<EditAction> resetActions;
+
+		_Chart->IterateAllBpmPoints([&resetActions](const BpmPoint& InBpmPoint)
+		{
+			resetActions.push_back({ EditAction::EType::RemoveBpmPoint, 0, Note(), InBpmPoint });
+		});
+
+		for (const ScrollVelocityMultiplier& scrollVelocity : _Chart->GetScrollVelocityMap().GetPoints())
+		{
+			EditAction& resetAction = resetActions.emplace_back();
+			resetAction.Type = EditAction::EType::RemoveScrollVelocity;
+			resetAction.ActionScrollVelocity = scrollVelocity;
+		}
+
+		_Chart->IterateAllNotes([&resetActions](const Note& InNote, const Column InColumn)
+		{
+			resetActions.push_back({ EditAction::EType::RemoveNote, InColumn, InNote });
+		});
+
+		actions.insert(actions.begin(), resetActions.begin(), resetActions.end());
+	}
+
+	_Chart->ReplayEditActions(actions);
+
+	return true;
+}
+
+void JournalModule::RunWriteThread()
+{
+	std::unique_lock<std::mutex> lock(_WriteMutex);
+
+	while (true)
+	{
+		_WriteCondition.wait(lock, [this]() { return _ShouldStopWriting || !_QueuedWrites.empty(); });
+
+		if (_QueuedWrites.empty())
+			return;
+
+		std::vector<JournalWrite> journalWrites;
+		journalWrites.swap(_QueuedWrites);
+
+		_IsWriting = true;
+		lock.unlock();
+
+		bool hasSucceeded = true;
+
+		for (size_t index = 0; index < journalWrites.size(); ++index)
+		{
+			const JournalWrite& journalWrite = journalWrites[index];
+
+			//appends which get replaced by a later checkpoint or removal of the same journal are not worth the disk access
+			const bool isSuperseded = journalWrite.Type == JournalWrite::EType::Append && std::any_of(journalWrites.begin() + index + 1, journalWrites.end(), [&journalWrite](const JournalWrite& InLaterWrite)
+			{
+				return InLaterWrite.Type != JournalWrite::EType::Append && InLaterWrite.Path == journalWrite.Path;
+			});
+
+			if (isSuperseded)
+				continue;
+
+			std::string buffer;
+
+			switch (journalWrite.Type)
+			{
+			case JournalWrite::EType::Append:
+			{
+				std::error_code errorCode;
+
+				if (!std::filesystem::exists(journalWrite.Path, errorCode))
+					buffer += JOURNAL_MAGIC;
+
+				buffer.reserve(buffer.size() + sizeof(uint32_t) * 2 + journalWrite.Actions.size() * GetRecordSize(EditAction{ EditAction::EType::ModifyBpmPoint }));
+
+				const size_t frameBegin = BeginFrame(buffer);
+
+				for (const EditAction& action : journalWrite.Actions)
+					WriteRecord(buffer, action);
+
+				EndFrame(buffer, frameBegin);
+
+				hasSucceeded &= AppendFileDurably(journalWrite.Path, buffer);
+			}
+			break;
+
+			case JournalWrite::EType::Checkpoint:
+			{
+				const ChartSnapshot& snapshot = journalWrite.Snapshot;
+
+				buffer += JOURNAL_MAGIC;
+				buffer.reserve(buffer.size() + sizeof(uint32_t) * 2 + 1 + snapshot.BpmPoints.size() * GetRecordSize({ EditAction::EType::PlaceBpmPoint }) + snapshot.ScrollVelocities.size() * GetRecordSize({ EditAction::EType::PlaceScrollVelocity }) + snapshot.Notes.size() * GetRecordSize({ EditAction::EType::PlaceNote }));
+
+				const size_t frameBegin = BeginFrame(buffer);
+
+				WriteBinaryValue(buffer, journalWrite.IsSaved ? JOURNAL_RECORD_SAVED_CHECKPOINT : JOURNAL_RECORD_CHECKPOINT);
+
+				for (const BpmPoint& bpmPoint : snapshot.BpmPoints)
+					WriteRecord(buffer, { EditAction::EType::PlaceBpmPoint, 0, Note(), bpmPoint });
+
+				for (const ScrollVelocityMultiplier& scrollVelocity : snapshot.ScrollVelocities)
+				{
+					EditAction action = {};
+					action.Type = EditAction::EType::PlaceScrollVelocity;
+					action.ActionScrollVelocity = scrollVelocity;
+
+					WriteRecord(buffer, action);
+				}
+
+				for (const auto& [column, note] : snapshot.Notes)
+					WriteRecord(buffer, { EditAction::EType::PlaceNote, column, note });
+
+				EndFrame(buffer, frameBegin);
+
+				hasSucceeded &= WriteFileAtomically(journalWrite.Path, buffer);
+			}
+			break;
+
+			case JournalWrite::EType::Remove:
+			{
+				std::error_code errorCode;
+				std::filesystem::remove(journalWrite.Path, errorCode);
+			}
+			break;
+
+			default:
+				break;
+			}
+		}
+
+		lock.lock();
+
+		if (!hasSucceeded)
+			_HasWriteFailed = true;
+
+		_IsWriting = false;
+		_IdleCondition.notify_all();
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "base/module.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*
+* keeps an append-only binary journal of every change next to the opened chart, so a crash doesn't lose the edits done since the last save.
+* changes are gathered during the frame and handed to a writing thread in batches, the ui thread never touches the disk.
+* every save and every few megabytes the journal gets rewritten into a checkpoint, which is the whole chart state on its own.
+* opening a chart with a journal next to it replays the journal over it, a clean close of a saved chart removes the journal again.
+*/
+class JournalModule : public Module
+{
+public:
+
+	bool Tick(const float& InDeltaTime) override;
+	bool ShutDown() override;
+
+	//true if the chart got changed by replaying the journal left from a previous session
+	bool Open(Chart* const InOutChart, const std::filesystem::path& InChartPath);
+	//for a chart that has stayed loaded since it has been closed, its journal already holds its edits and must not be replayed again
+	void Resume(Chart* const InChart, const std::filesystem::path& InChartPath, const bool InHasUnsavedEdits);
+	//true if the closed chart still has unsaved edits, which stay in its journal
+	bool Close();
+
+	//for a save done on the calling thread, the chart as it is now is what its file holds
+	void OnChartSaved();
+
+	//a save on the saving thread only counts once it has been written, and only if nothing got edited since it has been queued
+	void OnChartSaveQueued(const size_t InSaveIndex);
+	void OnChartSaveFinished(const size_t InSaveIndex, const bool InHasSucceeded);
+
+private:
+
+	struct JournalWrite
+	{
+		enum class EType
+		{
+			Append,
+			Checkpoint,
+			Remove,
+
+			COUNT
+		} Type;
+
+		std::filesystem::path Path;
+		std::vector<EditAction> Actions;
+		ChartSnapshot Snapshot;
+		bool IsSaved = false;
+	};
+
+	struct QueuedSave
+	{
+		size_t SaveIndex = 0;
+		size_t EditAmount = 0;
+	};
+
+	void ListenToChart();
+	void Checkpoint();
+	void FlushPendingActions();
+	void QueueWrite(JournalWrite&& InWrite);
+
+	bool Recover(const std::filesystem::path& InJournalPath);
+	void RunWriteThread();
+
+	Chart* _Chart = nullptr;
+	std::filesystem::path _JournalPath;
+
+	std::vector<EditAction> _PendingActions;
+	float _TimeSinceFlush = 0.f;
+	size_t _BytesSinceCheckpoint = 0;
+	bool _HasUnsavedEdits = false;
+
+	//counts every edit, a finished save is only the current state if the count hasn't moved since it has been queued
+	size_t _EditAmount = 0;
+	std::vector<QueuedSave> _QueuedSaves;
+
+	std::thread _WriteThread;
+	std::mutex _WriteMutex;
+	std::condition_variable _WriteCondition;
+	std::condition_variable _IdleCondition;
+	std::vector<JournalWrite> _QueuedWrites;
+	bool _ShouldStopWriting = false;
+	bool _HasWriteFailed = false;
+	bool _IsWriting = false;
+};
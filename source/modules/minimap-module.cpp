@@ -15,9 +15,9 @@ void MiniMapModule::Generate(Chart* const InChart, Skin& InSkin, const Time InSo
     
     _MiniMapRenderTexture.clear({0, 0, 0, 255});
 
-    InChart->IterateNotesInTimeRange(0, InSongLength, [this, &InSkin, &InSongLength](Note& InOutNote, const Column InColumn)
+    InChart->IterateNotesInTimeRange(0, InSongLength, [this, &InSkin, &InSongLength](const Note& InOutNote, const Column InColumn)
     {
-        if(InOutNote.Type == Note::EType::HoldEnd || InOutNote.Type == Note::EType::HoldIntermediate)
+        if(InOutNote.Type == Note::EType::HoldEnd)
             return;
 
         if(InOutNote.Type == Note::EType::HoldBegin)
@@ -47,55 +47,74 @@ void MiniMapModule::Generate(Chart* const InChart, Skin& InSkin, const Time InSo
     _MiniMapSprite.setTexture(_MiniMapRenderTexture.getTexture());
 }
 
-void MiniMapModule::GeneratePortion(const TimeSlice& InTimeSlice, Skin& InSkin) 
+void MiniMapModule::GeneratePortion(Chart* const InChart, const Time InTimeBegin, const Time InTimeEnd, Skin& InSkin) 
 {
     sf::RectangleShape backgroundRectangle;
-    backgroundRectangle.setSize(sf::Vector2f(_Width, int(float(TIMESLICE_LENGTH / _HeightScale) + 0.5f) + _NoteHeight));
+    backgroundRectangle.setSize(sf::Vector2f(_Width, int(float((InTimeEnd - InTimeBegin + 1) / _HeightScale) + 0.5f) + _NoteHeight));
     backgroundRectangle.setFillColor({0, 0, 0, 255});
 
-    backgroundRectangle.setPosition(sf::Vector2f(0, (InTimeSlice.TimePoint) / _HeightScale));
+    backgroundRectangle.setPosition(sf::Vector2f(0, (InTimeBegin) / _HeightScale));
 
     _MiniMapRenderTexture.draw(backgroundRectangle);
 
-    for(const auto& [column, notes] : InTimeSlice.Notes)
+    const Time timeBegin = InTimeBegin;
+    const Time timeEnd = InTimeEnd;
+
+    //every hold reaching into the range is drawn whole, so the background above doesn't cut through its body
+    InChart->IterateHoldsInTimeRange(timeBegin, timeEnd, [this, &InSkin](const Note& note, const Column column)
     {
-        for(const auto& note : notes)
-        {
-            if(note.Type == Note::EType::HoldEnd || note.Type == Note::EType::HoldBegin || note.Type == Note::EType::HoldIntermediate)
-            {
-                sf::RectangleShape rectangleHold;
+        sf::RectangleShape rectangleHold;
 
-                rectangleHold.setSize(sf::Vector2f(_NoteWidth, (note.TimePointEnd - note.TimePointBegin + _NoteHeight) / _HeightScale));
-                rectangleHold.setFillColor({32, 255, 32, 255});
+        rectangleHold.setSize(sf::Vector2f(_NoteWidth, (note.TimePointEnd - note.TimePointBegin + _NoteHeight) / _HeightScale));
+        rectangleHold.setFillColor({32, 255, 32, 255});
 
-                rectangleHold.setPosition(sf::Vector2f(_BorderPadding + _NoteWidth + (column * _NoteWidth + column), (note.TimePointBegin - _NoteHeight) / _HeightScale));
+        rectangleHold.setPosition(sf::Vector2f(_BorderPadding + _NoteWidth + (column * _NoteWidth + column), (note.TimePointBegin - _NoteHeight) / _HeightScale));
 
-                _MiniMapRenderTexture.draw(rectangleHold);
-            }
+        _MiniMapRenderTexture.draw(rectangleHold);
 
-            Time noteTime = note.Type == Note::EType::HoldBegin 
-                         || note.Type == Note::EType::HoldEnd 
-                         || note.Type == Note::EType::HoldIntermediate ? note.TimePointBegin : note.TimePoint;
+        sf::RectangleShape rectangle;
 
-            sf::RectangleShape rectangle;
+        rectangle.setSize(sf::Vector2f(_NoteWidth, _NoteHeight));
+        rectangle.setFillColor(InSkin.SnapColorTable[note.BeatSnap]);
 
-            rectangle.setSize(sf::Vector2f(_NoteWidth, _NoteHeight));
-            rectangle.setFillColor(InSkin.SnapColorTable[note.BeatSnap]);
+        rectangle.setPosition(sf::Vector2f(_BorderPadding + _NoteWidth + (column * _NoteWidth + column), (note.TimePointBegin - _NoteHeight) / _HeightScale));
 
-            rectangle.setPosition(sf::Vector2f(_BorderPadding + _NoteWidth + (column * _NoteWidth + column), (noteTime - _NoteHeight) / _HeightScale));
+        _MiniMapRenderTexture.draw(rectangle);
+    });
 
-            _MiniMapRenderTexture.draw(rectangle);
-        }
-    }
+    InChart->IterateNotesInTimeRange(timeBegin, timeEnd, [this, &InSkin](const Note& note, const Column column)
+    {
+        if(note.Type != Note::EType::Common)
+            return;
+
+        sf::RectangleShape rectangle;
+
+        rectangle.setSize(sf::Vector2f(_NoteWidth, _NoteHeight));
+        rectangle.setFillColor(InSkin.SnapColorTable[note.BeatSnap]);
+
+        rectangle.setPosition(sf::Vector2f(_BorderPadding + _NoteWidth + (column * _NoteWidth + column), (note.TimePoint - _NoteHeight) / _HeightScale));
+
+        _MiniMapRenderTexture.draw(rectangle);
+    });
 }
 
 TimefieldRenderGraph& MiniMapModule::GetPreviewRenderGraph(Chart* const InChart) 
 {
-	InChart->IterateNotesInTimeRange(_HoveredTime - _PreviewTimeLength, _HoveredTime + _PreviewTimeLength, [this](Note& InNote, const Column InColumn)
+	const Time timeBegin = _HoveredTime - _PreviewTimeLength;
+	const Time timeEnd = _HoveredTime + _PreviewTimeLength;
+
+	InChart->IterateNotesInTimeRange(timeBegin, timeEnd, [this](const Note& InNote, const Column InColumn)
 	{
 		_PreviewRenderGraph.SubmitNoteRenderCommand(InNote, InColumn);
 	});
 
+	//holds that started before the preview still need their begin submitted for the body to be drawn
+	InChart->IterateHoldsInTimeRange(timeBegin, timeEnd, [this, timeBegin](const Note& InNote, const Column InColumn)
+	{
+		if(InNote.TimePoint < timeBegin)
+			_PreviewRenderGraph.SubmitNoteRenderCommand(InNote, InColumn);
+	});
+
     return _PreviewRenderGraph;
 }
 
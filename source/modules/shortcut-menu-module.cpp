@@ -24,6 +24,13 @@ void ShortcutMenuModule::ShowCheatSheet()
 		
 	ImGui::Spacing();
 		
+	ImGui::Text("SV Edit Mode"); ImGui::SameLine(196.f); ImGui::Text("NUM 4");
+	ImGui::Text("Place SV Node"); ImGui::SameLine(196.f); ImGui::Text("Left Click");
+	ImGui::Text("Remove SV Node"); ImGui::SameLine(196.f); ImGui::Text("Right Click");
+	ImGui::Text("Snap SV Node"); ImGui::SameLine(196.f); ImGui::Text("SHIFT");
+		
+	ImGui::Spacing();
+		
 	ImGui::Text("Scroll"); ImGui::SameLine(196.f); ImGui::Text("Mouse Wheel/Up&Down");
 	ImGui::Text("Zoom"); ImGui::SameLine(196.f); ImGui::Text("CTRL+Mouse Wheel");
 	ImGui::Text("Audio Playback Speed"); ImGui::SameLine(196.f); ImGui::Text("SHIFT+[Mouse Wheel/Left&Right]");
@@ -32,6 +39,7 @@ void ShortcutMenuModule::ShowCheatSheet()
 	ImGui::Spacing();
 
 	ImGui::Text("Undo"); ImGui::SameLine(196.f); ImGui::Text("CTRL+Z");
+	ImGui::Text("Redo"); ImGui::SameLine(196.f); ImGui::Text("CTRL+Y");
 	ImGui::Text("Copy"); ImGui::SameLine(196.f); ImGui::Text("CTRL+C");
 	ImGui::Text("Paste"); ImGui::SameLine(196.f); ImGui::Text("CTRL+V");
 	ImGui::Text("Delete"); ImGui::SameLine(196.f); ImGui::Text("DELETE");
@@ -0,0 +1,176 @@
+#include "spectrogram-module.h"
+
+#include <algorithm>
+#include <cmath>
+
+//spectrogram columns per tile, the rows of its texture
+#define SPECTROGRAM_TILE_COLUMN_AMOUNT 256
+
+//tiles kept around off screen, scrolling back and forth over a part of the song doesn't upload them again
+#define SPECTROGRAM_MAX_TILE_AMOUNT 64
+
+//jumping somewhere new fills the screen in over a couple of frames instead of stalling a single one
+#define SPECTROGRAM_MAX_TILE_UPLOADS_PER_FRAME 4
+
+bool SpectrogramModule::StartUp()
+{
+	//quiet parts stay see through, so the notes and the waveform on top of it remain readable
+	const sf::Color gradient[] = { sf::Color(0, 0, 0, 0), sf::Color(48, 0, 96, 96), sf::Color(192, 32, 96, 160), sf::Color(255, 144, 0, 208), sf::Color(255, 255, 192, 240) };
+	const int stopAmount = int(sizeof(gradient) / sizeof(gradient[0]));
+
+	for (int intensity = 0; intensity < 256; ++intensity)
+	{
+		const float position = float(intensity) / 255.0f * float(stopAmount - 1);
+		const int stop = std::min(int(position), stopAmount - 2);
+		const float blend = position - float(stop);
+
+		const sf::Color& from = gradient[stop];
+		const sf::Color& to = gradient[stop + 1];
+
+		_ColorMap[intensity] = sf::Color(
+			sf::Uint8(std::lround(from.r + (to.r - from.r) * blend)),
+			sf::Uint8(std::lround(from.g + (to.g - from.g) * blend)),
+			sf::Uint8(std::lround(from.b + (to.b - from.b) * blend)),
+			sf::Uint8(std::lround(from.a + (to.a - from.a) * blend)));
+	}
+
+	_TilePixels.resize(SPECTROGRAM_BAND_AMOUNT * SPECTROGRAM_TILE_COLUMN_AMOUNT * 4);
+
+	return true;
+}
+
+void SpectrogramModule::SetSpectrogramData(SpectrogramData* const InSpectrogramData)
+{
+	//the same data gets filled in again for another song or resolution, none of the tiles match anymore
+	_SpectrogramData = InSpectrogramData;
+
+	_Tiles.clear();
+	_VisibleTiles.clear();
+}
+
+void SpectrogramModule::RenderSpectrogram(TimefieldRenderGraph& InOutRenderGraph, const Time InTimeBegin, const Time InTimeEnd, const float InZoomLevel)
+{
+	_VisibleTiles.clear();
+
+	if (!_SpectrogramData || _SpectrogramData->GetColumnAmount() == 0)
+		return;
+
+	const double columnDuration = _SpectrogramData->GetColumnDuration();
+	const size_t doneColumnAmount = _SpectrogramData->GetDoneColumnAmount();
+
+	const size_t firstColumn = size_t(std::clamp(std::floor(double(InTimeBegin) / columnDuration), 0.0, double(doneColumnAmount)));
+	const size_t lastColumn = size_t(std::clamp(std::ceil(double(InTimeEnd) / columnDuration), 0.0, double(doneColumnAmount)));
+
+	if (firstColumn >= lastColumn)
+		return;
+
+	++_FrameIndex;
+
+	int uploadAmount = 0;
+
+	for (size_t tileIndex = firstColumn / SPECTROGRAM_TILE_COLUMN_AMOUNT; tileIndex * SPECTROGRAM_TILE_COLUMN_AMOUNT < lastColumn; ++tileIndex)
+	{
+		Tile& tile = _Tiles[tileIndex];
+		tile.LastUsedFrame = _FrameIndex;
+
+		const size_t columnAmount = std::min(size_t(SPECTROGRAM_TILE_COLUMN_AMOUNT), doneColumnAmount - tileIndex * SPECTROGRAM_TILE_COLUMN_AMOUNT);
+
+		if (tile.ColumnAmount < columnAmount && uploadAmount < SPECTROGRAM_MAX_TILE_UPLOADS_PER_FRAME)
+		{
+			UploadColumns(tile, tileIndex, columnAmount);
+			++uploadAmount;
+		}
+
+		if (tile.ColumnAmount == 0)
+			continue;
+
+		//later columns are further up the screen
+		VisibleTile visibleTile;
+		visibleTile.DrawnTile = &tile;
+		visibleTile.Top = float((double(InTimeEnd) - double(tileIndex * SPECTROGRAM_TILE_COLUMN_AMOUNT + tile.ColumnAmount) * columnDuration) * InZoomLevel);
+		visibleTile.RowHeight = float(columnDuration * InZoomLevel);
+
+		_VisibleTiles.push_back(visibleTile);
+	}
+
+	EvictTiles();
+
+	InOutRenderGraph.SubmitTimefieldRenderCommand(0, InTimeEnd, [this](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
+	{
+		sf::RenderStates renderStates;
+		renderStates.transform.translate(float(InTimefieldMetrics.LeftSidePosition), float(InScreenY));
+
+		sf::Sprite sprite;
+
+		for (const VisibleTile& visibleTile : _VisibleTiles)
+		{
+			const int columnAmount = int(visibleTile.DrawnTile->ColumnAmount);
+
+			sprite.setTexture(visibleTile.DrawnTile->Texture);
+			sprite.setTextureRect(sf::IntRect(0, SPECTROGRAM_TILE_COLUMN_AMOUNT - columnAmount, SPECTROGRAM_BAND_AMOUNT, columnAmount));
+			sprite.setPosition(0.0f, visibleTile.Top);
+			sprite.setScale(float(InTimefieldMetrics.FieldWidth) / float(SPECTROGRAM_BAND_AMOUNT), visibleTile.RowHeight);
+
+			InRenderTarget->draw(sprite, renderStates);
+		}
+	});
+}
+
+void SpectrogramModule::UploadColumns(Tile& InOutTile, const size_t InTileIndex, const size_t InColumnAmount)
+{
+	//a new tile gets cleared completely, the smoothing would otherwise blend its top row with whatever the texture held before
+	const bool isNewTile = InOutTile.Texture.getSize().x == 0;
+
+	if (isNewTile)
+	{
+		InOutTile.Texture.create(SPECTROGRAM_BAND_AMOUNT, SPECTROGRAM_TILE_COLUMN_AMOUNT);
+		InOutTile.Texture.setSmooth(true);
+	}
+
+	const size_t firstColumn = isNewTile ? 0 : InOutTile.ColumnAmount;
+	const size_t endColumn = isNewTile ? SPECTROGRAM_TILE_COLUMN_AMOUNT : InColumnAmount;
+
+	//the first column of a tile is its bottom row
+	for (size_t column = firstColumn; column < endColumn; ++column)
+	{
+		sf::Uint8* const row = _TilePixels.data() + (endColumn - 1 - column) * SPECTROGRAM_BAND_AMOUNT * 4;
+
+		if (column >= InColumnAmount)
+		{
+			std::fill(row, row + SPECTROGRAM_BAND_AMOUNT * 4, sf::Uint8(0));
+			continue;
+		}
+
+		const uint8_t* const intensities = _SpectrogramData->GetColumn(InTileIndex * SPECTROGRAM_TILE_COLUMN_AMOUNT + column);
+
+		for (int band = 0; band < SPECTROGRAM_BAND_AMOUNT; ++band)
+		{
+			const sf::Color& color = _ColorMap[intensities[band]];
+
+			row[band * 4 + 0] = color.r;
+			row[band * 4 + 1] = color.g;
+			row[band * 4 + 2] = color.b;
+			row[band * 4 + 3] = color.a;
+		}
+	}
+
+	InOutTile.Texture.update(_TilePixels.data(), SPECTROGRAM_BAND_AMOUNT, unsigned(endColumn - firstColumn), 0, unsigned(SPECTROGRAM_TILE_COLUMN_AMOUNT - endColumn));
+	InOutTile.ColumnAmount = InColumnAmount;
+}
+
+void SpectrogramModule::EvictTiles()
+{
+	//least recently drawn first, the tiles of this frame always stay
+	while (_Tiles.size() > SPECTROGRAM_MAX_TILE_AMOUNT)
+	{
+		auto oldestTile = std::min_element(_Tiles.begin(), _Tiles.end(), [](const auto& InFirst, const auto& InSecond)
+		{
+			return InFirst.second.LastUsedFrame < InSecond.second.LastUsedFrame;
+		});
+
+		if (oldestTile->second.LastUsedFrame == _FrameIndex)
+			break;
+
+		_Tiles.erase(oldestTile);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "base/module.h"
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+/*
+* draws the spectrogram as a column of textured tiles, every tile holds a fixed amount of spectrogram columns as its rows.
+* tiles get uploaded once and stay cached, zooming only stretches them. a tile at the end of what is decoded so far gets its new rows added as they come in.
+*/
+class SpectrogramModule : public Module
+{
+public:
+
+	virtual bool StartUp() override;
+
+public:
+
+	void SetSpectrogramData(SpectrogramData* const InSpectrogramData);
+	void RenderSpectrogram(TimefieldRenderGraph& InOutRenderGraph, const Time InTimeBegin, const Time InTimeEnd, const float InZoomLevel);
+
+private:
+
+	struct Tile
+	{
+		sf::Texture Texture;
+
+		//rows uploaded so far, counted from the bottom of the texture
+		size_t ColumnAmount = 0;
+		size_t LastUsedFrame = 0;
+	};
+
+	//relative to the end of the window, like the waveform
+	struct VisibleTile
+	{
+		const Tile* DrawnTile = nullptr;
+		float Top = 0.0f;
+		float RowHeight = 0.0f;
+	};
+
+	void UploadColumns(Tile& InOutTile, const size_t InTileIndex, const size_t InColumnAmount);
+	void EvictTiles();
+
+	std::unordered_map<size_t, Tile> _Tiles;
+	std::vector<VisibleTile> _VisibleTiles;
+
+	std::vector<sf::Uint8> _TilePixels;
+	std::array<sf::Color, 256> _ColorMap;
+
+	SpectrogramData* _SpectrogramData = nullptr;
+
+	size_t _FrameIndex = 0;
+};
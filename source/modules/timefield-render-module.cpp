@@ -1,5 +1,12 @@
 #include "timefield-render-module.h"
 
+#include <algorithm>
+#include <cmath>
+
+//gimmicks can throw notes thousands of screens away, which an int screen point has to be able to hold
+#define TIMEFIELD_MAX_SCROLL_DISTANCE 1000000.0
+#define TIMEFIELD_MAX_TIME_POINT (1 << 30)
+
 bool TimefieldRenderModule::StartUp()
 {
 	_HoldRenderLayer.create(3840, 2160);
@@ -50,9 +57,8 @@ void TimefieldRenderModule::RenderTimefieldGraph(sf::RenderTarget* const InOutRe
 		//hold pass
 		switch (note.Type)
 		{
+		//the body is drawn once from the begin, which is also submitted while only the body is on screen
 		case Note::EType::HoldBegin:
-		case Note::EType::HoldIntermediate:
-		case Note::EType::HoldEnd:
 			{
 				int endY = GetScreenPointFromTime(note.TimePointEnd, InTime, InZoomLevel) - _TimefieldMetrics.ColumnSize / 2;
 				int height = GetScreenPointFromTime(note.TimePointBegin, InTime, InZoomLevel) - endY;
@@ -138,9 +144,12 @@ void TimefieldRenderModule::RenderReceptors(sf::RenderTarget* const InOutRenderT
 
 int TimefieldRenderModule::GetScreenPointFromTime(const Time InTimePoint, const Time InTime, const float InZoomLevel)
 {
-	int timePoint = InTimePoint - InTime;
+	float scrollDistance = float(InTimePoint - InTime);
+
+	if (_ScrollVelocityMap)
+		scrollDistance = float(std::clamp(_ScrollVelocityMap->GetScrollPosition(InTimePoint) - _ScrollVelocityMap->GetScrollPosition(InTime), -TIMEFIELD_MAX_SCROLL_DISTANCE, TIMEFIELD_MAX_SCROLL_DISTANCE));
 
-	timePoint = float(timePoint) * InZoomLevel + 0.5f;
+	int timePoint = scrollDistance * InZoomLevel + 0.5f;
 	timePoint += _TimefieldMetrics.HitLine;
 
 	timePoint = _WindowMetrics.Height - timePoint;
@@ -153,6 +162,10 @@ Time TimefieldRenderModule::GetTimeFromScreenPoint(const int InScreenPointY, con
 	int screenPoint = _WindowMetrics.Height - InScreenPointY + ((int)InNoteTimePivot * _TimefieldMetrics.NoteScreenPivot);
 
 	screenPoint -= _TimefieldMetrics.HitLine;
+
+	if (_ScrollVelocityMap)
+		return GetTimeFromScrollDistance(float(screenPoint) / InZoomLevel, InTime, false);
+
 	screenPoint = float(screenPoint) / InZoomLevel - 0.5f;
 
 	const int timePoint = screenPoint + InTime;
@@ -167,9 +180,21 @@ Time TimefieldRenderModule::GetWindowTimePointBegin(const Time InTime, const flo
 
 Time TimefieldRenderModule::GetWindowTimePointEnd(const Time InTime, const float InZoomLevel)
 {
+	//anything scrolling back down from above the window later on is still on screen in between
+	if (_ScrollVelocityMap)
+		return GetTimeFromScrollDistance(float(_WindowMetrics.Height - _TimefieldMetrics.HitLine) / InZoomLevel, InTime, true);
+
 	return GetTimeFromScreenPoint(0, InTime, InZoomLevel);
 }
 
+Time TimefieldRenderModule::GetTimeFromScrollDistance(const float InScrollDistance, const Time InTime, const bool InIsLastTimePoint)
+{
+	const double scrollPosition = _ScrollVelocityMap->GetScrollPosition(InTime) + double(InScrollDistance);
+	const double timePoint = InIsLastTimePoint ? _ScrollVelocityMap->GetLastTimePointBelow(scrollPosition) : _ScrollVelocityMap->GetFirstTimePointReaching(scrollPosition);
+
+	return Time(std::clamp(std::floor(timePoint + 0.5), -double(TIMEFIELD_MAX_TIME_POINT), double(TIMEFIELD_MAX_TIME_POINT)));
+}
+
 Column TimefieldRenderModule::GetColumnFromScreenPoint(const int InScreenPointX) 
 {
 	int inputX = InScreenPointX - _TimefieldMetrics.ColumnSize;
@@ -246,4 +271,9 @@ void TimefieldRenderModule::UpdateMetrics(const WindowMetrics& InWindowMetrics)
 	_TimefieldMetrics.FirstColumnPosition = _TimefieldMetrics.LeftSidePosition + _TimefieldMetrics.SideSpace;
 
 	_TimefieldMetrics.HitLinePosition = _WindowMetrics.Height - _TimefieldMetrics.HitLine;
+}
+
+void TimefieldRenderModule::SetScrollVelocityMap(const ScrollVelocityMap* InScrollVelocityMap)
+{
+	_ScrollVelocityMap = InScrollVelocityMap;
 }
\ No newline at end of file
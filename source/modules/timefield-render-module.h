@@ -41,6 +41,14 @@ public: //data setting
 	void InitializeResources(const int InKeyAmount, const std::filesystem::path& InSkinFolderPath);
 	void UpdateMetrics(const WindowMetrics& InWindowMetrics);
 
+	//lays the time field out the way it scrolls in game, nullptr lays it out linear in time again
+	void SetScrollVelocityMap(const ScrollVelocityMap* InScrollVelocityMap);
+
+private: //data gathering
+
+	//the scroll distance the other way around, either the first time point scrolling past it or the last one not yet there
+	Time GetTimeFromScrollDistance(const float InScrollDistance, const Time InTime, const bool InIsLastTimePoint);
+
 private: //data ownership
 
 	sf::RenderTexture _NoteRenderLayer;
@@ -59,6 +67,8 @@ private: //data ownership
 
 	int _KeyAmount;
 
+	const ScrollVelocityMap* _ScrollVelocityMap = nullptr;
+
 	struct _OnScreenNote 
 	{ 
 		const Note* Note; 
@@ -2,11 +2,18 @@
 
 #include "imgui.h"
 
+#include <algorithm>
+#include <cmath>
+
+//how far a channel reaches out from the middle, between 0 and 1
+static float GetPeakExtent(const WaveFormPeak& InPeak)
+{
+    return float(std::max(std::abs(int(InPeak.Min)), std::abs(int(InPeak.Max)))) / WAVEFORM_PEAK_SCALE;
+}
+
 bool WaveFormModule::StartUp() 
 {
-    _ScalableWaveFormTexture.create(_WaveFormWidth, 8192);
-    _WaveFormLines.setPrimitiveType(sf::Lines);
-    _WaveFormLines.resize(8192 * 2 * 2);
+    _WaveFormQuads.setPrimitiveType(sf::Quads);
 
     return true;
 }
@@ -21,7 +28,7 @@ void WaveFormModule::RenderWaveForm(TimefieldRenderGraph& InOutRenderGraph, cons
 {
     //TODO: Represent lowpass and highpass filters through cool shaders
 
-    if(!_WaveFormData)
+    if(!_WaveFormData || _WaveFormData->GetLevelAmount() == 0 || InWindowHeight <= 0.0f)
         return;
 
     const Time timeHeight = InTimeEnd - InTimeBegin;
@@ -29,55 +36,48 @@ void WaveFormModule::RenderWaveForm(TimefieldRenderGraph& InOutRenderGraph, cons
     if(timeHeight <= 0) 
         return;
 
-    const Time timeStartPoint = (InTimeEnd / timeHeight) * timeHeight;
-    const Time timeOffsetPosition = InTimeEnd - timeStartPoint;
+    //buckets about as long as a pixel, zoomed in past the finest level a bucket just spans several pixels
+    const int level = _WaveFormData->GetLevelForDuration(double(timeHeight) / double(InWindowHeight));
+    const double bucketDuration = _WaveFormData->GetBucketDuration(level);
 
-    _ScalableWaveFormTexture.clear({0, 0, 0, 0});
+    const WaveFormBucket* const buckets = _WaveFormData->GetBuckets(level);
+    const double bucketAmount = double(_WaveFormData->GetBucketAmount(level));
 
-    const float windowHeight = InWindowHeight;
-    const float scale = windowHeight / float(InTimeEnd - InTimeBegin);
+    const size_t firstBucket = size_t(std::clamp(std::floor(double(InTimeBegin) / bucketDuration), 0.0, bucketAmount));
+    const size_t lastBucket = size_t(std::clamp(std::ceil(double(InTimeEnd) / bucketDuration), 0.0, bucketAmount));
 
-    const int lineAmount = timeHeight * 2;
+    const sf::Color backColor  = sf::Color(255, 255, 0, 96);
+    const sf::Color frontColor = sf::Color(0, 255, 255, 128);
 
-    for(int i = 0; i < lineAmount; ++i)
-    {
-        const size_t index = std::min(_SongLengthMilliSeconds, std::max(0, timeStartPoint + timeHeight - i));
-        const WaveFormData waveFormData = _WaveFormData[index];
+    const float halfWidth = float(_WaveFormWidth / 2);
 
-        const float y = float(_ScalableWaveFormTexture.getSize().y - i);
-        const int pointIndex = i * 2;
+    _WaveFormQuads.clear();
 
-        _WaveFormLines[pointIndex].position.x = _WaveFormWidth / 2 - abs(waveFormData.Left * _WaveFormWidth / 2);
-        _WaveFormLines[pointIndex].position.y = y;
+    for(size_t bucketIndex = firstBucket; bucketIndex < lastBucket; ++bucketIndex)
+    {
+        const WaveFormBucket& bucket = buckets[bucketIndex];
 
-        _WaveFormLines[pointIndex + 1].position.x = _WaveFormWidth / 2 + abs(waveFormData.Right * _WaveFormWidth / 2);
-        _WaveFormLines[pointIndex + 1].position.y = y;
+        //later buckets are further up the screen
+        const float top = float((double(InTimeEnd) - double(bucketIndex + 1) * bucketDuration) * InZoomLevel);
+        const float bottom = float((double(InTimeEnd) - double(bucketIndex) * bucketDuration) * InZoomLevel);
 
-        _WaveFormLines[pointIndex].color = sf::Color(255, 255, 255, 255);
-        _WaveFormLines[pointIndex + 1].color = sf::Color(255, 255, 255, 255);
+        AppendBucketQuad(top, bottom, GetPeakExtent(bucket.Left) * halfWidth, GetPeakExtent(bucket.Right) * halfWidth, backColor);
+        AppendBucketQuad(top, bottom, float(bucket.Left.Rms) / WAVEFORM_PEAK_SCALE * halfWidth, float(bucket.Right.Rms) / WAVEFORM_PEAK_SCALE * halfWidth, frontColor);
     }
 
-    _ScalableWaveFormTexture.draw(_WaveFormLines);
-    _ScalableWaveFormSprite.setTexture(_ScalableWaveFormTexture.getTexture()); 
-
-    InOutRenderGraph.SubmitTimefieldRenderCommand(0, InTimeEnd + timeHeight - timeOffsetPosition, [this, scale, InTimeEnd, InWindowHeight](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
+    InOutRenderGraph.SubmitTimefieldRenderCommand(0, InTimeEnd, [this](sf::RenderTarget* const InRenderTarget, const TimefieldMetrics& InTimefieldMetrics, const int InScreenX, const int InScreenY)
     {
+        sf::RenderStates renderStates;
+        renderStates.transform.translate(float(InTimefieldMetrics.LeftSidePosition + InTimefieldMetrics.FieldWidthHalf), float(InScreenY));
 
-        const sf::Color backColor  = sf::Color(255, 255, 0, 96);
-        const sf::Color frontColor = sf::Color(0, 255, 255, 128);
-
-        float positionY = float(InScreenY);
-
-        _ScalableWaveFormSprite.setPosition(InTimefieldMetrics.LeftSidePosition + InTimefieldMetrics.FieldWidthHalf - _WaveFormWidth / 2, positionY);
-        _ScalableWaveFormSprite.setScale(1.0f, scale);
-        _ScalableWaveFormSprite.setColor(backColor);
-
-        InRenderTarget->draw(_ScalableWaveFormSprite);
-
-        _ScalableWaveFormSprite.setColor(frontColor);
-        _ScalableWaveFormSprite.setScale(0.375, scale);
-        _ScalableWaveFormSprite.setPosition(InTimefieldMetrics.LeftSidePosition + InTimefieldMetrics.FieldWidthHalf - _WaveFormWidth / 8 - _WaveFormWidth / 16, positionY);
-
-        InRenderTarget->draw(_ScalableWaveFormSprite);
+        InRenderTarget->draw(_WaveFormQuads, renderStates);
     });
+}
+
+void WaveFormModule::AppendBucketQuad(const float InTop, const float InBottom, const float InLeftExtent, const float InRightExtent, const sf::Color& InColor) 
+{
+    _WaveFormQuads.append(sf::Vertex(sf::Vector2f(-InLeftExtent, InTop), InColor));
+    _WaveFormQuads.append(sf::Vertex(sf::Vector2f(InRightExtent, InTop), InColor));
+    _WaveFormQuads.append(sf::Vertex(sf::Vector2f(InRightExtent, InBottom), InColor));
+    _WaveFormQuads.append(sf::Vertex(sf::Vector2f(-InLeftExtent, InBottom), InColor));
 }
\ No newline at end of file
@@ -18,11 +18,12 @@ public:
 
 private:
 
+    void AppendBucketQuad(const float InTop, const float InBottom, const float InLeftExtent, const float InRightExtent, const sf::Color& InColor);
+
     const int _WaveFormWidth = 256;
-    sf::VertexArray _WaveFormLines;
 
-    sf::RenderTexture _ScalableWaveFormTexture;
-    sf::Sprite _ScalableWaveFormSprite;
+    //one quad for the peaks and one for the rms of every visible bucket, relative to the end of the window
+    sf::VertexArray _WaveFormQuads;
 
     WaveFormData* _WaveFormData = nullptr;
 
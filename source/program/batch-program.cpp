@@ -0,0 +1,473 @@
+#include "batch-program.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "../modules/chart-parser-module.h"
+#include "../modules/beat-module.h"
+#include "../structures/chart.h"
+#include "../structures/atomic-file.h"
+#include "../structures/mapset-archive.h"
+
+#define BATCH_MESSAGE_LENGTH 512
+
+static const char* const static_Usage = "usage: %s --batch=<folder> [--export=osu|qua|sm] [--output=<folder>] [--threads=<amount>] [--report=<file.json>]\n"
+										"  every .osu, .qua, .sm, .ssc and .osz below the folder gets loaded, snapped and checked.\n"
+										"  --export writes every chart again in the given format, into --output or next to the chart if there is none.\n"
+										"  a chart exported into its own format without --output gets written back into its own file.\n";
+
+static bool ParseArgument(const char* InArgument, const char* InName, std::string& OutValue)
+{
+	const size_t nameLength = std::strlen(InName);
+
+	if (std::strncmp(InArgument, InName, nameLength) != 0 || InArgument[nameLength] != '=')
+		return false;
+
+	OutValue = InArgument + nameLength + 1;
+
+	return true;
+}
+
+static std::string ToLowerCase(std::string InText)
+{
+	std::transform(InText.begin(), InText.end(), InText.begin(), [](unsigned char InCharacter) { return char(std::tolower(InCharacter)); });
+
+	return InText;
+}
+
+//difficulty names end up in file names, anything a file system doesn't allow becomes an underscore
+static std::string ToFileName(std::string InText)
+{
+	std::replace_if(InText.begin(), InText.end(), [](const char InCharacter) { return std::strchr("/\\:*?\"<>|", InCharacter) != nullptr; }, '_');
+
+	return InText;
+}
+
+static void AppendJsonText(std::string& OutBuffer, const std::string_view InText)
+{
+	OutBuffer += '"';
+
+	for (const char character : InText)
+	{
+		if (character == '"' || character == '\\')
+		{
+			OutBuffer += '\\';
+			OutBuffer += character;
+		}
+		else if (static_cast<unsigned char>(character) < 0x20)
+		{
+			char escapedCharacter[8];
+			std::snprintf(escapedCharacter, sizeof(escapedCharacter), "\\u%04x", unsigned(character));
+
+			OutBuffer += escapedCharacter;
+		}
+		else
+			OutBuffer += character;
+	}
+
+	OutBuffer += '"';
+}
+
+static void AppendJsonTextList(std::string& OutBuffer, const std::vector<std::string>& InTexts)
+{
+	OutBuffer += '[';
+
+	for (size_t index = 0; index < InTexts.size(); ++index)
+	{
+		if (index)
+			OutBuffer += ',';
+
+		AppendJsonText(OutBuffer, InTexts[index]);
+	}
+
+	OutBuffer += ']';
+}
+
+bool BatchProgram::ParseArguments(const int InArgumentCount, char** InArguments)
+{
+	for (int index = 1; index < InArgumentCount; ++index)
+	{
+		std::string value;
+
+		if (ParseArgument(InArguments[index], "--batch", value))
+			_InputPath = std::filesystem::u8path(value);
+		else if (ParseArgument(InArguments[index], "--export", value) && (value == "osu" || value == "qua" || value == "sm"))
+			_ExportExtension = "." + value;
+		else if (ParseArgument(InArguments[index], "--output", value))
+			_OutputPath = std::filesystem::u8path(value);
+		else if (ParseArgument(InArguments[index], "--threads", value))
+			_ThreadAmount = size_t(std::max(1, std::atoi(value.c_str())));
+		else if (ParseArgument(InArguments[index], "--report", value))
+			_ReportPath = std::filesystem::u8path(value);
+		else
+		{
+			std::fprintf(stderr, static_Usage, InArguments[0]);
+			return false;
+		}
+	}
+
+	if (_InputPath.empty())
+	{
+		std::fprintf(stderr, static_Usage, InArguments[0]);
+		return false;
+	}
+
+	return true;
+}
+
+int BatchProgram::Run()
+{
+	const auto timeBegin = std::chrono::steady_clock::now();
+
+	std::vector<std::filesystem::path> filePaths;
+	std::error_code errorCode;
+
+	std::filesystem::recursive_directory_iterator directoryIt(_InputPath, std::filesystem::directory_options::skip_permission_denied, errorCode);
+
+	if (errorCode)
+	{
+		std::fprintf(stderr, "can't read %s: %s\n", _InputPath.u8string().c_str(), errorCode.message().c_str());
+		return 2;
+	}
+
+	for (; directoryIt != std::filesystem::recursive_directory_iterator(); directoryIt.increment(errorCode))
+	{
+		const std::filesystem::path extension = directoryIt->path().extension();
+
+		if (directoryIt->is_regular_file(errorCode) && (extension == ".osu" || extension == ".qua" || extension == ".sm" || extension == ".ssc" || extension == ".osz"))
+			filePaths.push_back(directoryIt->path());
+	}
+
+	//the report comes out in the same order on every run, no matter which worker got which file
+	std::sort(filePaths.begin(), filePaths.end());
+
+	std::vector<FileReport> reports(filePaths.size());
+
+	const size_t threadAmount = std::max<size_t>(1, std::min(filePaths.size(), _ThreadAmount ? _ThreadAmount : size_t(std::max(1u, std::thread::hardware_concurrency()))));
+	std::atomic<size_t> nextIndex = 0;
+
+	//every worker has modules of its own, neither of them is meant to be used by several threads at once
+	auto processFiles = [this, &filePaths, &reports, &nextIndex]()
+	{
+		ChartParserModule parserModule;
+		BeatModule beatModule;
+		beatModule.StartUp();
+
+		for (size_t index = nextIndex++; index < filePaths.size(); index = nextIndex++)
+			ProcessFile(filePaths[index], parserModule, beatModule, reports[index]);
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadAmount - 1);
+
+	for (size_t worker = 1; worker < threadAmount; ++worker)
+		workers.emplace_back(processFiles);
+
+	processFiles();
+
+	for (auto& worker : workers)
+		worker.join();
+
+	Summary summary = Summarize(reports);
+	summary.ThreadAmount = threadAmount;
+	summary.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeBegin).count();
+
+	PrintReport(reports, summary);
+
+	if (!_ReportPath.empty() && !WriteJsonReport(reports, summary))
+	{
+		std::fprintf(stderr, "can't write the report to %s\n", _ReportPath.u8string().c_str());
+		return 1;
+	}
+
+	return summary.UnreadableFileAmount || summary.ErrorChartAmount || summary.FailedExportAmount ? 1 : 0;
+}
+
+void BatchProgram::ProcessFile(const std::filesystem::path& InPath, ChartParserModule& InOutParserModule, BeatModule& InOutBeatModule, FileReport& OutReport) const
+{
+	OutReport.Path = InPath;
+
+	std::vector<ChartSetEntry> entries = InOutParserModule.LoadChartFile(InPath);
+
+	//the charts of an archive reference their song by its entry name
+	std::vector<std::string> archivedFileNames;
+
+	if (InPath.extension() == ".osz")
+	{
+		ArchiveReader archiveReader;
+
+		if (archiveReader.Open(InPath))
+		{
+			for (const std::string& archivedFileName : archiveReader.GetEntryNames())
+				archivedFileNames.push_back(ToLowerCase(archivedFileName));
+		}
+	}
+
+	for (ChartSetEntry& entry : entries)
+	{
+		Chart* const chart = entry.LoadedChart;
+
+		ChartReport& chartReport = OutReport.Charts.emplace_back();
+		chartReport.Path = entry.Path;
+		chartReport.DifficultyName = chart->DifficultyName;
+
+		chart->AdaptTimeSliceLength();
+		InOutBeatModule.AssignNotesToSnapsInChart(chart);
+
+		const ChartSnapshot snapshot = chart->TakeSnapshot();
+
+		ValidateChart(snapshot, archivedFileNames, chartReport);
+
+		if (!_ExportExtension.empty())
+		{
+			chartReport.ExportPath = GetExportPath(InPath, entry);
+
+			//the folder exists already when the chart gets written back into its own file
+			std::error_code errorCode;
+			std::filesystem::create_directories(chartReport.ExportPath.parent_path(), errorCode);
+
+			chartReport.HasExportFailed = !InOutParserModule.SaveChartFile(chartReport.ExportPath, snapshot);
+		}
+
+		delete chart;
+	}
+}
+
+void BatchProgram::ValidateChart(const ChartSnapshot& InSnapshot, const std::vector<std::string>& InArchivedFileNames, ChartReport& OutReport) const
+{
+	char message[BATCH_MESSAGE_LENGTH];
+
+	if (InSnapshot.KeyAmount <= 0)
+		OutReport.Errors.push_back("no key amount");
+
+	if (InSnapshot.BpmPoints.empty())
+		OutReport.Errors.push_back("no bpm points");
+
+	for (const BpmPoint& bpmPoint : InSnapshot.BpmPoints)
+	{
+		if (std::isfinite(bpmPoint.BeatLength) && bpmPoint.BeatLength > 0.0)
+			continue;
+
+		std::snprintf(message, sizeof(message), "invalid bpm point at %d ms", bpmPoint.TimePoint);
+		OutReport.Errors.push_back(message);
+	}
+
+	//the notes come in time order, a note overlaps when it starts before the previous one of its column is over
+	std::vector<Time> columnEnds(size_t(std::max(InSnapshot.KeyAmount, 0)), std::numeric_limits<Time>::min());
+
+	size_t overlappingAmount = 0, invertedHoldAmount = 0, outsideColumnAmount = 0, earlyAmount = 0, unsnappedAmount = 0;
+	Time firstOverlapTime = 0;
+	Column firstOverlapColumn = 0;
+
+	for (const auto& [column, note] : InSnapshot.Notes)
+	{
+		//the end of a hold is checked along with its beginning
+		if (note.Type == Note::EType::HoldEnd)
+			continue;
+
+		OutReport.NoteAmount++;
+
+		if (column >= Column(columnEnds.size()))
+		{
+			outsideColumnAmount++;
+			continue;
+		}
+
+		if (note.TimePoint <= columnEnds[column] && overlappingAmount++ == 0)
+		{
+			firstOverlapTime = note.TimePoint;
+			firstOverlapColumn = column;
+		}
+
+		const bool isHold = note.Type == Note::EType::HoldBegin;
+
+		invertedHoldAmount += isHold && note.TimePointEnd <= note.TimePointBegin;
+		earlyAmount += !InSnapshot.BpmPoints.empty() && note.TimePoint < InSnapshot.BpmPoints.front().TimePoint;
+		unsnappedAmount += note.BeatSnap < 0;
+
+		columnEnds[column] = std::max(columnEnds[column], isHold ? note.TimePointEnd : note.TimePoint);
+	}
+
+	if (overlappingAmount)
+	{
+		std::snprintf(message, sizeof(message), "%zu overlapping notes, the first at %d ms in column %d", overlappingAmount, firstOverlapTime, int(firstOverlapColumn) + 1);
+		OutReport.Errors.push_back(message);
+	}
+
+	if (invertedHoldAmount)
+	{
+		std::snprintf(message, sizeof(message), "%zu holds end before they begin", invertedHoldAmount);
+		OutReport.Errors.push_back(message);
+	}
+
+	if (outsideColumnAmount)
+	{
+		std::snprintf(message, sizeof(message), "%zu notes outside of the %d columns", outsideColumnAmount, InSnapshot.KeyAmount);
+		OutReport.Errors.push_back(message);
+	}
+
+	if (earlyAmount)
+	{
+		std::snprintf(message, sizeof(message), "%zu notes before the first bpm point", earlyAmount);
+		OutReport.Warnings.push_back(message);
+	}
+
+	if (unsnappedAmount)
+	{
+		std::snprintf(message, sizeof(message), "%zu notes without a snap", unsnappedAmount);
+		OutReport.Warnings.push_back(message);
+	}
+
+	std::filesystem::path archivePath;
+	std::string audioEntryName;
+
+	bool hasAudio = false;
+
+	if (SplitArchivePath(InSnapshot.AudioPath, archivePath, audioEntryName))
+		hasAudio = std::find(InArchivedFileNames.begin(), InArchivedFileNames.end(), ToLowerCase(audioEntryName)) != InArchivedFileNames.end();
+	else
+	{
+		std::error_code errorCode;
+		hasAudio = !InSnapshot.AudioPath.empty() && std::filesystem::is_regular_file(InSnapshot.AudioPath, errorCode);
+	}
+
+	if (InSnapshot.AudioPath.empty())
+		OutReport.Warnings.push_back("no song");
+	else if (!hasAudio)
+	{
+		std::snprintf(message, sizeof(message), "song \"%s\" not found", InSnapshot.AudioPath.filename().u8string().c_str());
+		OutReport.Warnings.push_back(message);
+	}
+}
+
+std::filesystem::path BatchProgram::GetExportPath(const std::filesystem::path& InFilePath, const ChartSetEntry& InEntry) const
+{
+	const bool isStepmaniaFile = InFilePath.extension() == ".sm" || InFilePath.extension() == ".ssc";
+	const bool isArchive = InFilePath.extension() == ".osz";
+
+	//the format of a stepmania chart is the one of its file, the one of an archived chart is the one of its entry
+	const std::filesystem::path extension = isStepmaniaFile ? InFilePath.extension() : InEntry.Path.extension();
+
+	if (_OutputPath.empty() && extension == _ExportExtension)
+		return InEntry.Path;
+
+	std::filesystem::path folderPath = InFilePath.parent_path();
+
+	if (!_OutputPath.empty())
+		folderPath = _OutputPath / folderPath.lexically_relative(_InputPath);
+
+	std::string fileName = InEntry.Path.stem().u8string();
+
+	//an archive becomes a folder of its own, the charts of a stepmania file each become a file named after the file and the chart
+	if (isArchive)
+		folderPath /= InFilePath.stem();
+	else if (isStepmaniaFile)
+		fileName = InFilePath.stem().u8string() + " " + InEntry.Path.filename().u8string() + " [" + ToFileName(InEntry.LoadedChart->DifficultyName) + "]";
+
+	return folderPath / std::filesystem::u8path(fileName + _ExportExtension);
+}
+
+BatchProgram::Summary BatchProgram::Summarize(const std::vector<FileReport>& InReports) const
+{
+	Summary summary;
+	summary.FileAmount = InReports.size();
+
+	for (const FileReport& fileReport : InReports)
+	{
+		summary.UnreadableFileAmount += fileReport.Charts.empty();
+		summary.ChartAmount += fileReport.Charts.size();
+
+		for (const ChartReport& chartReport : fileReport.Charts)
+		{
+			summary.NoteAmount += chartReport.NoteAmount;
+			summary.ErrorChartAmount += !chartReport.Errors.empty();
+			summary.WarningChartAmount += !chartReport.Warnings.empty();
+			summary.ExportAmount += !chartReport.ExportPath.empty() && !chartReport.HasExportFailed;
+			summary.FailedExportAmount += chartReport.HasExportFailed;
+		}
+	}
+
+	return summary;
+}
+
+void BatchProgram::PrintReport(const std::vector<FileReport>& InReports, const Summary& InSummary) const
+{
+	for (const FileReport& fileReport : InReports)
+	{
+		if (fileReport.Charts.empty())
+			std::printf("error   %s: can't be loaded\n", fileReport.Path.u8string().c_str());
+
+		for (const ChartReport& chartReport : fileReport.Charts)
+		{
+			const std::string chartPath = chartReport.Path.u8string();
+
+			for (const std::string& error : chartReport.Errors)
+				std::printf("error   %s [%s]: %s\n", chartPath.c_str(), chartReport.DifficultyName.c_str(), error.c_str());
+
+			for (const std::string& warning : chartReport.Warnings)
+				std::printf("warning %s [%s]: %s\n", chartPath.c_str(), chartReport.DifficultyName.c_str(), warning.c_str());
+
+			if (chartReport.HasExportFailed)
+				std::printf("error   %s [%s]: can't be exported to %s\n", chartPath.c_str(), chartReport.DifficultyName.c_str(), chartReport.ExportPath.u8string().c_str());
+		}
+	}
+
+	std::printf("%zu files, %zu charts, %zu notes: %zu unreadable files, %zu charts with errors, %zu charts with warnings, %zu exported, %zu failed exports in %.2f s on %zu threads\n",
+		InSummary.FileAmount, InSummary.ChartAmount, InSummary.NoteAmount, InSummary.UnreadableFileAmount, InSummary.ErrorChartAmount, InSummary.WarningChartAmount,
+		InSummary.ExportAmount, InSummary.FailedExportAmount, InSummary.Seconds, InSummary.ThreadAmount);
+}
+
+bool BatchProgram::WriteJsonReport(const std::vector<FileReport>& InReports, const Summary& InSummary) const
+{
+	char summary[BATCH_MESSAGE_LENGTH];
+	std::snprintf(summary, sizeof(summary), "{\"summary\":{\"files\":%zu,\"unreadable_files\":%zu,\"charts\":%zu,\"notes\":%zu,\"charts_with_errors\":%zu,\"charts_with_warnings\":%zu,\"exported\":%zu,\"failed_exports\":%zu,\"seconds\":%.3f,\"threads\":%zu},\n\"files\":[",
+		InSummary.FileAmount, InSummary.UnreadableFileAmount, InSummary.ChartAmount, InSummary.NoteAmount, InSummary.ErrorChartAmount, InSummary.WarningChartAmount,
+		InSummary.ExportAmount, InSummary.FailedExportAmount, InSummary.Seconds, InSummary.ThreadAmount);
+
+	std::string report = summary;
+
+	for (size_t fileIndex = 0; fileIndex < InReports.size(); ++fileIndex)
+	{
+		const FileReport& fileReport = InReports[fileIndex];
+
+		report += fileIndex ? ",\n{\"path\":" : "\n{\"path\":";
+		AppendJsonText(report, fileReport.Path.u8string());
+		report += ",\"charts\":[";
+
+		for (size_t chartIndex = 0; chartIndex < fileReport.Charts.size(); ++chartIndex)
+		{
+			const ChartReport& chartReport = fileReport.Charts[chartIndex];
+
+			report += chartIndex ? ",{\"path\":" : "{\"path\":";
+			AppendJsonText(report, chartReport.Path.u8string());
+			report += ",\"difficulty\":";
+			AppendJsonText(report, chartReport.DifficultyName);
+			report += ",\"notes\":" + std::to_string(chartReport.NoteAmount) + ",\"errors\":";
+			AppendJsonTextList(report, chartReport.Errors);
+			report += ",\"warnings\":";
+			AppendJsonTextList(report, chartReport.Warnings);
+
+			if (!chartReport.ExportPath.empty())
+			{
+				report += ",\"export\":";
+				AppendJsonText(report, chartReport.ExportPath.u8string());
+				report += chartReport.HasExportFailed ? ",\"export_failed\":true" : ",\"export_failed\":false";
+			}
+
+			report += "}";
+		}
+
+		report += "]}";
+	}
+
+	report += "\n]}\n";
+
+	return WriteFileAtomically(_ReportPath, report);
+}
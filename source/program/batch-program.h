@@ -0,0 +1,78 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../structures/chart-set.h"
+
+class ChartParserModule;
+class BeatModule;
+struct ChartSnapshot;
+
+/*
+* the editor without a window, gl context or audio device, so it can run on a build server.
+* every chart file below the input folder gets loaded, snapped and checked, one file per worker thread, and can be exported again in any format.
+* the report lists every chart with a problem and ends with a summary, the exit code is 1 as soon as any chart has an error.
+*/
+class BatchProgram
+{
+public:
+
+	bool ParseArguments(const int InArgumentCount, char** InArguments);
+	int Run();
+
+private:
+
+	struct ChartReport
+	{
+		std::filesystem::path Path;
+		std::string DifficultyName;
+		size_t NoteAmount = 0;
+
+		std::vector<std::string> Errors;
+		std::vector<std::string> Warnings;
+
+		std::filesystem::path ExportPath;
+		bool HasExportFailed = false;
+	};
+
+	//a stepmania file or an archive holds several charts, a file that can't be loaded has none
+	struct FileReport
+	{
+		std::filesystem::path Path;
+		std::vector<ChartReport> Charts;
+	};
+
+	struct Summary
+	{
+		size_t FileAmount = 0;
+		size_t UnreadableFileAmount = 0;
+		size_t ChartAmount = 0;
+		size_t NoteAmount = 0;
+		size_t ErrorChartAmount = 0;
+		size_t WarningChartAmount = 0;
+		size_t ExportAmount = 0;
+		size_t FailedExportAmount = 0;
+
+		size_t ThreadAmount = 0;
+		double Seconds = 0.0;
+	};
+
+	void ProcessFile(const std::filesystem::path& InPath, ChartParserModule& InOutParserModule, BeatModule& InOutBeatModule, FileReport& OutReport) const;
+	void ValidateChart(const ChartSnapshot& InSnapshot, const std::vector<std::string>& InArchivedFileNames, ChartReport& OutReport) const;
+	std::filesystem::path GetExportPath(const std::filesystem::path& InFilePath, const ChartSetEntry& InEntry) const;
+
+	Summary Summarize(const std::vector<FileReport>& InReports) const;
+	void PrintReport(const std::vector<FileReport>& InReports, const Summary& InSummary) const;
+	bool WriteJsonReport(const std::vector<FileReport>& InReports, const Summary& InSummary) const;
+
+	std::filesystem::path _InputPath;
+	std::filesystem::path _OutputPath;
+	std::filesystem::path _ReportPath;
+
+	//empty when nothing gets exported
+	std::string _ExportExtension;
+
+	size_t _ThreadAmount = 0;
+};
@@ -5,6 +5,7 @@
 #include "../utilities/imgui/std/imgui-stdlib.h"
 
 #include "../structures/chart-metadata.h"
+#include "../structures/chart-set.h"
 #include "../structures/configuration.h"
 
 namespace
@@ -21,6 +22,12 @@ namespace
 
 	Chart* SelectedChart = nullptr;
 
+	std::vector<ChartSetEntry> ChartSet;
+	size_t SelectedDifficultyIndex = 0;
+
+	std::filesystem::path LoadedAudioPath;
+	std::filesystem::path LoadedBackgroundPath;
+
 	float ZoomLevel = 1.0f;
 	int CurrentSnap = 2;
 	
@@ -40,6 +47,7 @@ namespace
 //module includes
 #include "../modules/imgui-module.h"
 #include "../modules/chart-parser-module.h"
+#include "../modules/journal-module.h"
 #include "../modules/dialog-module.h"
 #include "../modules/timefield-render-module.h"
 #include "../modules/audio-module.h"
@@ -49,6 +57,7 @@ namespace
 #include "../modules/background-module.h"
 #include "../modules/minimap-module.h"
 #include "../modules/waveform-module.h"
+#include "../modules/spectrogram-module.h"
 #include "../modules/popup-module.h"
 #include "../modules/notification-module.h"
 #include "../modules/shortcut-menu-module.h"
@@ -66,8 +75,10 @@ void Program::RegisterModules()
 	ModuleManager::Register<MiniMapModule>();
 	ModuleManager::Register<NotificationModule>();
 	ModuleManager::Register<ChartParserModule>();
+	ModuleManager::Register<JournalModule>();
 	ModuleManager::Register<AudioModule>();
 	ModuleManager::Register<WaveFormModule>();
+	ModuleManager::Register<SpectrogramModule>();
 	ModuleManager::Register<BeatModule>();
 	ModuleManager::Register<EditModule>();
 	ModuleManager::Register<DebugModule>();
@@ -78,6 +89,12 @@ void Program::InnerStartUp()
 	MOD(ImGuiModule).Init(_RenderWindow);
 	MOD(NotificationModule).SetStartY(_WindowMetrics.MenuBarHeight + 16);
 
+	//the journal keeps the edits as unsaved until the saving thread has actually written them
+	MOD(ChartParserModule).RegisterOnSaveFinishedCallback([](const size_t InSaveIndex, const bool InHasSucceeded)
+	{
+		MOD(JournalModule).OnChartSaveFinished(InSaveIndex, InHasSucceeded);
+	});
+
 	if(Config.Load())
 	{
 		SetConfig(Config);
@@ -93,6 +110,9 @@ void Program::InnerTick()
 	if(ShouldSetUpMetadata)
 		SetUpMetadata();
 
+	//handed over every tick, the selected chart might have changed in between
+	MOD(TimefieldRenderModule).SetScrollVelocityMap(SelectedChart && Config.PreviewScrollVelocities ? &SelectedChart->GetScrollVelocityMap() : nullptr);
+
 	if (!SelectedChart)
 		return;
 
@@ -102,19 +122,29 @@ void Program::InnerTick()
 	WindowTimeBegin = MOD(TimefieldRenderModule).GetWindowTimePointBegin(MOD(AudioModule).GetTimeMilliSeconds(), ZoomLevel);
 	WindowTimeEnd = MOD(TimefieldRenderModule).GetWindowTimePointEnd(MOD(AudioModule).GetTimeMilliSeconds(), ZoomLevel);
 
+	//scroll velocities can bring notes from anywhere in the song on screen, but nothing from outside of it
+	if (Config.PreviewScrollVelocities)
+	{
+		WindowTimeBegin = std::max(WindowTimeBegin, std::min(0, MOD(AudioModule).GetTimeMilliSeconds()));
+		WindowTimeEnd = std::min(WindowTimeEnd, std::max(MOD(AudioModule).GetSongLengthMilliSeconds(), SelectedChart->GetLastNoteTimePoint()));
+	}
+
 	if (!ImGui::GetIO().WantCaptureMouse && !ImGui::GetIO().WantTextInput)
 		InputActions();
 
 	MOD(TimefieldRenderModule).UpdateMetrics(_WindowMetrics);
 	MOD(BeatModule).GenerateTimeRangeBeatLines(WindowTimeBegin, WindowTimeEnd, SelectedChart, CurrentSnap);
 
-	SelectedChart->IterateNotesInTimeRange(WindowTimeBegin - TIMESLICE_LENGTH, WindowTimeEnd, [this](Note &InNote, const Column InColumn) {
-		sf::Int8 alpha = 255;
+	const sf::Int8 noteAlpha = MOD(EditModule).IsEditModeActive<BpmEditMode>() || MOD(EditModule).IsEditModeActive<ScrollVelocityEditMode>() ? 128 : 255;
 
-		if (MOD(EditModule).IsEditModeActive<BpmEditMode>())
-			alpha = 128;
+	SelectedChart->IterateNotesInTimeRange(WindowTimeBegin, WindowTimeEnd, [this, noteAlpha](const Note &InNote, const Column InColumn) {
+		NoteRenderGraph.SubmitNoteRenderCommand(InNote, InColumn, noteAlpha);
+	});
 
-		NoteRenderGraph.SubmitNoteRenderCommand(InNote, InColumn, alpha);
+	//holds that began before the window are only on screen through their body
+	SelectedChart->IterateHoldsInTimeRange(WindowTimeBegin, WindowTimeEnd, [this, noteAlpha](const Note &InNote, const Column InColumn) {
+		if (InNote.TimePoint < WindowTimeBegin)
+			NoteRenderGraph.SubmitNoteRenderCommand(InNote, InColumn, noteAlpha);
 	});
 
 	MOD(EditModule).SubmitToRenderGraph(PreviewRenderGraph, WindowTimeBegin, WindowTimeEnd);
@@ -125,7 +155,11 @@ void Program::InnerRender(sf::RenderTarget *const InOutRenderTarget)
 	if (!SelectedChart)
 		return;
 
-	if(Config.ShowWaveform)
+	//the spectrogram and the waveform are drawn linear in time, they can't follow the scroll velocities
+	if (Config.ShowSpectrogram && !Config.PreviewScrollVelocities)
+		MOD(SpectrogramModule).RenderSpectrogram(WaveformRenderGraph, WindowTimeBegin, WindowTimeEnd, ZoomLevel);
+
+	if(Config.ShowWaveform && !Config.PreviewScrollVelocities)
 		MOD(WaveFormModule).RenderWaveForm(WaveformRenderGraph, WindowTimeBegin, WindowTimeEnd, MOD(TimefieldRenderModule).GetTimefieldMetrics().LeftSidePosition + MOD(TimefieldRenderModule).GetTimefieldMetrics().FieldWidthHalf, ZoomLevel, InOutRenderTarget->getView().getSize().y);
 		//MOD(WaveFormModule).RenderWaveFormPolygon(InOutRenderTarget, WindowTimeBegin, WindowTimeEnd, MOD(TimefieldRenderModule).GetTimefieldMetrics().LeftSidePosition + MOD(TimefieldRenderModule).GetTimefieldMetrics().FieldWidthHalf, ZoomLevel, InOutRenderTarget->getView().getSize().y);
 
@@ -157,7 +191,8 @@ void Program::InnerRender(sf::RenderTarget *const InOutRenderTarget)
 
 void Program::InnerShutDown()
 {
-	delete SelectedChart;
+	for (auto& entry : ChartSet)
+		delete entry.LoadedChart;
 }
 
 //************************************************************************************************************************************************************************************
@@ -177,7 +212,7 @@ void Program::MenuBar()
 
 			if (MOD(ShortcutMenuModule).MenuItem("Open", sf::Keyboard::Key::LControl, sf::Keyboard::Key::O))
 			{
-				MOD(DialogModule).OpenFileDialog(".osu;.sm", [this](const std::string &InPath) 
+				MOD(DialogModule).OpenFileDialog(".osu;.qua;.sm;.ssc;.osz", [this](const std::string &InPath) 
 				{
 					OpenChart(InPath);
 				});
@@ -189,7 +224,22 @@ void Program::MenuBar()
 				ShouldSetUpMetadata = true;
 
 			if (MOD(ShortcutMenuModule).MenuItem("Save", sf::Keyboard::Key::LControl, sf::Keyboard::Key::S) && SelectedChart)
-				MOD(ChartParserModule).ExportChartSet(SelectedChart);
+			{
+				MOD(JournalModule).OnChartSaveQueued(MOD(ChartParserModule).ExportChartSetInBackground(SelectedChart));
+			}
+
+			if (MOD(ShortcutMenuModule).MenuItem("Export Mapset (.osz)", sf::Keyboard::Unknown, sf::Keyboard::Unknown) && SelectedChart)
+			{
+				MOD(DialogModule).OpenFolderDialog([this](const std::string &InPath) 
+				{
+					std::string archiveFileName = SelectedChart->Artist;
+					archiveFileName += " - ";
+					archiveFileName += SelectedChart->SongTitle;
+					archiveFileName += ".osz";
+
+					MOD(ChartParserModule).ExportMapsetArchiveInBackground(SelectedChart, std::filesystem::path(InPath) / archiveFileName);
+				});
+			}
 
 			MOD(ShortcutMenuModule).Separator();
 
@@ -204,6 +254,9 @@ void Program::MenuBar()
 		{
 			if (MOD(ShortcutMenuModule).MenuItem("Undo", sf::Keyboard::Key::LControl, sf::Keyboard::Key::Z) && SelectedChart && SelectedChart->Undo())
 				PUSH_NOTIFICATION("Undo");
+
+			if (MOD(ShortcutMenuModule).MenuItem("Redo", sf::Keyboard::Key::LControl, sf::Keyboard::Key::Y) && SelectedChart && SelectedChart->Redo())
+				PUSH_NOTIFICATION("Redo");
 			
 			if (MOD(ShortcutMenuModule).MenuItem("Select All", sf::Keyboard::Key::LControl, sf::Keyboard::Key::A))
 				MOD(EditModule).OnSelectAll();
@@ -230,6 +283,22 @@ void Program::MenuBar()
 			MOD(ShortcutMenuModule).EndMenu();
 		}
 
+		if (ImGui::BeginMenu("Difficulty", !ChartSet.empty()))
+		{
+			for (size_t index = 0; index < ChartSet.size(); ++index)
+			{
+				const Chart* const chart = ChartSet[index].LoadedChart;
+
+				std::string difficultyName = chart->DifficultyName.empty() ? ChartSet[index].Path.stem().string() : chart->DifficultyName;
+				difficultyName += "##" + std::to_string(index);
+
+				if (ImGui::MenuItem(difficultyName.c_str(), nullptr, index == SelectedDifficultyIndex) && index != SelectedDifficultyIndex)
+					SelectDifficulty(index);
+			}
+
+			ImGui::EndMenu();
+		}
+
 		if (ImGui::BeginMenu("Options"))
 		{
 			std::string togglePitch = "Toggle Pitch (";
@@ -273,6 +342,45 @@ void Program::MenuBar()
 
 			if (ImGui::Checkbox("Show Waveform", &Config.ShowWaveform)) Config.Save();
 
+			if (ImGui::Checkbox("Show Spectrogram", &Config.ShowSpectrogram))
+			{
+				Config.Save();
+				GenerateSpectrogram();
+			}
+
+			if (ImGui::BeginMenu("Spectrogram Resolution"))
+			{
+				for (const int windowSize : { 512, 1024, 2048, 4096 })
+				{
+					if (ImGui::MenuItem(("Window " + std::to_string(windowSize)).c_str(), nullptr, Config.SpectrogramWindowSize == windowSize))
+					{
+						Config.SpectrogramWindowSize = windowSize;
+						Config.SpectrogramHopSize = std::min(Config.SpectrogramHopSize, windowSize);
+						Config.Save();
+
+						GenerateSpectrogram();
+					}
+				}
+
+				ImGui::Separator();
+
+				//a hop longer than the window would skip over samples
+				for (const int hopSize : { 128, 256, 512, 1024 })
+				{
+					if (ImGui::MenuItem(("Hop " + std::to_string(hopSize)).c_str(), nullptr, Config.SpectrogramHopSize == hopSize, hopSize <= Config.SpectrogramWindowSize))
+					{
+						Config.SpectrogramHopSize = hopSize;
+						Config.Save();
+
+						GenerateSpectrogram();
+					}
+				}
+
+				ImGui::EndMenu();
+			}
+
+			if (ImGui::Checkbox("Preview Scroll Velocities", &Config.PreviewScrollVelocities)) Config.Save();
+
 			if (ImGui::Checkbox("Use Auto Timing", &Config.UseAutoTiming))
 			{
 				EditMode::static_Flags.UseAutoTiming = Config.UseAutoTiming;
@@ -395,7 +503,13 @@ void Program::SetUpMetadata()
 			{
 				if(ImGui::Button("Save"))
 				{
-					OpenChart(MOD(ChartParserModule).SetChartMetadata(SelectedChart, ChartMetadataSetup));
+					bool hasSaved = false;
+					const std::string chartPath = MOD(ChartParserModule).SetChartMetadata(SelectedChart, ChartMetadataSetup, &hasSaved);
+
+					if (hasSaved)
+						MOD(JournalModule).OnChartSaved();
+
+					OpenChart(chartPath);
 
 					ShouldSetUpMetadata = ShouldSetUpNewChart = OutOpen = false;
 				}
@@ -468,6 +582,12 @@ void Program::InputActions()
 		PUSH_NOTIFICATION("Bpm Edit Mode");
 	}
 
+	if (MOD(InputModule).WasKeyPressed(sf::Keyboard::Key::Num4))
+	{
+		MOD(EditModule).SetEditMode<ScrollVelocityEditMode>();
+		PUSH_NOTIFICATION("Scroll Velocity Edit Mode");
+	}
+
 	if (MOD(InputModule).IsCtrlKeyDown())
 	{
 		if (MOD(InputModule).IsScrollingUp())
@@ -543,10 +663,20 @@ void Program::InputActions()
 
 void Program::OpenChart(const std::string& InPath) 
 {
-	SelectedChart = MOD(ChartParserModule).ParseAndGenerateChartSet(InPath);
+	//every difficulty next to the chart gets loaded with it, the opened one becomes the active one
+	std::vector<ChartSetEntry> chartSet = MOD(ChartParserModule).ParseAndGenerateChartSetFolder(InPath);
+
+	//an archive or a stepmania file opened as a whole starts with its first difficulty
+	const std::filesystem::path openedFileName = std::filesystem::path(InPath).filename();
+	const std::filesystem::path openedExtension = std::filesystem::path(InPath).extension();
+	const bool isOpenedAsWhole = openedExtension == ".osz" || openedExtension == ".sm" || openedExtension == ".ssc";
+	const auto openedEntry = isOpenedAsWhole ? chartSet.begin() : std::find_if(chartSet.begin(), chartSet.end(), [&openedFileName](const ChartSetEntry& InEntry) { return InEntry.Path.filename() == openedFileName; });
 	
-	if (!SelectedChart)
+	if (openedEntry == chartSet.end())
 	{
+		for (auto& entry : chartSet)
+			delete entry.LoadedChart;
+
 		PUSH_NOTIFICATION("File not found! It might have been deleted?");
 		Config.DeleteRecentFile(InPath);
 		Config.Save();
@@ -556,20 +686,92 @@ void Program::OpenChart(const std::string& InPath)
 	Config.RegisterRecentFile(InPath);
 	Config.Save();
 
-	MOD(BeatModule).AssignNotesToSnapsInChart(SelectedChart);
-	MOD(AudioModule).LoadAudio(SelectedChart->AudioPath);
+	const size_t openedIndex = size_t(openedEntry - chartSet.begin());
+
+	//the journal keeps the unsaved edits of the closed chart, reopening the set recovers them
+	MOD(JournalModule).Close();
+
+	for (auto& entry : ChartSet)
+		delete entry.LoadedChart;
+
+	ChartSet = std::move(chartSet);
+	SelectedChart = nullptr;
+
+	//the files might have been replaced since they have been loaded
+	LoadedAudioPath.clear();
+	LoadedBackgroundPath.clear();
+
+	SelectDifficulty(openedIndex);
+}
+
+void Program::SelectDifficulty(const size_t InIndex)
+{
+	Chart* const previousChart = SelectedChart;
+
+	if (previousChart)
+		ChartSet[SelectedDifficultyIndex].HasUnsavedEdits = MOD(JournalModule).Close();
+
+	ChartSetEntry& entry = ChartSet[InIndex];
+
+	SelectedDifficultyIndex = InIndex;
+	SelectedChart = entry.LoadedChart;
+
+	MOD(ChartParserModule).SetCurrentChart(entry);
+
+	if (entry.IsPrepared)
+	{
+		MOD(JournalModule).Resume(SelectedChart, entry.Path, entry.HasUnsavedEdits);
+	}
+	else
+	{
+		SelectedChart->SetEditHistoryMemoryBudget(size_t(Config.EditHistoryMemoryBudgetMegaBytes) * 1024 * 1024);
+
+		const bool hasRecoveredJournal = MOD(JournalModule).Open(SelectedChart, entry.Path);
+
+		if(Config.TimeSliceLength > 0)
+			SelectedChart->SetTimeSliceLength(Config.TimeSliceLength);
+		else
+			SelectedChart->AdaptTimeSliceLength();
+
+		//the cache holds the chart file with its snaps, the recovered edits on top of it still need theirs
+		if (!entry.IsFromCache || hasRecoveredJournal)
+			MOD(BeatModule).AssignNotesToSnapsInChart(SelectedChart);
+
+		if (!entry.IsFromCache && !hasRecoveredJournal)
+			MOD(ChartParserModule).StoreChartCache(SelectedChart);
+
+		entry.IsPrepared = true;
+	}
+
+	//the difficulties of a set share their song, switching between them keeps the loaded audio and its waveform
+	if (SelectedChart->AudioPath != LoadedAudioPath)
+	{
+		MOD(AudioModule).LoadAudio(SelectedChart->AudioPath);
+		MOD(WaveFormModule).SetWaveFormData(MOD(AudioModule).GenerateAndGetWaveformData(SelectedChart->AudioPath), MOD(AudioModule).GetSongLengthMilliSeconds());
+
+		LoadedAudioPath = SelectedChart->AudioPath;
+
+		GenerateSpectrogram();
+	}
+
+	if (SelectedChart->BackgroundPath != LoadedBackgroundPath)
+	{
+		MOD(BackgroundModule).LoadBackground(SelectedChart->BackgroundPath);
+		LoadedBackgroundPath = SelectedChart->BackgroundPath;
+	}
+
+	if (!previousChart || previousChart->KeyAmount != SelectedChart->KeyAmount)
+		MOD(TimefieldRenderModule).InitializeResources(SelectedChart->KeyAmount, Config.SkinFolderPath);
+
 	MOD(EditModule).SetChart(SelectedChart);
-	MOD(BackgroundModule).LoadBackground(SelectedChart->BackgroundPath);
-	MOD(TimefieldRenderModule).InitializeResources(SelectedChart->KeyAmount, Config.SkinFolderPath);
 	MOD(MiniMapModule).Generate(SelectedChart, MOD(TimefieldRenderModule).GetSkin(), MOD(AudioModule).GetSongLengthMilliSeconds());
-	MOD(WaveFormModule).SetWaveFormData(MOD(AudioModule).GenerateAndGetWaveformData(SelectedChart->AudioPath), MOD(AudioModule).GetSongLengthMilliSeconds());
 	ChartMetadataSetup = MOD(ChartParserModule).GetChartMetadata(SelectedChart);
 
-	SelectedChart->RegisterOnModifiedCallback([this](TimeSlice &InTimeSlice) 
+	//called once per committed transaction with the whole range it has touched
+	SelectedChart->RegisterOnModifiedCallback([this](const Time InTimeBegin, const Time InTimeEnd) 
 	{
-		//TODO: replicate the timeslice method to optimize when "re-generating"
-		MOD(BeatModule).AssignNotesToSnapsInTimeSlice(SelectedChart, InTimeSlice);
-		MOD(MiniMapModule).GeneratePortion(InTimeSlice, MOD(TimefieldRenderModule).GetSkin());
+		MOD(BeatModule).AssignNotesToSnapsInTimeRange(SelectedChart, InTimeBegin, InTimeEnd);
+		MOD(MiniMapModule).GeneratePortion(SelectedChart, InTimeBegin, InTimeEnd, MOD(TimefieldRenderModule).GetSkin());
 	});
 }
 
@@ -623,9 +825,23 @@ void Program::UpdateCursor()
 
 	EditCursor.HoveredNotes.clear();
 
-	MOD(TimefieldRenderModule).GetOverlappedOnScreenNotes(EditCursor.CursorColumn, EditCursor.Y, EditCursor.HoveredNotes);
+	std::vector<const Note*> overlappedNotes;
+	MOD(TimefieldRenderModule).GetOverlappedOnScreenNotes(EditCursor.CursorColumn, EditCursor.Y, overlappedNotes);
+
+	std::sort(overlappedNotes.begin(), overlappedNotes.end(), [](const Note *lhs, const Note *rhs) { return lhs->TimePoint < rhs->TimePoint; });
+
+	for (const Note* overlappedNote : overlappedNotes)
+		if (overlappedNote->Handle.IsValid())
+			EditCursor.HoveredNotes.push_back(overlappedNote->Handle);
+}
+
+void Program::GenerateSpectrogram()
+{
+	//only computed while it is shown, turning it on picks up the song that is loaded by then
+	if (!Config.ShowSpectrogram || LoadedAudioPath.empty())
+		return;
 
-	std::sort(EditCursor.HoveredNotes.begin(), EditCursor.HoveredNotes.end(), [](const Note *lhs, const Note *rhs) { return lhs->TimePoint < rhs->TimePoint; });
+	MOD(SpectrogramModule).SetSpectrogramData(MOD(AudioModule).GenerateAndGetSpectrogramData(LoadedAudioPath, Config.SpectrogramWindowSize, Config.SpectrogramHopSize));
 }
 
 void Program::SetConfig(const Configuration& InConfig)
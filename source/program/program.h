@@ -24,6 +24,8 @@ public: //abstractions
 	void ApplyDeltaToZoom(const float InDelta);
 	void UpdateCursor();
 	void OpenChart(const std::string& InPath);
+	void SelectDifficulty(const size_t InIndex);
+	void GenerateSpectrogram();
 	void SetConfig(const Configuration& InConfig);
 
 public: //meta program sequences
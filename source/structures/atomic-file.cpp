@@ -0,0 +1,183 @@
+#include "atomic-file.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <stdio.h>
+#endif
+
+#ifndef _WIN32
+//the rename itself only survives a crash once the directory entry is flushed as well
+static void SyncFolder(const std::filesystem::path& InPath)
+{
+	std::filesystem::path folderPath = InPath.parent_path();
+
+	if (folderPath.empty())
+		folderPath = ".";
+
+	const int folderDescriptor = open(folderPath.c_str(), O_RDONLY);
+
+	if (folderDescriptor >= 0)
+	{
+		fsync(folderDescriptor);
+		close(folderDescriptor);
+	}
+}
+#endif
+
+bool WriteFileAtomically(const std::filesystem::path& InPath, std::string_view InContent)
+{
+	std::filesystem::path temporaryPath = InPath;
+	temporaryPath += ".tmp";
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileW(temporaryPath.wstring().c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	bool hasSucceeded = true;
+
+	while (hasSucceeded && !InContent.empty())
+	{
+		DWORD writtenBytes = 0;
+		const DWORD bytesToWrite = DWORD(std::min<size_t>(InContent.size(), 1 << 30));
+
+		hasSucceeded = WriteFile(fileHandle, InContent.data(), bytesToWrite, &writtenBytes, nullptr) && writtenBytes > 0;
+		InContent.remove_prefix(writtenBytes);
+	}
+
+	hasSucceeded = hasSucceeded && FlushFileBuffers(fileHandle);
+	CloseHandle(fileHandle);
+
+	hasSucceeded = hasSucceeded && MoveFileExW(temporaryPath.wstring().c_str(), InPath.wstring().c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+
+	if (!hasSucceeded)
+		DeleteFileW(temporaryPath.wstring().c_str());
+
+	return hasSucceeded;
+#else
+	const int fileDescriptor = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	if (fileDescriptor < 0)
+		return false;
+
+	bool hasSucceeded = true;
+
+	while (hasSucceeded && !InContent.empty())
+	{
+		const ssize_t writtenBytes = write(fileDescriptor, InContent.data(), InContent.size());
+
+		hasSucceeded = writtenBytes > 0;
+
+		if (hasSucceeded)
+			InContent.remove_prefix(size_t(writtenBytes));
+	}
+
+	hasSucceeded = hasSucceeded && fsync(fileDescriptor) == 0;
+	hasSucceeded = close(fileDescriptor) == 0 && hasSucceeded;
+
+	hasSucceeded = hasSucceeded && rename(temporaryPath.c_str(), InPath.c_str()) == 0;
+
+	if (!hasSucceeded)
+	{
+		unlink(temporaryPath.c_str());
+		return false;
+	}
+
+	SyncFolder(InPath);
+
+	return true;
+#endif
+}
+
+bool CommitFileAtomically(const std::filesystem::path& InTemporaryPath, const std::filesystem::path& InPath)
+{
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileW(InTemporaryPath.wstring().c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	bool hasSucceeded = fileHandle != INVALID_HANDLE_VALUE && FlushFileBuffers(fileHandle);
+
+	if (fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+
+	hasSucceeded = hasSucceeded && MoveFileExW(InTemporaryPath.wstring().c_str(), InPath.wstring().c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+
+	if (!hasSucceeded)
+		DeleteFileW(InTemporaryPath.wstring().c_str());
+
+	return hasSucceeded;
+#else
+	const int fileDescriptor = open(InTemporaryPath.c_str(), O_RDONLY);
+
+	bool hasSucceeded = fileDescriptor >= 0 && fsync(fileDescriptor) == 0;
+
+	if (fileDescriptor >= 0)
+		hasSucceeded = close(fileDescriptor) == 0 && hasSucceeded;
+
+	hasSucceeded = hasSucceeded && rename(InTemporaryPath.c_str(), InPath.c_str()) == 0;
+
+	if (!hasSucceeded)
+	{
+		unlink(InTemporaryPath.c_str());
+		return false;
+	}
+
+	SyncFolder(InPath);
+
+	return true;
+#endif
+}
+
+bool AppendFileDurably(const std::filesystem::path& InPath, std::string_view InContent)
+{
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileW(InPath.wstring().c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	bool hasSucceeded = true;
+
+	while (hasSucceeded && !InContent.empty())
+	{
+		DWORD writtenBytes = 0;
+		const DWORD bytesToWrite = DWORD(std::min<size_t>(InContent.size(), 1 << 30));
+
+		hasSucceeded = WriteFile(fileHandle, InContent.data(), bytesToWrite, &writtenBytes, nullptr) && writtenBytes > 0;
+		InContent.remove_prefix(writtenBytes);
+	}
+
+	hasSucceeded = hasSucceeded && FlushFileBuffers(fileHandle);
+	CloseHandle(fileHandle);
+
+	return hasSucceeded;
+#else
+	const int fileDescriptor = open(InPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+
+	if (fileDescriptor < 0)
+		return false;
+
+	bool hasSucceeded = true;
+
+	while (hasSucceeded && !InContent.empty())
+	{
+		const ssize_t writtenBytes = write(fileDescriptor, InContent.data(), InContent.size());
+
+		hasSucceeded = writtenBytes > 0;
+
+		if (hasSucceeded)
+			InContent.remove_prefix(size_t(writtenBytes));
+	}
+
+	hasSucceeded = hasSucceeded && fsync(fileDescriptor) == 0;
+
+	return close(fileDescriptor) == 0 && hasSucceeded;
+#endif
+}
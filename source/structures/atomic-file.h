@@ -0,0 +1,16 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+/*
+* writes the content into a temporary file next to the target, flushes it to disk and only then renames it into place.
+* a crash or a full disk while writing leaves either the previous file or the new one, but never a truncated one.
+*/
+bool WriteFileAtomically(const std::filesystem::path& InPath, std::string_view InContent);
+
+//the same for a temporary file that has been written some other way, it gets flushed to disk and renamed over the target
+bool CommitFileAtomically(const std::filesystem::path& InTemporaryPath, const std::filesystem::path& InPath);
+
+//appends the content to the end of the file, creating it if needed, and only returns once it is flushed to disk
+bool AppendFileDurably(const std::filesystem::path& InPath, std::string_view InContent);
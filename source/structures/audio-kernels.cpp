@@ -0,0 +1,370 @@
+#include "audio-kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+//sse2 is part of x86-64 itself, only avx2 has to be asked the cpu for
+#if defined(__x86_64__) || defined(_M_X64)
+	#define AUDIO_KERNELS_X86
+
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define AUDIO_KERNELS_AVX2
+	#else
+		//only these functions get compiled for avx2, the rest of the program keeps running on any x86 cpu
+		#define AUDIO_KERNELS_AVX2 __attribute__((target("avx2,fma")))
+	#endif
+#endif
+
+static void ReduceChannelScalar(const float* InSamples, const size_t InSampleAmount, ChannelPeaks& InOutPeaks)
+{
+	for (size_t index = 0; index < InSampleAmount; ++index)
+	{
+		const float sample = InSamples[index];
+
+		InOutPeaks.Min = std::min(InOutPeaks.Min, sample);
+		InOutPeaks.Max = std::max(InOutPeaks.Max, sample);
+		InOutPeaks.SquareSum += double(sample) * double(sample);
+	}
+}
+
+static void ReduceStereoScalar(const float* InSamples, const size_t InFrameAmount, ChannelPeaks& InOutLeftPeaks, ChannelPeaks& InOutRightPeaks)
+{
+	for (size_t index = 0; index < InFrameAmount; ++index)
+	{
+		const float left = InSamples[index * 2];
+		const float right = InSamples[index * 2 + 1];
+
+		InOutLeftPeaks.Min = std::min(InOutLeftPeaks.Min, left);
+		InOutLeftPeaks.Max = std::max(InOutLeftPeaks.Max, left);
+		InOutLeftPeaks.SquareSum += double(left) * double(left);
+
+		InOutRightPeaks.Min = std::min(InOutRightPeaks.Min, right);
+		InOutRightPeaks.Max = std::max(InOutRightPeaks.Max, right);
+		InOutRightPeaks.SquareSum += double(right) * double(right);
+	}
+}
+
+static float FindAbsMaxScalar(const float* InSamples, const size_t InSampleAmount)
+{
+	float absMax = 0.0f;
+
+	for (size_t index = 0; index < InSampleAmount; ++index)
+		absMax = std::max(absMax, std::abs(InSamples[index]));
+
+	return absMax;
+}
+
+static void DownmixStereoScalar(const float* InSamples, const size_t InFrameAmount, float* OutSamples)
+{
+	for (size_t index = 0; index < InFrameAmount; ++index)
+		OutSamples[index] = (InSamples[index * 2] + InSamples[index * 2 + 1]) * 0.5f;
+}
+
+#ifdef AUDIO_KERNELS_X86
+
+/*
+* the vector kernels keep one running min, max and square sum per lane and only fold the lanes together at the end of a block.
+* square sums are added up in float within a block and in double across blocks, which is plenty for levels meant to be looked at.
+*/
+
+static void ReduceChannelSse2(const float* InSamples, const size_t InSampleAmount, ChannelPeaks& InOutPeaks)
+{
+	const size_t vectorAmount = InSampleAmount / 4 * 4;
+
+	if (vectorAmount > 0)
+	{
+		__m128 minimum = _mm_set1_ps(InOutPeaks.Min);
+		__m128 maximum = _mm_set1_ps(InOutPeaks.Max);
+		__m128 squareSum = _mm_setzero_ps();
+
+		for (size_t index = 0; index < vectorAmount; index += 4)
+		{
+			const __m128 samples = _mm_loadu_ps(InSamples + index);
+
+			minimum = _mm_min_ps(minimum, samples);
+			maximum = _mm_max_ps(maximum, samples);
+			squareSum = _mm_add_ps(squareSum, _mm_mul_ps(samples, samples));
+		}
+
+		alignas(16) float minimums[4], maximums[4], squareSums[4];
+		_mm_store_ps(minimums, minimum);
+		_mm_store_ps(maximums, maximum);
+		_mm_store_ps(squareSums, squareSum);
+
+		InOutPeaks.Min = std::min({ minimums[0], minimums[1], minimums[2], minimums[3] });
+		InOutPeaks.Max = std::max({ maximums[0], maximums[1], maximums[2], maximums[3] });
+		InOutPeaks.SquareSum += double(squareSums[0]) + double(squareSums[1]) + double(squareSums[2]) + double(squareSums[3]);
+	}
+
+	ReduceChannelScalar(InSamples + vectorAmount, InSampleAmount - vectorAmount, InOutPeaks);
+}
+
+static void ReduceStereoSse2(const float* InSamples, const size_t InFrameAmount, ChannelPeaks& InOutLeftPeaks, ChannelPeaks& InOutRightPeaks)
+{
+	const size_t vectorFrameAmount = InFrameAmount / 2 * 2;
+
+	if (vectorFrameAmount > 0)
+	{
+		__m128 minimum = _mm_setr_ps(InOutLeftPeaks.Min, InOutRightPeaks.Min, InOutLeftPeaks.Min, InOutRightPeaks.Min);
+		__m128 maximum = _mm_setr_ps(InOutLeftPeaks.Max, InOutRightPeaks.Max, InOutLeftPeaks.Max, InOutRightPeaks.Max);
+		__m128 squareSum = _mm_setzero_ps();
+
+		for (size_t index = 0; index < vectorFrameAmount * 2; index += 4)
+		{
+			const __m128 samples = _mm_loadu_ps(InSamples + index);
+
+			minimum = _mm_min_ps(minimum, samples);
+			maximum = _mm_max_ps(maximum, samples);
+			squareSum = _mm_add_ps(squareSum, _mm_mul_ps(samples, samples));
+		}
+
+		alignas(16) float minimums[4], maximums[4], squareSums[4];
+		_mm_store_ps(minimums, minimum);
+		_mm_store_ps(maximums, maximum);
+		_mm_store_ps(squareSums, squareSum);
+
+		InOutLeftPeaks.Min = std::min(minimums[0], minimums[2]);
+		InOutLeftPeaks.Max = std::max(maximums[0], maximums[2]);
+		InOutLeftPeaks.SquareSum += double(squareSums[0]) + double(squareSums[2]);
+
+		InOutRightPeaks.Min = std::min(minimums[1], minimums[3]);
+		InOutRightPeaks.Max = std::max(maximums[1], maximums[3]);
+		InOutRightPeaks.SquareSum += double(squareSums[1]) + double(squareSums[3]);
+	}
+
+	ReduceStereoScalar(InSamples + vectorFrameAmount * 2, InFrameAmount - vectorFrameAmount, InOutLeftPeaks, InOutRightPeaks);
+}
+
+static float FindAbsMaxSse2(const float* InSamples, const size_t InSampleAmount)
+{
+	const size_t vectorAmount = InSampleAmount / 4 * 4;
+
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 absMax = _mm_setzero_ps();
+
+	for (size_t index = 0; index < vectorAmount; index += 4)
+		absMax = _mm_max_ps(absMax, _mm_and_ps(_mm_loadu_ps(InSamples + index), absMask));
+
+	alignas(16) float absMaxs[4];
+	_mm_store_ps(absMaxs, absMax);
+
+	return std::max({ absMaxs[0], absMaxs[1], absMaxs[2], absMaxs[3], FindAbsMaxScalar(InSamples + vectorAmount, InSampleAmount - vectorAmount) });
+}
+
+static void DownmixStereoSse2(const float* InSamples, const size_t InFrameAmount, float* OutSamples)
+{
+	const size_t vectorFrameAmount = InFrameAmount / 4 * 4;
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	for (size_t index = 0; index < vectorFrameAmount; index += 4)
+	{
+		const __m128 first = _mm_loadu_ps(InSamples + index * 2);
+		const __m128 second = _mm_loadu_ps(InSamples + index * 2 + 4);
+
+		const __m128 left = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 right = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+
+		_mm_storeu_ps(OutSamples + index, _mm_mul_ps(_mm_add_ps(left, right), half));
+	}
+
+	DownmixStereoScalar(InSamples + vectorFrameAmount * 2, InFrameAmount - vectorFrameAmount, OutSamples + vectorFrameAmount);
+}
+
+//folds the upper half of the lanes onto the lower one, lane n and n + 4 always belong to the same channel.
+//the upper halves of the registers get cleared afterwards, sse code running with them dirty gets slowed down a lot on some cpus
+AUDIO_KERNELS_AVX2 static void FoldLanes(const __m256 InMinimum, const __m256 InMaximum, const __m256 InSquareSum, float* OutMinimums, float* OutMaximums, float* OutSquareSums)
+{
+	_mm_store_ps(OutMinimums, _mm_min_ps(_mm256_castps256_ps128(InMinimum), _mm256_extractf128_ps(InMinimum, 1)));
+	_mm_store_ps(OutMaximums, _mm_max_ps(_mm256_castps256_ps128(InMaximum), _mm256_extractf128_ps(InMaximum, 1)));
+	_mm_store_ps(OutSquareSums, _mm_add_ps(_mm256_castps256_ps128(InSquareSum), _mm256_extractf128_ps(InSquareSum, 1)));
+
+	_mm256_zeroupper();
+}
+
+AUDIO_KERNELS_AVX2 static void ReduceChannelAvx2(const float* InSamples, const size_t InSampleAmount, ChannelPeaks& InOutPeaks)
+{
+	const size_t vectorAmount = InSampleAmount / 8 * 8;
+
+	if (vectorAmount > 0)
+	{
+		__m256 minimum = _mm256_set1_ps(InOutPeaks.Min);
+		__m256 maximum = _mm256_set1_ps(InOutPeaks.Max);
+		__m256 squareSum = _mm256_setzero_ps();
+
+		for (size_t index = 0; index < vectorAmount; index += 8)
+		{
+			const __m256 samples = _mm256_loadu_ps(InSamples + index);
+
+			minimum = _mm256_min_ps(minimum, samples);
+			maximum = _mm256_max_ps(maximum, samples);
+			squareSum = _mm256_fmadd_ps(samples, samples, squareSum);
+		}
+
+		alignas(16) float minimums[4], maximums[4], squareSums[4];
+		FoldLanes(minimum, maximum, squareSum, minimums, maximums, squareSums);
+
+		InOutPeaks.Min = std::min({ minimums[0], minimums[1], minimums[2], minimums[3] });
+		InOutPeaks.Max = std::max({ maximums[0], maximums[1], maximums[2], maximums[3] });
+		InOutPeaks.SquareSum += double(squareSums[0]) + double(squareSums[1]) + double(squareSums[2]) + double(squareSums[3]);
+	}
+
+	ReduceChannelScalar(InSamples + vectorAmount, InSampleAmount - vectorAmount, InOutPeaks);
+}
+
+AUDIO_KERNELS_AVX2 static void ReduceStereoAvx2(const float* InSamples, const size_t InFrameAmount, ChannelPeaks& InOutLeftPeaks, ChannelPeaks& InOutRightPeaks)
+{
+	const size_t vectorFrameAmount = InFrameAmount / 4 * 4;
+
+	if (vectorFrameAmount > 0)
+	{
+		const float leftMin = InOutLeftPeaks.Min, rightMin = InOutRightPeaks.Min;
+		const float leftMax = InOutLeftPeaks.Max, rightMax = InOutRightPeaks.Max;
+
+		__m256 minimum = _mm256_setr_ps(leftMin, rightMin, leftMin, rightMin, leftMin, rightMin, leftMin, rightMin);
+		__m256 maximum = _mm256_setr_ps(leftMax, rightMax, leftMax, rightMax, leftMax, rightMax, leftMax, rightMax);
+		__m256 squareSum = _mm256_setzero_ps();
+
+		for (size_t index = 0; index < vectorFrameAmount * 2; index += 8)
+		{
+			const __m256 samples = _mm256_loadu_ps(InSamples + index);
+
+			minimum = _mm256_min_ps(minimum, samples);
+			maximum = _mm256_max_ps(maximum, samples);
+			squareSum = _mm256_fmadd_ps(samples, samples, squareSum);
+		}
+
+		alignas(16) float minimums[4], maximums[4], squareSums[4];
+		FoldLanes(minimum, maximum, squareSum, minimums, maximums, squareSums);
+
+		InOutLeftPeaks.Min = std::min(minimums[0], minimums[2]);
+		InOutLeftPeaks.Max = std::max(maximums[0], maximums[2]);
+		InOutLeftPeaks.SquareSum += double(squareSums[0]) + double(squareSums[2]);
+
+		InOutRightPeaks.Min = std::min(minimums[1], minimums[3]);
+		InOutRightPeaks.Max = std::max(maximums[1], maximums[3]);
+		InOutRightPeaks.SquareSum += double(squareSums[1]) + double(squareSums[3]);
+	}
+
+	ReduceStereoScalar(InSamples + vectorFrameAmount * 2, InFrameAmount - vectorFrameAmount, InOutLeftPeaks, InOutRightPeaks);
+}
+
+AUDIO_KERNELS_AVX2 static float FindAbsMaxAvx2(const float* InSamples, const size_t InSampleAmount)
+{
+	const size_t vectorAmount = InSampleAmount / 8 * 8;
+
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	__m256 absMax = _mm256_setzero_ps();
+
+	for (size_t index = 0; index < vectorAmount; index += 8)
+		absMax = _mm256_max_ps(absMax, _mm256_and_ps(_mm256_loadu_ps(InSamples + index), absMask));
+
+	alignas(16) float absMaxs[4];
+	_mm_store_ps(absMaxs, _mm_max_ps(_mm256_castps256_ps128(absMax), _mm256_extractf128_ps(absMax, 1)));
+	_mm256_zeroupper();
+
+	return std::max({ absMaxs[0], absMaxs[1], absMaxs[2], absMaxs[3], FindAbsMaxScalar(InSamples + vectorAmount, InSampleAmount - vectorAmount) });
+}
+
+AUDIO_KERNELS_AVX2 static void DownmixStereoAvx2(const float* InSamples, const size_t InFrameAmount, float* OutSamples)
+{
+	const size_t vectorFrameAmount = InFrameAmount / 8 * 8;
+	const __m256 half = _mm256_set1_ps(0.5f);
+
+	for (size_t index = 0; index < vectorFrameAmount; index += 8)
+	{
+		const __m256 first = _mm256_loadu_ps(InSamples + index * 2);
+		const __m256 second = _mm256_loadu_ps(InSamples + index * 2 + 8);
+
+		//the shuffle stays within 128 bit halves, the 64 bit permute puts the frame pairs back into order
+		const __m256 left = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m256 right = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+		const __m256 mono = _mm256_mul_ps(_mm256_add_ps(left, right), half);
+
+		_mm256_storeu_ps(OutSamples + index, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(mono), _MM_SHUFFLE(3, 1, 2, 0))));
+	}
+
+	_mm256_zeroupper();
+
+	DownmixStereoScalar(InSamples + vectorFrameAmount * 2, InFrameAmount - vectorFrameAmount, OutSamples + vectorFrameAmount);
+}
+
+static bool IsAvx2Supported()
+{
+#ifdef _MSC_VER
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+
+	if (cpuInfo[0] < 7)
+		return false;
+
+	//fma and avx2 came together, both need the os to save the ymm registers
+	__cpuid(cpuInfo, 1);
+	const bool hasOsSupport = (cpuInfo[2] & (1 << 27)) && (cpuInfo[2] & (1 << 28)) && (cpuInfo[2] & (1 << 12));
+
+	__cpuidex(cpuInfo, 7, 0);
+	const bool hasAvx2 = cpuInfo[1] & (1 << 5);
+
+	return hasOsSupport && hasAvx2 && (_xgetbv(0) & 6) == 6;
+#else
+	__builtin_cpu_init();
+
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+#endif
+
+static const AudioKernels static_ScalarKernels = { "scalar", ReduceChannelScalar, ReduceStereoScalar, FindAbsMaxScalar, DownmixStereoScalar };
+
+#ifdef AUDIO_KERNELS_X86
+static const AudioKernels static_Sse2Kernels = { "sse2", ReduceChannelSse2, ReduceStereoSse2, FindAbsMaxSse2, DownmixStereoSse2 };
+static const AudioKernels static_Avx2Kernels = { "avx2", ReduceChannelAvx2, ReduceStereoAvx2, FindAbsMaxAvx2, DownmixStereoAvx2 };
+#endif
+
+bool IsAudioKernelSetSupported(const EAudioKernelSet InKernelSet)
+{
+	switch (InKernelSet)
+	{
+#ifdef AUDIO_KERNELS_X86
+	case EAudioKernelSet::Sse2:
+		return true;
+	case EAudioKernelSet::Avx2:
+	{
+		static const bool isAvx2Supported = IsAvx2Supported();
+		return isAvx2Supported;
+	}
+#endif
+	case EAudioKernelSet::Scalar:
+		return true;
+	default:
+		return false;
+	}
+}
+
+const AudioKernels& GetAudioKernels(const EAudioKernelSet InKernelSet)
+{
+	if (!IsAudioKernelSetSupported(InKernelSet))
+		return static_ScalarKernels;
+
+	switch (InKernelSet)
+	{
+#ifdef AUDIO_KERNELS_X86
+	case EAudioKernelSet::Sse2:
+		return static_Sse2Kernels;
+	case EAudioKernelSet::Avx2:
+		return static_Avx2Kernels;
+#endif
+	default:
+		return static_ScalarKernels;
+	}
+}
+
+const AudioKernels& GetAudioKernels()
+{
+	static const AudioKernels& bestKernels = GetAudioKernels(IsAudioKernelSetSupported(EAudioKernelSet::Avx2) ? EAudioKernelSet::Avx2 : IsAudioKernelSetSupported(EAudioKernelSet::Sse2) ? EAudioKernelSet::Sse2 : EAudioKernelSet::Scalar);
+
+	return bestKernels;
+}
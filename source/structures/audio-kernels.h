@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+/*
+* reduction kernels over blocks of float pcm, for the waveform and anything else that has to go over every sample of a song.
+* every kernel exists as plain scalar code and, on x86-64, as sse2 and avx2 versions. the widest set the cpu supports gets picked at runtime.
+* interleaved stereo is read as it comes out of the decoder, even lanes are the left channel and odd lanes the right one.
+*/
+
+//accumulates over as many blocks as it gets passed, the rms of everything so far is the root of the square sum over the sample amount
+struct ChannelPeaks
+{
+	float Min = std::numeric_limits<float>::max();
+	float Max = std::numeric_limits<float>::lowest();
+	double SquareSum = 0.0;
+};
+
+struct AudioKernels
+{
+	const char* Name;
+
+	void (*ReduceChannel)(const float* InSamples, const size_t InSampleAmount, ChannelPeaks& InOutPeaks);
+	void (*ReduceStereo)(const float* InSamples, const size_t InFrameAmount, ChannelPeaks& InOutLeftPeaks, ChannelPeaks& InOutRightPeaks);
+	float (*FindAbsMax)(const float* InSamples, const size_t InSampleAmount);
+
+	//the mono output holds one sample per frame and may not overlap the input
+	void (*DownmixStereo)(const float* InSamples, const size_t InFrameAmount, float* OutSamples);
+};
+
+enum class EAudioKernelSet
+{
+	Scalar,
+	Sse2,
+	Avx2
+};
+
+bool IsAudioKernelSetSupported(const EAudioKernelSet InKernelSet);
+
+//falls back to the scalar kernels for a set the cpu doesn't support
+const AudioKernels& GetAudioKernels(const EAudioKernelSet InKernelSet);
+
+//the widest supported set, detected once on first use
+const AudioKernels& GetAudioKernels();
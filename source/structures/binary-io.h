@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+/*
+* raw binary values appended to and read back from a byte buffer, in the byte order of the machine.
+* meant for files that never leave the machine they were written on, like caches and journals.
+*/
+
+template<typename T>
+inline void WriteBinaryValue(std::string& OutBuffer, const T& InValue)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written as raw bytes");
+
+	const size_t offset = OutBuffer.size();
+	OutBuffer.resize(offset + sizeof(T));
+
+	std::memcpy(&OutBuffer[offset], &InValue, sizeof(T));
+}
+
+template<typename T>
+inline bool ReadBinaryValue(std::string_view& InOutView, T& OutValue)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read as raw bytes");
+
+	if (InOutView.size() < sizeof(T))
+		return false;
+
+	std::memcpy(&OutValue, InOutView.data(), sizeof(T));
+	InOutView.remove_prefix(sizeof(T));
+
+	return true;
+}
+
+inline void WriteBinaryString(std::string& OutBuffer, const std::string_view InString)
+{
+	WriteBinaryValue(OutBuffer, uint32_t(InString.size()));
+	OutBuffer.append(InString.data(), InString.size());
+}
+
+inline bool ReadBinaryString(std::string_view& InOutView, std::string& OutString)
+{
+	uint32_t length = 0;
+
+	if (!ReadBinaryValue(InOutView, length) || InOutView.size() < length)
+		return false;
+
+	OutString.assign(InOutView.data(), length);
+	InOutView.remove_prefix(length);
+
+	return true;
+}
+
+//fnv-1a over whole words, it only has to tell different versions of the same file apart
+inline uint64_t HashContent(const std::string_view InContent)
+{
+	uint64_t hash = 14695981039346656037ull;
+	size_t index = 0;
+
+	for (; index + sizeof(uint64_t) <= InContent.size(); index += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, InContent.data() + index, sizeof(uint64_t));
+
+		hash = (hash ^ word) * 1099511628211ull;
+	}
+
+	for (; index < InContent.size(); ++index)
+		hash = (hash ^ uint8_t(InContent[index])) * 1099511628211ull;
+
+	return hash;
+}
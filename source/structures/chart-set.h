@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+struct Chart;
+
+//identifies the exact version of a chart file, the cache is only valid for that one
+struct ChartSource
+{
+	uint64_t Size = 0;
+	int64_t WriteTime = 0;
+	uint64_t Hash = 0;
+};
+
+/*
+* one difficulty of a mapset folder, all difficulties of a folder get loaded together and stay loaded while switching between them.
+* a difficulty only gets its journal, beat snaps and cache the first time it becomes the active one.
+*/
+struct ChartSetEntry
+{
+	Chart* LoadedChart = nullptr;
+
+	std::filesystem::path Path;
+	ChartSource Source;
+
+	bool IsFromCache = false;
+	bool IsPrepared = false;
+	bool HasUnsavedEdits = false;
+};
@@ -2,11 +2,13 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 #include <set>
+#include <tuple>
 #include <unordered_set>
 #include <limits>
 
-void NoteReferenceCollection::PushNote(Column InColumn, Note* InNote) 
+void NoteReferenceCollection::PushNote(Column InColumn, const Note& InNote) 
 {
 	HasNotes = true;
 	NoteAmount++;
@@ -15,18 +17,18 @@ void NoteReferenceCollection::PushNote(Column InColumn, Note* InNote)
 		ColumnNoteCount[InColumn] = 0;
 
 	ColumnNoteCount[InColumn] += 1;
-	Notes[InColumn].insert(InNote);
+	Notes[InColumn].insert(InNote.Handle);
 
 	HighestColumnAmount = std::max(HighestColumnAmount, ColumnNoteCount[InColumn]);
 
-	switch (InNote->Type)
+	switch (InNote.Type)
 	{
 	case Note::EType::Common:
-		TrySetMinMaxTime(InNote->TimePoint);
+		TrySetMinMaxTime(InNote.TimePoint);
 		break;
 
 	case Note::EType::HoldBegin:
-		TrySetMinMaxTime(InNote->TimePointEnd);
+		TrySetMinMaxTime(InNote.TimePointEnd);
 		break;
 	}
 }
@@ -50,606 +52,1767 @@ void NoteReferenceCollection::TrySetMinMaxTime(Time InTime)
 	MaxTimePoint = std::max(MaxTimePoint, InTime);
 }
 
-bool Chart::PlaceNote(const Time InTime, const Column InColumn, const int InBeatSnap)
+void HoldIndex::Insert(const Time InTimeBegin, const Time InTimeEnd)
 {
-	if (IsAPotentialNoteDuplicate(InTime, InColumn))
-		return false;
-
-	RegisterTimeSliceHistory(InTime);
-	InjectNote(InTime, InColumn, Note::EType::Common, -1, -1, InBeatSnap);
+	const Hold hold = { InTimeBegin, InTimeEnd };
+	auto holdIt = Holds.insert(std::upper_bound(Holds.begin(), Holds.end(), hold), hold);
 
-	return true;
+	MaxTimePointEnds.resize(Holds.size());
+	UpdateMaxTimePointEnds(holdIt - Holds.begin());
 }
 
-bool Chart::PlaceHold(const Time InTimeBegin, const Time InTimeEnd, const Column InColumn, const int InBeatSnap, const int InBeatSnapEnd)
+bool HoldIndex::Erase(const Time InTimeBegin, const Time InTimeEnd)
 {
-	if (InTimeBegin == InTimeEnd)
-		return PlaceNote(InTimeBegin, InColumn, InBeatSnap);
+	const Hold hold = { InTimeBegin, InTimeEnd };
+	auto holdIt = std::lower_bound(Holds.begin(), Holds.end(), hold);
 
-	if (IsAPotentialNoteDuplicate(InTimeBegin, InColumn) || IsAPotentialNoteDuplicate(InTimeEnd, InColumn))
+	if (holdIt == Holds.end() || holdIt->TimePointBegin != InTimeBegin || holdIt->TimePointEnd != InTimeEnd)
 		return false;
 
-	RegisterTimeSliceHistoryRanged(InTimeBegin, InTimeEnd);
+	const size_t index = holdIt - Holds.begin();
+	Holds.erase(holdIt);
 
-	InjectHold(InTimeBegin, InTimeEnd, InColumn, InBeatSnap);
+	MaxTimePointEnds.resize(Holds.size());
+	UpdateMaxTimePointEnds(index);
 
 	return true;
 }
 
-bool Chart::PlaceBpmPoint(const Time InTime, const double InBpm, const double InBeatLength)
+void HoldIndex::Rebuild(const std::vector<Note>& InNotes)
 {
-	RegisterTimeSliceHistory(InTime);
-	InjectBpmPoint(InTime, InBpm, InBeatLength);
+	Holds.clear();
 
-	return true;
+	for (const auto& note : InNotes)
+		if (note.Type == Note::EType::HoldBegin)
+			Holds.push_back({ note.TimePointBegin, note.TimePointEnd });
+
+	std::sort(Holds.begin(), Holds.end());
+
+	MaxTimePointEnds.resize(Holds.size());
+	UpdateMaxTimePointEnds(0);
 }
 
-void Chart::BulkPlaceNotes(const std::vector<std::pair<Column, Note>> &InNotes, const bool InSkipHistoryRegistering, const bool InSkipOnModified)
+void HoldIndex::GetOverlappingRange(const Time InTimeBegin, const Time InTimeEnd, size_t& OutFirst, size_t& OutLast) const
 {
-	Time timePointMin = InNotes.front().second.TimePoint;
-	Time timePointMax = InNotes.back().second.TimePoint;
-
-	// - TIMESLICE_LENGTH and + TIMESLICE_LENGTH accounts for potential resnaps (AAAAAA)
-	if(!InSkipHistoryRegistering)
-		RegisterTimeSliceHistoryRanged(timePointMin - TIMESLICE_LENGTH, timePointMax + TIMESLICE_LENGTH);
+	//everything before the first maximum reaching the range has ended already, everything from the upper bound on begins after it
+	OutFirst = std::lower_bound(MaxTimePointEnds.begin(), MaxTimePointEnds.end(), InTimeBegin) - MaxTimePointEnds.begin();
+	OutLast = std::upper_bound(Holds.begin(), Holds.end(), InTimeEnd, [](const Time InTime, const Hold& InHold) { return InTime < InHold.TimePointBegin; }) - Holds.begin();
+}
 
-	for (const auto &[column, note] : InNotes)
-	{
-		switch (note.Type)
-		{
-		case Note::EType::Common:
-			InjectNote(note.TimePoint, column, note.Type, -1, -1, -1, InSkipOnModified);
-			break;
+void HoldIndex::UpdateMaxTimePointEnds(const size_t InFromIndex)
+{
+	for (size_t index = InFromIndex; index < Holds.size(); ++index)
+		MaxTimePointEnds[index] = index == 0 ? Holds[index].TimePointEnd : std::max(MaxTimePointEnds[index - 1], Holds[index].TimePointEnd);
+}
 
-		case Note::EType::HoldBegin:
-			InjectHold(note.TimePointBegin, note.TimePointEnd, column, -1, -1, InSkipOnModified);
-			break;
-		}
-	}
+NoteColumn::Iterator NoteColumn::LowerBound(const Time InTime)
+{
+	return std::lower_bound(Notes.begin(), Notes.end(), InTime, [](const Note& InNote, const Time InTimePoint) { return InNote.TimePoint < InTimePoint; });
 }
 
-void Chart::MirrorNotes(NoteReferenceCollection& OutNotes)
+NoteColumn::Iterator NoteColumn::UpperBound(const Time InTime)
 {
-	std::vector<std::pair<Column, Note>> bulkOfNotes;
+	return std::upper_bound(Notes.begin(), Notes.end(), InTime, [](const Time InTimePoint, const Note& InNote) { return InTimePoint < InNote.TimePoint; });
+}
 
-	RegisterTimeSliceHistoryRanged(OutNotes.MinTimePoint, OutNotes.MaxTimePoint);
+NoteColumn::ConstIterator NoteColumn::LowerBound(const Time InTime) const
+{
+	return std::lower_bound(Notes.begin(), Notes.end(), InTime, [](const Note& InNote, const Time InTimePoint) { return InNote.TimePoint < InTimePoint; });
+}
 
-	for (auto& [column, notes] : OutNotes.Notes)
-	{
-		Column newColumn = (KeyAmount - 1) - column;
+NoteColumn::ConstIterator NoteColumn::UpperBound(const Time InTime) const
+{
+	return std::upper_bound(Notes.begin(), Notes.end(), InTime, [](const Time InTimePoint, const Note& InNote) { return InTimePoint < InNote.TimePoint; });
+}
 
-		//this is neccesary since removing an element form a vector will change the contents of a pointer pointing to that element
-		std::vector<Note> copiedNotes;
-		for (auto &note : notes)
-			copiedNotes.push_back(*note);
+Note& NoteColumn::Insert(const Note& InNote)
+{
+	return *Notes.insert(UpperBound(InNote.TimePoint), InNote);
+}
 
-		for (auto &note : copiedNotes)
-		{
-			bulkOfNotes.push_back({newColumn, note});
-			RemoveNote(note.TimePoint, column, false, true, true);
-		}
-	}
+void NoteColumn::Merge(std::vector<Note>& InOutNotes)
+{
+	if (InOutNotes.empty())
+		return;
 
-	BulkPlaceNotes(bulkOfNotes, true, true);
+	std::stable_sort(InOutNotes.begin(), InOutNotes.end(), [](const Note& lhs, const Note& rhs) { return lhs.TimePoint < rhs.TimePoint; });
 
-	IterateTimeSlicesInTimeRange(OutNotes.MinTimePoint, OutNotes.MaxTimePoint, [this](TimeSlice& InTimeSlice)
-	{
-		_OnModified(InTimeSlice);
-	});
+	const size_t formerSize = Notes.size();
+	Notes.insert(Notes.end(), InOutNotes.begin(), InOutNotes.end());
 
-	OutNotes.Clear();
+	std::inplace_merge(Notes.begin(), Notes.begin() + formerSize, Notes.end(), [](const Note& lhs, const Note& rhs) { return lhs.TimePoint < rhs.TimePoint; });
 }
 
-void Chart::MirrorNotes(std::vector<std::pair<Column, Note>>& OutNotes) 
+Note* NoteColumn::Find(const Time InTime)
 {
-	for(auto& [column, notes] : OutNotes)
-		column = (KeyAmount - 1) - column;
+	return const_cast<Note*>(std::as_const(*this).Find(InTime));
 }
 
-bool Chart::RemoveNote(const Time InTime, const Column InColumn, const bool InIgnoreHoldChecks, const bool InSkipHistoryRegistering, const bool InSkipOnModified)
+const Note* NoteColumn::Find(const Time InTime) const
 {
-	auto &timeSlice = FindOrAddTimeSlice(InTime);
-	auto &noteCollection = timeSlice.Notes[InColumn];
+	auto noteIt = LowerBound(InTime);
 
-	auto noteIt = std::find_if(noteCollection.begin(), noteCollection.end(), [InTime](const Note &InNote)
-							   { return InNote.TimePoint == InTime; });
-
-	if (noteIt == noteCollection.end())
-		return false;
+	if (noteIt == Notes.end() || noteIt->TimePoint != InTime)
+		return nullptr;
 
-	//hold checks
-	if (InIgnoreHoldChecks == false && (noteIt->Type == Note::EType::HoldBegin || noteIt->Type == Note::EType::HoldEnd))
-	{
-		Time holdTimeBegin = noteIt->TimePointBegin;
-		Time holdTimedEnd = noteIt->TimePointEnd;
+	return &(*noteIt);
+}
 
-		if (!InSkipHistoryRegistering)
-			RegisterTimeSliceHistoryRanged(holdTimeBegin, holdTimedEnd);
+Note* NoteColumn::FindHoldBegin(const Time InTimeBegin, const Time InTimeEnd)
+{
+	return const_cast<Note*>(std::as_const(*this).FindHoldBegin(InTimeBegin, InTimeEnd));
+}
 
-		//removes all intermidiate notes
-		for (Time time = FindOrAddTimeSlice(holdTimeBegin).TimePoint + TIMESLICE_LENGTH;
-			 time <= FindOrAddTimeSlice(holdTimedEnd).TimePoint - TIMESLICE_LENGTH;
-			 time += TIMESLICE_LENGTH)
-		{
-			RemoveNote(time, InColumn, true);
-		}
+const Note* NoteColumn::FindHoldBegin(const Time InTimeBegin, const Time InTimeEnd) const
+{
+	for (auto noteIt = LowerBound(InTimeBegin); noteIt != Notes.end() && noteIt->TimePoint == InTimeBegin; ++noteIt)
+		if (noteIt->Type == Note::EType::HoldBegin && noteIt->TimePointEnd == InTimeEnd)
+			return &(*noteIt);
 
-		RemoveNote(holdTimeBegin, InColumn, true);
-		RemoveNote(holdTimedEnd, InColumn, true);
-	}
-	else
-	{
-		if (!InIgnoreHoldChecks && !InSkipHistoryRegistering)
-			RegisterTimeSliceHistory(InTime);
+	return nullptr;
+}
 
-		noteCollection.erase(noteIt);
-	}
+Note* NoteColumn::FindHoldEnd(const Time InTimeBegin, const Time InTimeEnd)
+{
+	return const_cast<Note*>(std::as_const(*this).FindHoldEnd(InTimeBegin, InTimeEnd));
+}
 
-	if(!InSkipOnModified)
-		_OnModified(timeSlice);
+const Note* NoteColumn::FindHoldEnd(const Time InTimeBegin, const Time InTimeEnd) const
+{
+	for (auto noteIt = LowerBound(InTimeEnd); noteIt != Notes.end() && noteIt->TimePoint == InTimeEnd; ++noteIt)
+		if (noteIt->Type == Note::EType::HoldEnd && noteIt->TimePointBegin == InTimeBegin)
+			return &(*noteIt);
 
-	return true;
+	return nullptr;
 }
 
-bool Chart::RemoveBpmPoint(BpmPoint &InBpmPoint, const bool InSkipHistoryRegistering)
+bool NoteColumn::Contains(const Time InTime) const
 {
-	auto &timeSlice = FindOrAddTimeSlice(InBpmPoint.TimePoint);
-	auto &bpmCollection = timeSlice.BpmPoints;
-
-	if (!InSkipHistoryRegistering)
-		RegisterTimeSliceHistory(InBpmPoint.TimePoint);
+	return Find(InTime) != nullptr;
+}
 
-	bpmCollection.erase(std::remove(bpmCollection.begin(), bpmCollection.end(), InBpmPoint), bpmCollection.end());
+BpmPoint* TempoMap::Insert(const BpmPoint& InBpmPoint)
+{
+	//points on the same time point keep their insertion order
+	const size_t index = GetUpperBoundIndex(InBpmPoint.TimePoint);
 
-	CachedBpmPoints.clear();
+	TempoMapPoint tempoMapPoint;
+	tempoMapPoint.Point = _Points.insert(_Points.end(), InBpmPoint);
 
-	_BpmPointCounter--;
+	_SortedPoints.insert(_SortedPoints.begin() + index, tempoMapPoint);
+	UpdateBeats(index);
 
-	return true;
+	return &(*tempoMapPoint.Point);
 }
 
-bool Chart::BulkRemoveNotes(NoteReferenceCollection& InNotes, const bool InSkipHistoryRegistering) 
+bool TempoMap::Erase(const Time InTime)
 {
-	if (!InSkipHistoryRegistering)
-		RegisterTimeSliceHistoryRanged(InNotes.MinTimePoint, InNotes.MaxTimePoint);
-
-	for (auto& [column, notes] : InNotes.Notes)
-	{
-		Column newColumn = (KeyAmount - 1) - column;
-
-		//this is neccesary since removing an element form a vector will change the contents of a pointer pointing to that element
-		std::vector<Note> copiedNotes;
-		for (auto &note : notes)
-			copiedNotes.push_back(*note);
+	auto pointIt = std::lower_bound(_SortedPoints.begin(), _SortedPoints.end(), InTime, [](const TempoMapPoint& InPoint, const Time InOtherTime) { return InPoint.Point->TimePoint < InOtherTime; });
 
-		for (auto &note : copiedNotes)
-			RemoveNote(note.TimePoint, column, false, true, true);
-	}
+	if (pointIt == _SortedPoints.end() || pointIt->Point->TimePoint != InTime)
+		return false;
 
-	IterateTimeSlicesInTimeRange(InNotes.MinTimePoint, InNotes.MaxTimePoint, [this](TimeSlice& InTimeSlice)
-	{
-		_OnModified(InTimeSlice);
-	});
+	_Points.erase(pointIt->Point);
 
-	InNotes.Clear();
+	UpdateBeats(_SortedPoints.erase(pointIt) - _SortedPoints.begin());
 
 	return true;
 }
 
-Note &Chart::InjectNote(const Time InTime, const Column InColumn, const Note::EType InNoteType, const Time InTimeBegin, const Time InTimeEnd, const int InBeatSnap, const bool InSkipOnModified)
+void TempoMap::Refresh()
 {
-	auto &timeSlice = FindOrAddTimeSlice(InTime);
-
-	Note note;
-	note.Type = InNoteType;
-	note.TimePoint = InTime;
-	note.BeatSnap = InBeatSnap;
-
-	note.TimePointBegin = InTimeBegin;
-	note.TimePointEnd = InTimeEnd;
+	std::stable_sort(_SortedPoints.begin(), _SortedPoints.end(), [](const TempoMapPoint& lhs, const TempoMapPoint& rhs) { return lhs.Point->TimePoint < rhs.Point->TimePoint; });
 
-	timeSlice.Notes[InColumn].push_back(note);
-	Note &injectedNoteRef = timeSlice.Notes[InColumn].back();
+	UpdateBeats(0);
+}
 
-	std::sort(timeSlice.Notes[InColumn].begin(), timeSlice.Notes[InColumn].end(), [](const auto &lhs, const auto &rhs)
-			  { return (lhs.TimePoint < rhs.TimePoint); });
+BpmPoint* TempoMap::GetPreviousPoint(const Time InTime) const
+{
+	auto pointIt = std::lower_bound(_SortedPoints.begin(), _SortedPoints.end(), InTime, [](const TempoMapPoint& InPoint, const Time InOtherTime) { return InPoint.Point->TimePoint < InOtherTime; });
 
-	if(!InSkipOnModified)
-		_OnModified(timeSlice);
+	if (pointIt == _SortedPoints.begin())
+		return nullptr;
 
-	return injectedNoteRef;
+	return &(*(--pointIt)->Point);
 }
 
-Note &Chart::InjectHold(const Time InTimeBegin, const Time InTimeEnd, const Column InColumn, const int InBeatSnapBegin, const int InBeatSnapEnd, const bool InSkipOnModified)
+BpmPoint* TempoMap::GetNextPoint(const Time InTime) const
 {
-	Note &noteToReturn = InjectNote(InTimeBegin, InColumn, Note::EType::HoldBegin, InTimeBegin, InTimeEnd, InBeatSnapBegin);
-
-	Time startTime = FindOrAddTimeSlice(InTimeBegin).TimePoint + TIMESLICE_LENGTH;
-	Time endTime = FindOrAddTimeSlice(InTimeEnd).TimePoint - TIMESLICE_LENGTH;
-
-	for (Time time = startTime; time <= endTime; time += TIMESLICE_LENGTH)
-	{
-		InjectNote(time, InColumn, Note::EType::HoldIntermediate, InTimeBegin, InTimeEnd);
-	}
+	const size_t index = GetUpperBoundIndex(InTime);
 
-	if(!InSkipOnModified)
-		InjectNote(InTimeEnd, InColumn, Note::EType::HoldEnd, InTimeBegin, InTimeEnd, InBeatSnapEnd);
+	if (index == _SortedPoints.size())
+		return nullptr;
 
-	return noteToReturn;
+	return &(*_SortedPoints[index].Point);
 }
 
-BpmPoint *Chart::InjectBpmPoint(const Time InTime, const double InBpm, const double InBeatLength)
+void TempoMap::GetPointsRelatedToTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::vector<BpmPoint*>& OutBpmPoints) const
 {
-	auto &timeSlice = FindOrAddTimeSlice(InTime);
+	OutBpmPoints.clear();
 
-	BpmPoint bpmPoint;
-	bpmPoint.TimePoint = InTime;
-	bpmPoint.Bpm = InBpm;
-	bpmPoint.BeatLength = InBeatLength;
+	if (_SortedPoints.empty())
+		return;
 
-	timeSlice.BpmPoints.push_back(bpmPoint);
+	//the point already in effect at the beginning, or the very first one if the range lies before every point
+	const size_t first = std::max(GetUpperBoundIndex(InTimeBegin), size_t(1)) - 1;
+	const size_t last = std::max(GetUpperBoundIndex(InTimeEnd), first + 1);
 
-	BpmPoint *bpmPointPtr = &(timeSlice.BpmPoints.back());
+	for (size_t index = first; index < last; ++index)
+		OutBpmPoints.push_back(&(*_SortedPoints[index].Point));
+}
 
-	std::sort(timeSlice.BpmPoints.begin(), timeSlice.BpmPoints.end(), [](const auto &lhs, const auto &rhs)
-			  { return lhs.TimePoint < rhs.TimePoint; });
+double TempoMap::GetBeatFromTimePoint(const Time InTime) const
+{
+	if (_SortedPoints.empty())
+		return 0.0;
 
-	_BpmPointCounter++;
+	const TempoMapPoint& tempoMapPoint = _SortedPoints[std::max(GetUpperBoundIndex(InTime), size_t(1)) - 1];
 
-	return bpmPointPtr;
+	return tempoMapPoint.Beat + double(InTime - tempoMapPoint.Point->TimePoint) / tempoMapPoint.Point->BeatLength;
 }
 
-Note *Chart::MoveNote(const Time InTimeFrom, const Time InTimeTo, const Column InColumnFrom, const Column InColumnTo, const int InNewBeatSnap)
+double TempoMap::GetTimePointFromBeat(const double InBeat) const
 {
-	//have I mentioned that I really dislike handling edge-cases?
-	Note noteToRemove = *FindNote(InTimeFrom, InColumnFrom);
+	if (_SortedPoints.empty())
+		return 0.0;
 
-	switch (noteToRemove.Type)
-	{
-	case Note::EType::Common:
-	{
-		auto &timeSliceFrom = FindOrAddTimeSlice(InTimeFrom);
-		auto &timeSliceTo = FindOrAddTimeSlice(InTimeTo);
+	auto pointIt = std::upper_bound(_SortedPoints.begin(), _SortedPoints.end(), InBeat, [](const double InOtherBeat, const TempoMapPoint& InPoint) { return InOtherBeat < InPoint.Beat; });
 
-		if (timeSliceFrom.Index == timeSliceTo.Index)
-			RegisterTimeSliceHistory(InTimeFrom);
-		else
-			RegisterTimeSliceHistoryRanged(InTimeFrom, InTimeTo);
+	if (pointIt != _SortedPoints.begin())
+		--pointIt;
 
-		RemoveNote(InTimeFrom, InColumnFrom, false, true);
-		return &(InjectNote(InTimeTo, InColumnTo, Note::EType::Common, -1, -1, InNewBeatSnap));
-	}
-	break;
+	return double(pointIt->Point->TimePoint) + (InBeat - pointIt->Beat) * pointIt->Point->BeatLength;
+}
 
-	case Note::EType::HoldBegin:
-	{
-		if (InTimeTo < noteToRemove.TimePointBegin)
-			RegisterTimeSliceHistoryRanged(InTimeTo - TIMESLICE_LENGTH, noteToRemove.TimePointEnd);
-		else
-			RegisterTimeSliceHistoryRanged(noteToRemove.TimePointBegin - TIMESLICE_LENGTH, noteToRemove.TimePointEnd);
+size_t TempoMap::GetSize() const
+{
+	return _SortedPoints.size();
+}
 
-		RemoveNote(InTimeFrom, InColumnFrom, false, true);
+size_t TempoMap::GetUpperBoundIndex(const Time InTime) const
+{
+	return std::upper_bound(_SortedPoints.begin(), _SortedPoints.end(), InTime, [](const Time InOtherTime, const TempoMapPoint& InPoint) { return InOtherTime < InPoint.Point->TimePoint; }) - _SortedPoints.begin();
+}
 
-		return &(InjectHold(InTimeTo, noteToRemove.TimePointEnd, InColumnTo, InNewBeatSnap));
-	}
-	break;
-	case Note::EType::HoldEnd:
+void TempoMap::UpdateBeats(const size_t InFromIndex)
+{
+	for (size_t index = InFromIndex; index < _SortedPoints.size(); ++index)
 	{
-		if (InTimeTo > noteToRemove.TimePointBegin)
-			RegisterTimeSliceHistoryRanged(noteToRemove.TimePointBegin, InTimeTo + TIMESLICE_LENGTH);
-		else
-			RegisterTimeSliceHistoryRanged(noteToRemove.TimePointBegin, noteToRemove.TimePointEnd + TIMESLICE_LENGTH);
-
-		int beatSnap = FindNote(noteToRemove.TimePointBegin, InColumnFrom)->BeatSnap;
-
-		RemoveNote(InTimeFrom, InColumnFrom, false, true);
-
-		return &(InjectHold(noteToRemove.TimePointBegin, InTimeTo, InColumnTo, beatSnap));
-	}
-	break;
+		if (index == 0)
+		{
+			_SortedPoints[index].Beat = 0.0;
+			continue;
+		}
 
-	default:
-		return nullptr;
-		break;
+		const TempoMapPoint& previousPoint = _SortedPoints[index - 1];
+		_SortedPoints[index].Beat = previousPoint.Beat + double(_SortedPoints[index].Point->TimePoint - previousPoint.Point->TimePoint) / previousPoint.Point->BeatLength;
 	}
 }
 
-Note *Chart::FindNote(const Time InTime, const Column InColumn)
+void ScrollVelocityMap::Assign(std::vector<ScrollVelocityMultiplier>&& InPoints)
 {
-	auto &timeSlice = FindOrAddTimeSlice(InTime);
-	auto &noteCollection = timeSlice.Notes[InColumn];
+	//points on the same time point keep their order, the later one is the one in effect
+	_Points = std::move(InPoints);
+	std::stable_sort(_Points.begin(), _Points.end(), [](const ScrollVelocityMultiplier& lhs, const ScrollVelocityMultiplier& rhs) { return lhs.TimePoint < rhs.TimePoint; });
 
-	auto noteIt = std::find_if(noteCollection.begin(), noteCollection.end(), [InTime](const Note &InNote)
-							   { return InNote.TimePoint == InTime; });
+	UpdatePositions();
+}
 
-	if (noteIt == noteCollection.end())
-		return nullptr;
+void ScrollVelocityMap::Insert(const ScrollVelocityMultiplier& InPoint)
+{
+	_Points.insert(_Points.begin() + GetUpperBoundIndex(InPoint.TimePoint), InPoint);
 
-	return &(*noteIt);
+	UpdatePositions();
 }
 
-void Chart::DebugPrint()
+bool ScrollVelocityMap::Erase(const double InTime)
 {
-	std::cout << DifficultyName << std::endl;
-	std::cout << "***************************" << std::endl;
+	const size_t index = GetUpperBoundIndex(InTime);
 
-	for (auto [timePoint, slice] : TimeSlices)
-	{
-		for (auto [column, notes] : slice.Notes)
-		{
-			for (auto note : notes)
-			{
-				std::string type = "";
-				switch (note.Type)
-				{
-				case Note::EType::Common:
-					type = "common";
-					break;
-				case Note::EType::HoldBegin:
-					type = "hold begin";
-					break;
-				case Note::EType::HoldIntermediate:
-					type = "hold intermediate";
-					break;
-				case Note::EType::HoldEnd:
-					type = "hold end";
-					break;
+	if (index == 0 || _Points[index - 1].TimePoint != InTime)
+		return false;
 
-				default:
-					break;
-				}
+	_Points.erase(_Points.begin() + (index - 1));
 
-				std::cout << timePoint << ":" << std::to_string(note.TimePoint) << " - " << std::to_string(column) << " - " << type << std::endl;
-			}
-		}
-	}
+	UpdatePositions();
 
-	std::cout << std::endl;
+	return true;
 }
 
-void Chart::RegisterOnModifiedCallback(std::function<void(TimeSlice &)> InCallback)
+const ScrollVelocityMultiplier* ScrollVelocityMap::Find(const double InTime) const
 {
-	_OnModified = InCallback;
-}
+	const ScrollVelocityMultiplier* point = GetPreviousPoint(InTime);
 
-bool Chart::IsAPotentialNoteDuplicate(const Time InTime, const Column InColumn)
-{
-	auto &notes = FindOrAddTimeSlice(InTime).Notes[InColumn];
-	return (std::find_if(notes.begin(), notes.end(), [InTime](const Note &InNote)
-						 { return InNote.TimePoint == InTime; }) != notes.end());
+	return point && point->TimePoint == InTime ? point : nullptr;
 }
 
-TimeSlice &Chart::FindOrAddTimeSlice(const Time InTime)
+const ScrollVelocityMultiplier* ScrollVelocityMap::GetPreviousPoint(const double InTime) const
 {
-	int index = InTime / TIMESLICE_LENGTH;
-	if (TimeSlices.find(index) == TimeSlices.end())
-	{
-		TimeSlices[index].TimePoint = index * TIMESLICE_LENGTH;
-		TimeSlices[index].Index = index;
-	}
+	const size_t index = GetUpperBoundIndex(InTime);
 
-	return TimeSlices[index];
+	return index == 0 ? nullptr : &_Points[index - 1];
 }
 
-void Chart::FillNoteCollectionWithAllNotes(NoteReferenceCollection& OutNotes) 
+double ScrollVelocityMap::GetScrollPosition(const double InTime) const
 {
-	OutNotes.Clear();
+	if (_Points.empty())
+		return InTime;
 
-	IterateAllNotes([&OutNotes](Note& InNote, Column InColumn)
-	{
-		OutNotes.PushNote(InColumn, &InNote);
-	});
+	const size_t index = std::max(GetUpperBoundIndex(InTime), size_t(1)) - 1;
+	const double multiplier = InTime < _Points[index].TimePoint ? 1.0 : _Points[index].Multiplier;
+
+	return _Positions[index] + (InTime - _Points[index].TimePoint) * multiplier;
 }
 
-void Chart::PushTimeSliceHistoryIfNotAdded(const Time InTime)
+double ScrollVelocityMap::GetFirstTimePointReaching(const double InScrollPosition) const
 {
-	if (TimeSliceHistory.size() == 0)
-		return;
+	if (_Points.empty())
+		return InScrollPosition;
+
+	if (InScrollPosition <= _Positions.front())
+		return _Points.front().TimePoint - (_Positions.front() - InScrollPosition);
 
-	auto &collection = TimeSliceHistory.top();
+	//the position is crossed upwards between the point before the first maximum reaching it and that point, which needs a positive multiplier
+	const size_t index = std::lower_bound(_MaxPositions.begin(), _MaxPositions.end(), InScrollPosition) - _MaxPositions.begin();
 
-	for (auto &timeSlice : collection)
+	if (index == _Points.size())
 	{
-		if (InTime >= timeSlice.TimePoint && InTime <= timeSlice.TimePoint + TIMESLICE_LENGTH)
-			return;
+		const ScrollVelocityMultiplier& lastPoint = _Points.back();
+
+		if (lastPoint.Multiplier <= 0.0)
+			return std::numeric_limits<double>::infinity();
+
+		return lastPoint.TimePoint + (InScrollPosition - _Positions.back()) / lastPoint.Multiplier;
 	}
 
-	collection.push_back(FindOrAddTimeSlice(InTime));
+	return _Points[index - 1].TimePoint + (InScrollPosition - _Positions[index - 1]) / _Points[index - 1].Multiplier;
 }
 
-void Chart::RevaluateBpmPoint(BpmPoint &InFormerBpmPoint, BpmPoint &InMovedBpmPoint)
+double ScrollVelocityMap::GetLastTimePointBelow(const double InScrollPosition) const
 {
-	auto &formerTimeSlice = FindOrAddTimeSlice(InFormerBpmPoint.TimePoint);
-	auto &newTimeSlice = FindOrAddTimeSlice(InMovedBpmPoint.TimePoint);
+	if (_Points.empty())
+		return InScrollPosition;
 
-	auto &formerBpmCollection = formerTimeSlice.BpmPoints;
+	const ScrollVelocityMultiplier& lastPoint = _Points.back();
 
-	if (formerTimeSlice.Index != newTimeSlice.Index)
+	if (_Positions.back() <= InScrollPosition)
 	{
-		BpmPoint bpmPointToAdd = InMovedBpmPoint;
+		if (lastPoint.Multiplier <= 0.0)
+			return std::numeric_limits<double>::infinity();
 
-		formerBpmCollection.erase(std::remove(formerBpmCollection.begin(), formerBpmCollection.end(), InMovedBpmPoint), formerBpmCollection.end());
-		CachedBpmPoints.clear();
+		return lastPoint.TimePoint + (InScrollPosition - _Positions.back()) / lastPoint.Multiplier;
+	}
 
-		TimeSliceHistory.top().push_back(newTimeSlice);
+	//the mirror image of the above, the position is left upwards after the last minimum still below it
+	const size_t index = std::upper_bound(_MinPositions.begin(), _MinPositions.end(), InScrollPosition) - _MinPositions.begin();
 
-		InjectBpmPoint(bpmPointToAdd.TimePoint, bpmPointToAdd.Bpm, bpmPointToAdd.BeatLength);
+	if (index == 0)
+		return _Points.front().TimePoint - (_Positions.front() - InScrollPosition);
 
-		_BpmPointCounter--;
-	}
+	return _Points[index - 1].TimePoint + (InScrollPosition - _Positions[index - 1]) / _Points[index - 1].Multiplier;
 }
 
-void Chart::RegisterTimeSliceHistory(const Time InTime)
+const std::vector<ScrollVelocityMultiplier>& ScrollVelocityMap::GetPoints() const
 {
-	TimeSliceHistory.push({FindOrAddTimeSlice(InTime)});
+	return _Points;
 }
 
-void Chart::RegisterTimeSliceHistoryRanged(const Time InTimeBegin, const Time InTimeEnd)
+size_t ScrollVelocityMap::GetSize() const
 {
-	std::vector<TimeSlice> timeSlices;
+	return _Points.size();
+}
 
-	IterateTimeSlicesInTimeRange(InTimeBegin, InTimeEnd, [&timeSlices](TimeSlice &InTimeSlice)
-								 { timeSlices.push_back(InTimeSlice); });
+size_t ScrollVelocityMap::GetLowerBoundIndex(const double InTime) const
+{
+	return std::lower_bound(_Points.begin(), _Points.end(), InTime, [](const ScrollVelocityMultiplier& InPoint, const double InOtherTime) { return InPoint.TimePoint < InOtherTime; }) - _Points.begin();
+}
 
-	TimeSliceHistory.push(timeSlices);
+size_t ScrollVelocityMap::GetUpperBoundIndex(const double InTime) const
+{
+	return std::upper_bound(_Points.begin(), _Points.end(), InTime, [](const double InOtherTime, const ScrollVelocityMultiplier& InPoint) { return InOtherTime < InPoint.TimePoint; }) - _Points.begin();
 }
 
-bool Chart::Undo()
+void ScrollVelocityMap::UpdatePositions()
 {
-	if (TimeSliceHistory.empty())
-		return false;
+	const size_t pointAmount = _Points.size();
 
-	for (auto &timeSlice : TimeSliceHistory.top())
-		_OnModified(TimeSlices[timeSlice.Index] = timeSlice);
+	_Positions.resize(pointAmount);
+	_MaxPositions.resize(pointAmount);
+	_MinPositions.resize(pointAmount);
 
-	TimeSliceHistory.pop();
+	if (pointAmount == 0)
+		return;
 
-	return true;
-}
+	//the first point is reached at its own time point, so the positions line up with the times before it
+	_Positions[0] = _Points[0].TimePoint;
 
-void Chart::IterateTimeSlicesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::function<void(TimeSlice &)> InWork)
-{
-	if (InTimeBegin > InTimeEnd)
-	{
-		for (TimeSlice *timeSlice = &FindOrAddTimeSlice(InTimeBegin);
-			 timeSlice->TimePoint > InTimeEnd - TIMESLICE_LENGTH;
-			 timeSlice = &FindOrAddTimeSlice(timeSlice->TimePoint - TIMESLICE_LENGTH))
-		{
-			InWork(*timeSlice);
-		}
+	for (size_t index = 1; index < pointAmount; ++index)
+		_Positions[index] = _Positions[index - 1] + (_Points[index].TimePoint - _Points[index - 1].TimePoint) * _Points[index - 1].Multiplier;
 
-		return;
-	}
+	_MaxPositions[0] = _Positions[0];
 
-	for (TimeSlice *timeSlice = &FindOrAddTimeSlice(InTimeBegin);
-		 timeSlice->TimePoint <= InTimeEnd;
-		 timeSlice = &FindOrAddTimeSlice(timeSlice->TimePoint + TIMESLICE_LENGTH))
-	{
-		InWork(*timeSlice);
-	}
-}
+	for (size_t index = 1; index < pointAmount; ++index)
+		_MaxPositions[index] = std::max(_MaxPositions[index - 1], _Positions[index]);
 
-void Chart::IterateNotesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::function<void(Note &, const Column)> InWork)
-{
-	for (TimeSlice *timeSlice = &FindOrAddTimeSlice(InTimeBegin);
-		 timeSlice->TimePoint <= InTimeEnd;
-		 timeSlice = &FindOrAddTimeSlice(timeSlice->TimePoint + TIMESLICE_LENGTH))
-	{
-		for (auto &[column, notes] : timeSlice->Notes)
-		{
-			for (auto &note : notes)
-			{
-				if (note.TimePoint >= InTimeBegin && note.TimePoint <= InTimeEnd)
-					InWork(note, column);
-			}
-		}
-	}
-}
+	_MinPositions[pointAmount - 1] = _Positions[pointAmount - 1];
 
-void Chart::IterateAllNotes(std::function<void(Note &, const Column)> InWork)
-{
-	for (auto &[ID, timeSlice] : TimeSlices)
-	{
-		for (auto &[column, notes] : timeSlice.Notes)
-		{
-			for (auto &note : notes)
-			{
-				InWork(note, column);
-			}
-		}
-	}
+	for (size_t index = pointAmount - 1; index > 0; --index)
+		_MinPositions[index - 1] = std::min(_MinPositions[index], _Positions[index - 1]);
 }
 
-void Chart::IterateAllBpmPoints(std::function<void(BpmPoint &)> InWork)
+size_t EditHistoryEntry::GetMemoryFootprint() const
 {
-	for (auto &[ID, timeSlice] : TimeSlices)
-	{
-		for (auto &bpmPoint : timeSlice.BpmPoints)
-		{
-			InWork(bpmPoint);
-		}
-	}
+	return sizeof(EditHistoryEntry) + Actions.capacity() * sizeof(EditAction);
 }
 
-std::vector<BpmPoint *> &Chart::GetBpmPointsRelatedToTimeRange(const Time InTimeBegin, const Time InTimeEnd)
+void EditHistory::BeginEntry(const EditCoalesceKey& InCoalesceKey)
 {
-	CachedBpmPoints.clear();
-
-	if (!_BpmPointCounter)
-		return CachedBpmPoints;
+	EndEntry();
 
-	Time newTimeBegin = InTimeBegin - TIMESLICE_LENGTH;
-
-	for (Time time = newTimeBegin; time >= -10000; time -= TIMESLICE_LENGTH)
+	//reopening the previous entry, so a drag that gets picked up again still ends up as a single undo
+	if (InCoalesceKey.Type != EditCoalesceKey::EType::None && !_UndoEntries.empty() && _UndoEntries.back().CoalesceKey == InCoalesceKey)
 	{
-		auto &timeSlice = FindOrAddTimeSlice(time);
-		if (!timeSlice.BpmPoints.empty())
-		{
-			newTimeBegin = time;
-			break;
-		}
+		_IsEntryOpen = true;
+		return;
 	}
 
-	IterateTimeSlicesInTimeRange(newTimeBegin, InTimeEnd, [this](TimeSlice &InTimeSlice)
-								 {
-									 if (InTimeSlice.BpmPoints.empty())
-										 return;
+	EditHistoryEntry entry;
+	entry.CoalesceKey = InCoalesceKey;
+	entry.TimePointMin = std::numeric_limits<int>::max();
+	entry.TimePointMax = std::numeric_limits<int>::min();
 
-									 for (auto &bpmPoint : InTimeSlice.BpmPoints)
-										 CachedBpmPoints.push_back(&bpmPoint);
-								 });
+	_MemoryUsage += entry.GetMemoryFootprint();
+	_UndoEntries.push_back(std::move(entry));
 
-	if (CachedBpmPoints.empty())
-		return GetBpmPointsRelatedToTimeRange(InTimeBegin, InTimeEnd + TIMESLICE_LENGTH);
-
-	return CachedBpmPoints;
+	_IsEntryOpen = true;
 }
 
-BpmPoint *Chart::GetPreviousBpmPointFromTimePoint(const Time InTime)
+void EditHistory::EndEntry()
 {
-	BpmPoint *foundBpmPoint = nullptr;
-	BpmPoint *previousBpmPoint = nullptr;
+	if (!_IsEntryOpen)
+		return;
 
-	IterateTimeSlicesInTimeRange(0, InTime, [this, InTime, &foundBpmPoint, &previousBpmPoint](TimeSlice &InTimeSlice)
-								 {
-									 if (InTimeSlice.BpmPoints.empty())
-										 return;
+	_IsEntryOpen = false;
 
-									 for (auto &bpmPoint : InTimeSlice.BpmPoints)
-										 if (bpmPoint.TimePoint < InTime)
-											 previousBpmPoint = &bpmPoint;
-								 });
+	auto& entry = _UndoEntries.back();
+	_MemoryUsage -= entry.GetMemoryFootprint();
 
-	foundBpmPoint = previousBpmPoint;
+	if (entry.Actions.empty())
+		return _UndoEntries.pop_back();
 
-	return foundBpmPoint;
+	entry.Actions.shrink_to_fit();
+	_MemoryUsage += entry.GetMemoryFootprint();
 }
 
-BpmPoint *Chart::GetNextBpmPointFromTimePoint(const Time InTime)
+void EditHistory::SetCoalesceKey(const EditCoalesceKey& InCoalesceKey)
 {
-	if (!_BpmPointCounter)
-		return nullptr;
+	if (_IsEntryOpen)
+		_UndoEntries.back().CoalesceKey = InCoalesceKey;
+}
 
-	auto &relevantTimeSlice = FindOrAddTimeSlice(InTime);
+void EditHistory::RecordAction(const EditAction& InAction)
+{
+	if (!_IsEntryOpen)
+		return;
+
+	//a new change makes everything that has been undone unreachable
+	for (auto& redoEntry : _RedoEntries)
+		_MemoryUsage -= redoEntry.GetMemoryFootprint();
+
+	_RedoEntries.clear();
+
+	auto& entry = _UndoEntries.back();
+
+	_MemoryUsage -= entry.GetMemoryFootprint();
+	entry.Actions.push_back(InAction);
+	_MemoryUsage += entry.GetMemoryFootprint();
+
+	switch (InAction.Type)
+	{
+	case EditAction::EType::PlaceNote:
+	case EditAction::EType::RemoveNote:
+		entry.TimePointMin = std::min(entry.TimePointMin, InAction.ActionNote.TimePoint);
+		entry.TimePointMax = std::max(entry.TimePointMax, InAction.ActionNote.TimePoint);
+		break;
+
+	case EditAction::EType::ModifyBpmPoint:
+		entry.TimePointMin = std::min(entry.TimePointMin, InAction.LatterBpmPoint.TimePoint);
+		entry.TimePointMax = std::max(entry.TimePointMax, InAction.LatterBpmPoint.TimePoint);
+		[[fallthrough]];
+
+	case EditAction::EType::PlaceBpmPoint:
+	case EditAction::EType::RemoveBpmPoint:
+		entry.TimePointMin = std::min(entry.TimePointMin, InAction.FormerBpmPoint.TimePoint);
+		entry.TimePointMax = std::max(entry.TimePointMax, InAction.FormerBpmPoint.TimePoint);
+		break;
+
+	case EditAction::EType::PlaceScrollVelocity:
+	case EditAction::EType::RemoveScrollVelocity:
+		entry.TimePointMin = std::min(entry.TimePointMin, Time(std::floor(InAction.ActionScrollVelocity.TimePoint)));
+		entry.TimePointMax = std::max(entry.TimePointMax, Time(std::ceil(InAction.ActionScrollVelocity.TimePoint)));
+		break;
+	}
+
+	EnforceMemoryBudget();
+}
+
+bool EditHistory::CanUndo()
+{
+	return !_UndoEntries.empty();
+}
+
+bool EditHistory::CanRedo()
+{
+	return !_RedoEntries.empty();
+}
+
+EditHistoryEntry EditHistory::TakeUndoEntry()
+{
+	_MemoryUsage -= _UndoEntries.back().GetMemoryFootprint();
+
+	EditHistoryEntry entry = std::move(_UndoEntries.back());
+	_UndoEntries.pop_back();
+
+	return entry;
+}
+
+EditHistoryEntry EditHistory::TakeRedoEntry()
+{
+	_MemoryUsage -= _RedoEntries.back().GetMemoryFootprint();
+
+	EditHistoryEntry entry = std::move(_RedoEntries.back());
+	_RedoEntries.pop_back();
+
+	return entry;
+}
+
+void EditHistory::PushUndoEntry(EditHistoryEntry&& InEntry)
+{
+	_MemoryUsage += InEntry.GetMemoryFootprint();
+	_UndoEntries.push_back(std::move(InEntry));
+
+	EnforceMemoryBudget();
+}
+
+void EditHistory::PushRedoEntry(EditHistoryEntry&& InEntry)
+{
+	_MemoryUsage += InEntry.GetMemoryFootprint();
+	_RedoEntries.push_back(std::move(InEntry));
+
+	EnforceMemoryBudget();
+}
+
+void EditHistory::Clear()
+{
+	_UndoEntries.clear();
+	_RedoEntries.clear();
+
+	_IsEntryOpen = false;
+	_MemoryUsage = 0;
+}
+
+void EditHistory::SetMemoryBudget(const size_t InBytes)
+{
+	_MemoryBudget = InBytes;
+
+	EnforceMemoryBudget();
+}
+
+size_t EditHistory::GetMemoryUsage()
+{
+	return _MemoryUsage;
+}
+
+void EditHistory::EnforceMemoryBudget()
+{
+	//oldest first, the entry currently recorded into is kept even if it exceeds the budget on its own
+	while (_MemoryUsage > _MemoryBudget && _UndoEntries.size() > (_IsEntryOpen ? 1 : 0))
+	{
+		_MemoryUsage -= _UndoEntries.front().GetMemoryFootprint();
+		_UndoEntries.pop_front();
+	}
+
+	while (_MemoryUsage > _MemoryBudget && !_RedoEntries.empty())
+	{
+		_MemoryUsage -= _RedoEntries.front().GetMemoryFootprint();
+		_RedoEntries.pop_front();
+	}
+}
+
+bool Chart::PlaceNote(const Time InTime, const Column InColumn, const int InBeatSnap, const bool InSkipHistoryRegistering)
+{
+	if (IsAPotentialNoteDuplicate(InTime, InColumn))
+		return false;
+
+	if (!InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+	InjectNote(InTime, InColumn, Note::EType::Common, -1, -1, InBeatSnap);
+
+	return true;
+}
+
+bool Chart::PlaceHold(const Time InTimeBegin, const Time InTimeEnd, const Column InColumn, const int InBeatSnap, const int InBeatSnapEnd)
+{
+	if (InTimeBegin == InTimeEnd)
+		return PlaceNote(InTimeBegin, InColumn, InBeatSnap);
+
+	if (IsAPotentialNoteDuplicate(InTimeBegin, InColumn) || IsAPotentialNoteDuplicate(InTimeEnd, InColumn))
+		return false;
+
+	BeginEditHistoryEntry();
+	InjectHold(InTimeBegin, InTimeEnd, InColumn, InBeatSnap);
+
+	return true;
+}
+
+bool Chart::PlaceBpmPoint(const Time InTime, const double InBpm, const double InBeatLength, const bool InSkipHistoryRegistering)
+{
+	if (!InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+
+	InjectBpmPoint(InTime, InBpm, InBeatLength);
+
+	return true;
+}
+
+void Chart::BulkPlaceNotes(const std::vector<std::pair<Column, Note>> &InNotes, const bool InSkipHistoryRegistering, const bool InSkipOnModified)
+{
+	if (InNotes.empty())
+		return;
+
+	Time timePointMin = std::numeric_limits<int>::max();
+	Time timePointMax = std::numeric_limits<int>::min();
+
+	for (const auto &[column, note] : InNotes)
+	{
+		timePointMin = std::min(timePointMin, note.TimePoint);
+		timePointMax = std::max(timePointMax, note.Type == Note::EType::HoldBegin ? note.TimePointEnd : note.TimePoint);
+	}
+
+	if(!InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+
+	//a hold takes two slots, so this is enough to never grow the slots while handing out handles
+	_NoteSlots.reserve(_NoteSlots.size() + InNotes.size() * 2);
+
+	//gathering everything per column first, so every column gets merged once instead of shifted once per note
+	std::map<Column, std::vector<Note>> notesToMerge;
+
+	for (const auto &[column, note] : InNotes)
+	{
+		switch (note.Type)
+		{
+		case Note::EType::Common:
+		{
+			Note commonNote;
+			commonNote.Type = Note::EType::Common;
+			commonNote.TimePoint = note.TimePoint;
+			commonNote.TimePointBegin = -1;
+			commonNote.TimePointEnd = -1;
+			commonNote.Handle = AllocateNoteHandle();
+
+			notesToMerge[column].push_back(commonNote);
+			RecordEditAction({ EditAction::EType::PlaceNote, column, commonNote });
+		}
+		break;
+
+		case Note::EType::HoldBegin:
+		{
+			Note holdNote;
+			holdNote.TimePointBegin = note.TimePointBegin;
+			holdNote.TimePointEnd = note.TimePointEnd;
+
+			holdNote.Type = Note::EType::HoldBegin;
+			holdNote.TimePoint = note.TimePointBegin;
+			holdNote.Handle = AllocateNoteHandle();
+			notesToMerge[column].push_back(holdNote);
+			RecordEditAction({ EditAction::EType::PlaceNote, column, holdNote });
+
+			holdNote.Type = Note::EType::HoldEnd;
+			holdNote.TimePoint = note.TimePointEnd;
+			holdNote.Handle = AllocateNoteHandle();
+			notesToMerge[column].push_back(holdNote);
+			RecordEditAction({ EditAction::EType::PlaceNote, column, holdNote });
+		}
+		break;
+		}
+	}
+
+	for (auto& [column, notes] : notesToMerge)
+	{
+		auto& noteColumn = GetNoteColumn(column);
+
+		noteColumn.Merge(notes);
+		noteColumn.Holds.Rebuild(noteColumn.Notes);
+
+		ReindexNoteColumn(column);
+	}
+
+	if (InSkipOnModified)
+		return;
+
+	MarkModified(timePointMin, timePointMax);
+}
+
+void Chart::AdoptNoteColumn(const Column InColumn, const Note* InNotes, const size_t InNoteAmount)
+{
+	//the notes come in sorted and complete (beat snaps included), like from a chart cache, so they are taken over as they are
+	auto& noteColumn = GetNoteColumn(InColumn);
+
+	for (const auto& note : noteColumn.Notes)
+		ReleaseNoteHandle(note.Handle);
+
+	noteColumn.Notes.assign(InNotes, InNotes + InNoteAmount);
+
+	_NoteSlots.reserve(_NoteSlots.size() + InNoteAmount);
+
+	for (auto& note : noteColumn.Notes)
+		note.Handle = AllocateNoteHandle();
+
+	noteColumn.Holds.Rebuild(noteColumn.Notes);
+
+	ReindexNoteColumn(InColumn);
+}
+
+void Chart::MirrorNotes(NoteReferenceCollection& OutNotes)
+{
+	if (!OutNotes.HasNotes)
+		return;
+
+	BeginEditHistoryEntry();
+
+	const Time timePointMin = OutNotes.MinTimePoint;
+	const Time timePointMax = OutNotes.MaxTimePoint;
+
+	std::unordered_set<NoteHandle, NoteHandleHash> handlesToMirror;
+	CollectHandlesWithHoldParts(OutNotes, handlesToMirror);
+
+	//the notes are carried over to their mirrored column together with their handles, so the selection stays valid
+	std::map<Column, std::vector<Note>> notesToMerge;
+
+	for (Column column = 0; column < NoteColumns.size(); ++column)
+	{
+		auto &noteCollection = NoteColumns[column].Notes;
+		const Column mirroredColumn = (KeyAmount - 1) - column;
+
+		noteCollection.erase(std::remove_if(noteCollection.begin(), noteCollection.end(), [this, &handlesToMirror, &notesToMerge, column, mirroredColumn](const Note& InNote)
+		{
+			if (handlesToMirror.find(InNote.Handle) == handlesToMirror.end())
+				return false;
+
+			RecordEditAction({ EditAction::EType::RemoveNote, column, InNote });
+			notesToMerge[mirroredColumn].push_back(InNote);
+
+			return true;
+		}), noteCollection.end());
+	}
+
+	//placements are recorded after all removals, so undoing and redoing replays them as two bulk runs
+	for (auto &[column, notes] : notesToMerge)
+	{
+		for (const auto &note : notes)
+			RecordEditAction({ EditAction::EType::PlaceNote, column, note });
+
+		GetNoteColumn(column).Merge(notes);
+	}
+
+	for (Column column = 0; column < NoteColumns.size(); ++column)
+	{
+		NoteColumns[column].Holds.Rebuild(NoteColumns[column].Notes);
+		ReindexNoteColumn(column);
+	}
+
+	//the collection is keyed by column, so it gets rebuilt from the very same handles
+	std::vector<NoteHandle> selectedHandles;
+
+	for (auto &[column, handles] : OutNotes.Notes)
+		selectedHandles.insert(selectedHandles.end(), handles.begin(), handles.end());
+
+	OutNotes.Clear();
+
+	for (const auto &handle : selectedHandles)
+	{
+		Column column;
+
+		if (Note* note = ResolveNote(handle, &column))
+			OutNotes.PushNote(column, *note);
+	}
+
+	MarkModified(timePointMin, timePointMax);
+}
+
+void Chart::MirrorNotes(std::vector<std::pair<Column, Note>>& OutNotes) 
+{
+	for(auto& [column, notes] : OutNotes)
+		column = (KeyAmount - 1) - column;
+}
+
+bool Chart::RemoveNote(const Time InTime, const Column InColumn, const bool InIgnoreHoldChecks, const bool InSkipHistoryRegistering, const bool InSkipOnModified)
+{
+	auto &noteColumn = GetNoteColumn(InColumn);
+
+	auto noteIt = noteColumn.LowerBound(InTime);
+
+	if (noteIt == noteColumn.Notes.end() || noteIt->TimePoint != InTime)
+		return false;
+
+	//hold checks
+	if (InIgnoreHoldChecks == false && (noteIt->Type == Note::EType::HoldBegin || noteIt->Type == Note::EType::HoldEnd))
+	{
+		Time holdTimeBegin = noteIt->TimePointBegin;
+		Time holdTimedEnd = noteIt->TimePointEnd;
+
+		if (!InSkipHistoryRegistering)
+			BeginEditHistoryEntry();
+
+		//begin and end are looked up separately, the hold body only lives in the hold index
+		Note holdNote;
+		holdNote.TimePointBegin = holdTimeBegin;
+		holdNote.TimePointEnd = holdTimedEnd;
+
+		holdNote.Type = Note::EType::HoldEnd;
+		holdNote.TimePoint = holdTimedEnd;
+		EraseNote(InColumn, holdNote);
+
+		holdNote.Type = Note::EType::HoldBegin;
+		holdNote.TimePoint = holdTimeBegin;
+		EraseNote(InColumn, holdNote);
+
+		if(!InSkipOnModified)
+			MarkModified(holdTimeBegin, holdTimedEnd);
+
+		return true;
+	}
+
+	if (!InIgnoreHoldChecks && !InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+
+	const Note noteToRemove = *noteIt;
+	EraseNote(InColumn, noteToRemove);
+
+	if(!InSkipOnModified)
+		MarkModified(InTime, InTime);
+
+	return true;
+}
+
+bool Chart::RemoveBpmPoint(BpmPoint &InBpmPoint, const bool InSkipHistoryRegistering)
+{
+	if (!InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+
+	EditAction action = {};
+	action.Type = EditAction::EType::RemoveBpmPoint;
+	action.FormerBpmPoint = InBpmPoint;
+
+	RecordEditAction(action);
+
+	return EraseBpmPoint(action.FormerBpmPoint.TimePoint);
+}
+
+bool Chart::BulkRemoveNotes(NoteReferenceCollection& InNotes, const bool InSkipHistoryRegistering, const bool InSkipOnModified) 
+{
+	//an empty collection only holds the sentinels of its min and max time
+	if (!InNotes.HasNotes)
+		return false;
+
+	if (!InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+
+	std::unordered_set<NoteHandle, NoteHandleHash> handlesToRemove;
+	CollectHandlesWithHoldParts(InNotes, handlesToRemove);
+
+	//every column gets swept once, so removing a whole selection stays linear in the column size
+	for (Column column = 0; column < NoteColumns.size(); ++column)
+	{
+		auto &noteCollection = NoteColumns[column].Notes;
+		const size_t formerSize = noteCollection.size();
+
+		noteCollection.erase(std::remove_if(noteCollection.begin(), noteCollection.end(), [this, &handlesToRemove, column](const Note& InNote)
+		{
+			if (handlesToRemove.find(InNote.Handle) == handlesToRemove.end())
+				return false;
+
+			RecordEditAction({ EditAction::EType::RemoveNote, column, InNote });
+			ReleaseNoteHandle(InNote.Handle);
+
+			return true;
+		}), noteCollection.end());
+
+		if (noteCollection.size() == formerSize)
+			continue;
+
+		NoteColumns[column].Holds.Rebuild(noteCollection);
+		ReindexNoteColumn(column);
+	}
+
+	if (!InSkipOnModified)
+		MarkModified(InNotes.MinTimePoint, InNotes.MaxTimePoint);
+
+	InNotes.Clear();
+
+	return true;
+}
+
+Note &Chart::InjectNote(const Time InTime, const Column InColumn, const Note::EType InNoteType, const Time InTimeBegin, const Time InTimeEnd, const int InBeatSnap, const bool InSkipOnModified)
+{
+	Note note;
+	note.Type = InNoteType;
+	note.TimePoint = InTime;
+	note.BeatSnap = InBeatSnap;
+
+	note.TimePointBegin = InTimeBegin;
+	note.TimePointEnd = InTimeEnd;
+
+	Note &injectedNoteRef = InsertNote(InColumn, note);
+
+	if(!InSkipOnModified)
+		MarkModified(InTime, InTime);
+
+	return injectedNoteRef;
+}
+
+Note &Chart::InjectHold(const Time InTimeBegin, const Time InTimeEnd, const Column InColumn, const int InBeatSnapBegin, const int InBeatSnapEnd, const bool InSkipOnModified)
+{
+	Note note;
+	note.TimePointBegin = InTimeBegin;
+	note.TimePointEnd = InTimeEnd;
+
+	//the end goes first, so inserting the begin doesn't invalidate the reference to return
+	note.Type = Note::EType::HoldEnd;
+	note.TimePoint = InTimeEnd;
+	note.BeatSnap = InBeatSnapEnd;
+
+	InsertNote(InColumn, note);
+
+	note.Type = Note::EType::HoldBegin;
+	note.TimePoint = InTimeBegin;
+	note.BeatSnap = InBeatSnapBegin;
+
+	Note &noteToReturn = InsertNote(InColumn, note);
+
+	if(!InSkipOnModified)
+		MarkModified(InTimeBegin, InTimeEnd);
+
+	return noteToReturn;
+}
+
+BpmPoint *Chart::InjectBpmPoint(const Time InTime, const double InBpm, const double InBeatLength)
+{
+	EditAction action = {};
+	action.Type = EditAction::EType::PlaceBpmPoint;
+	action.FormerBpmPoint.TimePoint = InTime;
+	action.FormerBpmPoint.Bpm = InBpm;
+	action.FormerBpmPoint.BeatLength = InBeatLength;
+
+	RecordEditAction(action);
+
+	return InsertBpmPoint(action.FormerBpmPoint);
+}
+
+Note *Chart::MoveNote(const Time InTimeFrom, const Time InTimeTo, const Column InColumnFrom, const Column InColumnTo, const int InNewBeatSnap)
+{
+	//have I mentioned that I really dislike handling edge-cases?
+	Note noteToRemove = *FindNote(InTimeFrom, InColumnFrom);
+	Note* movedNote = nullptr;
+
+	//picking the note up again where the last move has dropped it keeps extending the same undo
+	EditCoalesceKey coalesceKey;
+	coalesceKey.Type = EditCoalesceKey::EType::NoteDrag;
+	coalesceKey.TimePoint = InTimeFrom;
+	coalesceKey.NoteColumn = InColumnFrom;
+
+	BeginEditHistoryEntry(coalesceKey);
+	BeginTransaction();
+
+	switch (noteToRemove.Type)
+	{
+	case Note::EType::Common:
+	{
+		RemoveNote(InTimeFrom, InColumnFrom, false, true);
+		movedNote = &(InjectNote(InTimeTo, InColumnTo, Note::EType::Common, -1, -1, InNewBeatSnap));
+	}
+	break;
+
+	case Note::EType::HoldBegin:
+	{
+		RemoveNote(InTimeFrom, InColumnFrom, false, true);
+		movedNote = &(InjectHold(InTimeTo, noteToRemove.TimePointEnd, InColumnTo, InNewBeatSnap));
+	}
+	break;
+	case Note::EType::HoldEnd:
+	{
+		int beatSnap = FindNote(noteToRemove.TimePointBegin, InColumnFrom)->BeatSnap;
+
+		RemoveNote(InTimeFrom, InColumnFrom, false, true);
+		movedNote = &(InjectHold(noteToRemove.TimePointBegin, InTimeTo, InColumnTo, beatSnap));
+	}
+	break;
+
+	default:
+		CommitTransaction();
+		return nullptr;
+		break;
+	}
+
+	CommitTransaction();
+
+	coalesceKey.TimePoint = InTimeTo;
+	coalesceKey.NoteColumn = InColumnTo;
+
+	SetEditHistoryCoalesceKey(coalesceKey);
+
+	return movedNote;
+}
+
+Note *Chart::FindNote(const Time InTime, const Column InColumn)
+{
+	return const_cast<Note*>(std::as_const(*this).FindNote(InTime, InColumn));
+}
+
+const Note *Chart::FindNote(const Time InTime, const Column InColumn) const
+{
+	const NoteColumn* noteColumn = FindNoteColumn(InColumn);
+
+	return noteColumn ? noteColumn->Find(InTime) : nullptr;
+}
+
+Note *Chart::ResolveNote(const NoteHandle InHandle, Column* OutColumn)
+{
+	return const_cast<Note*>(std::as_const(*this).ResolveNote(InHandle, OutColumn));
+}
+
+const Note *Chart::ResolveNote(const NoteHandle InHandle, Column* OutColumn) const
+{
+	if (!InHandle.IsValid() || InHandle.Index >= _NoteSlots.size())
+		return nullptr;
+
+	const auto &slot = _NoteSlots[InHandle.Index];
+
+	if (!slot.IsOccupied || slot.Generation != InHandle.Generation)
+		return nullptr;
+
+	if (OutColumn)
+		*OutColumn = slot.NoteColumn;
+
+	return &(NoteColumns[slot.NoteColumn].Notes[slot.NoteIndex]);
+}
+
+void Chart::DebugPrint()
+{
+	std::cout << DifficultyName << std::endl;
+	std::cout << "***************************" << std::endl;
+
+	for (Column column = 0; column < NoteColumns.size(); ++column)
+	{
+		{
+			for (auto note : NoteColumns[column].Notes)
+			{
+				std::string type = "";
+				switch (note.Type)
+				{
+				case Note::EType::Common:
+					type = "common";
+					break;
+				case Note::EType::HoldBegin:
+					type = "hold begin";
+					break;
+				case Note::EType::HoldEnd:
+					type = "hold end";
+					break;
+
+				default:
+					break;
+				}
+
+				std::cout << GetTimeSliceIndex(note.TimePoint) * _TimeSliceLength << ":" << std::to_string(note.TimePoint) << " - " << std::to_string(column) << " - " << type << std::endl;
+			}
+		}
+	}
+
+	std::cout << std::endl;
+}
+
+void Chart::RegisterOnModifiedCallback(std::function<void(const Time, const Time)> InCallback)
+{
+	_OnModified = InCallback;
+}
+
+void Chart::RegisterOnEditActionCallback(std::function<void(const EditAction&)> InCallback)
+{
+	_OnEditAction = InCallback;
+}
+
+void Chart::ReplayEditActions(const std::vector<EditAction>& InActions)
+{
+	if (InActions.empty())
+		return;
+
+	BeginTransaction();
+
+	ApplyEditActions(InActions, false);
+
+	for (const EditAction& action : InActions)
+	{
+		//scroll velocities change nothing about the notes
+		if (action.Type == EditAction::EType::PlaceNote || action.Type == EditAction::EType::RemoveNote)
+			MarkModified(action.ActionNote.TimePoint, action.ActionNote.TimePoint);
+		else if (action.Type != EditAction::EType::PlaceScrollVelocity && action.Type != EditAction::EType::RemoveScrollVelocity)
+		{
+			const Time latterTimePoint = action.Type == EditAction::EType::ModifyBpmPoint ? action.LatterBpmPoint.TimePoint : action.FormerBpmPoint.TimePoint;
+			MarkModified(std::min(action.FormerBpmPoint.TimePoint, latterTimePoint), std::max(action.FormerBpmPoint.TimePoint, latterTimePoint));
+		}
+	}
+
+	CommitTransaction();
+}
+
+void Chart::RecordEditAction(const EditAction& InAction)
+{
+	_EditHistory.RecordAction(InAction);
+
+	if (_OnEditAction)
+		_OnEditAction(InAction);
+}
+
+void Chart::BeginTransaction()
+{
+	_TransactionDepth++;
+}
+
+void Chart::CommitTransaction()
+{
+	if (_TransactionDepth == 0 || --_TransactionDepth > 0)
+		return;
+
+	if (!_HasDirtyTimeRange)
+		return;
+
+	_HasDirtyTimeRange = false;
+
+	//widened to whole slices, so a run of small edits close to each other redoes the same range
+	const Time timeBegin = GetTimeSliceIndex(_DirtyTimeBegin) * _TimeSliceLength;
+	const Time timeEnd = (GetTimeSliceIndex(_DirtyTimeEnd) + 1) * _TimeSliceLength - 1;
+
+	_OnModified(timeBegin, timeEnd);
+}
+
+bool Chart::IsAPotentialNoteDuplicate(const Time InTime, const Column InColumn) const
+{
+	return FindNote(InTime, InColumn) != nullptr;
+}
+
+Time Chart::GetTimeSliceLength() const
+{
+	return _TimeSliceLength;
+}
+
+void Chart::SetTimeSliceLength(const Time InTimeSliceLength)
+{
+	const Time timeSliceLength = std::clamp(InTimeSliceLength, TIMESLICE_LENGTH_MIN, TIMESLICE_LENGTH_MAX);
+
+	_TimeSliceLength = timeSliceLength;
+}
+
+void Chart::AdaptTimeSliceLength()
+{
+	size_t noteAmount = 0;
+	Time firstTimePoint = std::numeric_limits<Time>::max();
+	Time lastTimePoint = std::numeric_limits<Time>::min();
+
+	for (auto &noteColumn : NoteColumns)
+	{
+		if (noteColumn.Notes.empty())
+			continue;
+
+		noteAmount += noteColumn.Notes.size();
+		firstTimePoint = std::min(firstTimePoint, noteColumn.Notes.front().TimePoint);
+		lastTimePoint = std::max(lastTimePoint, noteColumn.Notes.back().TimePoint);
+	}
+
+	if (noteAmount < 2 || lastTimePoint <= firstTimePoint)
+		return SetTimeSliceLength(TIMESLICE_LENGTH);
+
+	//dense charts get short slices so a modification redoes less around it. a longer slice than the default would only widen the redone range, so sparse charts keep that
+	const double timeSliceLength = double(lastTimePoint - firstTimePoint) * TIMESLICE_TARGET_NOTE_AMOUNT / double(noteAmount);
+
+	SetTimeSliceLength(std::min(Time(timeSliceLength / 50.0 + 0.5) * 50, TIMESLICE_LENGTH));
+}
+
+void Chart::FillNoteCollectionWithAllNotes(NoteReferenceCollection& OutNotes) 
+{
+	OutNotes.Clear();
+
+	IterateAllNotes([&OutNotes](Note& InNote, Column InColumn)
+	{
+		OutNotes.PushNote(InColumn, InNote);
+	});
+}
+
+Time Chart::GetLastNoteTimePoint() const
+{
+	Time lastTimePoint = 0;
+
+	for (auto& noteColumn : NoteColumns)
+		if (!noteColumn.Notes.empty())
+			lastTimePoint = std::max(lastTimePoint, noteColumn.Notes.back().TimePoint);
+
+	return lastTimePoint;
+}
+
+NoteHandle Chart::AllocateNoteHandle()
+{
+	if (_FreeNoteSlots.empty())
+	{
+		_FreeNoteSlots.push_back(uint32_t(_NoteSlots.size()));
+		_NoteSlots.emplace_back();
+	}
+
+	const uint32_t index = _FreeNoteSlots.back();
+	_FreeNoteSlots.pop_back();
 
-	auto timeSliceIt = TimeSlices.find(relevantTimeSlice.Index);
+	auto &slot = _NoteSlots[index];
+	slot.IsOccupied = true;
 
-	while (timeSliceIt != TimeSlices.end())
+	NoteHandle handle;
+	handle.Index = index;
+	handle.Generation = slot.Generation;
+
+	return handle;
+}
+
+void Chart::ReleaseNoteHandle(const NoteHandle InHandle)
+{
+	if (!InHandle.IsValid() || InHandle.Index >= _NoteSlots.size())
+		return;
+
+	auto &slot = _NoteSlots[InHandle.Index];
+
+	if (!slot.IsOccupied || slot.Generation != InHandle.Generation)
+		return;
+
+	slot.IsOccupied = false;
+	slot.Generation++;
+
+	_FreeNoteSlots.push_back(InHandle.Index);
+}
+
+void Chart::ReindexNoteColumn(const Column InColumn, const size_t InFromIndex)
+{
+	//only the notes at or behind a change have shifted, which is the same range the change had to move anyways
+	auto &noteCollection = NoteColumns[InColumn].Notes;
+
+	for (size_t index = InFromIndex; index < noteCollection.size(); ++index)
+	{
+		auto &slot = _NoteSlots[noteCollection[index].Handle.Index];
+
+		slot.NoteColumn = InColumn;
+		slot.NoteIndex = index;
+	}
+}
+
+void Chart::CollectHandlesWithHoldParts(NoteReferenceCollection& InNotes, std::unordered_set<NoteHandle, NoteHandleHash>& OutHandles)
+{
+	//selecting either part of a hold stands for the whole hold
+	for (auto &[column, handles] : InNotes.Notes)
 	{
-		auto &currentTimeSlice = *timeSliceIt;
+		for (const auto &handle : handles)
+		{
+			Column noteColumn;
+			Note* note = ResolveNote(handle, &noteColumn);
+
+			if (!note)
+				continue;
+
+			OutHandles.insert(handle);
+
+			Note* holdPart = nullptr;
 
-		for (auto &bpmPoint : currentTimeSlice.second.BpmPoints)
-			if (bpmPoint.TimePoint > InTime)
-				return &bpmPoint;
+			if (note->Type == Note::EType::HoldBegin)
+				holdPart = NoteColumns[noteColumn].FindHoldEnd(note->TimePointBegin, note->TimePointEnd);
+			else if (note->Type == Note::EType::HoldEnd)
+				holdPart = NoteColumns[noteColumn].FindHoldBegin(note->TimePointBegin, note->TimePointEnd);
 
-		timeSliceIt++;
+			if (holdPart)
+				OutHandles.insert(holdPart->Handle);
+		}
 	}
+}
 
-	return nullptr;
+NoteColumn& Chart::GetNoteColumn(const Column InColumn)
+{
+	if (InColumn >= NoteColumns.size())
+		NoteColumns.resize(InColumn + 1);
+
+	return NoteColumns[InColumn];
+}
+
+const NoteColumn* Chart::FindNoteColumn(const Column InColumn) const
+{
+	return InColumn < NoteColumns.size() ? &NoteColumns[InColumn] : nullptr;
+}
+
+int Chart::GetTimeSliceIndex(const Time InTime) const
+{
+	//flooring, so negative time points get their own slices instead of sharing the one at 0
+	return InTime >= 0 ? InTime / _TimeSliceLength : (InTime - _TimeSliceLength + 1) / _TimeSliceLength;
+}
+
+Note& Chart::InsertNote(const Column InColumn, const Note& InNote)
+{
+	auto &noteColumn = GetNoteColumn(InColumn);
+
+	Note note = InNote;
+	note.Handle = AllocateNoteHandle();
+
+	Note &insertedNote = noteColumn.Insert(note);
+	ReindexNoteColumn(InColumn, &insertedNote - noteColumn.Notes.data());
+
+	if (note.Type == Note::EType::HoldBegin)
+		noteColumn.Holds.Insert(note.TimePointBegin, note.TimePointEnd);
+
+	RecordEditAction({ EditAction::EType::PlaceNote, InColumn, note });
+
+	return insertedNote;
+}
+
+bool Chart::EraseNote(const Column InColumn, const Note& InNote)
+{
+	auto &noteColumn = GetNoteColumn(InColumn);
+
+	for (auto noteIt = noteColumn.LowerBound(InNote.TimePoint); noteIt != noteColumn.Notes.end() && noteIt->TimePoint == InNote.TimePoint; ++noteIt)
+	{
+		if (noteIt->Type != InNote.Type)
+			continue;
+
+		if (InNote.Type != Note::EType::Common && (noteIt->TimePointBegin != InNote.TimePointBegin || noteIt->TimePointEnd != InNote.TimePointEnd))
+			continue;
+
+		if (InNote.Type == Note::EType::HoldBegin)
+			noteColumn.Holds.Erase(InNote.TimePointBegin, InNote.TimePointEnd);
+
+		RecordEditAction({ EditAction::EType::RemoveNote, InColumn, *noteIt });
+		ReleaseNoteHandle(noteIt->Handle);
+
+		ReindexNoteColumn(InColumn, noteColumn.Notes.erase(noteIt) - noteColumn.Notes.begin());
+
+		return true;
+	}
+
+	return false;
+}
+
+BpmPoint* Chart::InsertBpmPoint(const BpmPoint& InBpmPoint)
+{
+	return _TempoMap.Insert(InBpmPoint);
+}
+
+bool Chart::EraseBpmPoint(const Time InTime)
+{
+	return _TempoMap.Erase(InTime);
+}
+
+void Chart::MarkModified(const Time InTimeBegin, const Time InTimeEnd)
+{
+	//an inverted range is what an empty min and max leave behind, nothing was modified then
+	if (InTimeBegin > InTimeEnd)
+		return;
+
+	if (!_HasDirtyTimeRange)
+	{
+		_DirtyTimeBegin = InTimeBegin;
+		_DirtyTimeEnd = InTimeEnd;
+		_HasDirtyTimeRange = true;
+	}
+	else
+	{
+		_DirtyTimeBegin = std::min(_DirtyTimeBegin, InTimeBegin);
+		_DirtyTimeEnd = std::max(_DirtyTimeEnd, InTimeEnd);
+	}
+
+	//outside of a transaction every modification is a transaction of its own
+	if (_TransactionDepth == 0)
+	{
+		BeginTransaction();
+		CommitTransaction();
+	}
+}
+
+void Chart::MergeNotes(const Column InColumn, std::vector<Note>& InOutNotes)
+{
+	auto &noteColumn = GetNoteColumn(InColumn);
+
+	for (auto &note : InOutNotes)
+	{
+		note.Handle = AllocateNoteHandle();
+		RecordEditAction({ EditAction::EType::PlaceNote, InColumn, note });
+	}
+
+	noteColumn.Merge(InOutNotes);
+	noteColumn.Holds.Rebuild(noteColumn.Notes);
+
+	ReindexNoteColumn(InColumn);
+}
+
+void Chart::SweepNotes(const Column InColumn, const std::vector<Note>& InNotes)
+{
+	auto &noteColumn = GetNoteColumn(InColumn);
+
+	//same matching as EraseNote, every entry takes out one note
+	std::multiset<std::tuple<Time, Note::EType, Time, Time>> notesToErase;
+
+	for (const auto &note : InNotes)
+	{
+		const bool isHoldPart = note.Type != Note::EType::Common;
+		notesToErase.insert({ note.TimePoint, note.Type, isHoldPart ? note.TimePointBegin : 0, isHoldPart ? note.TimePointEnd : 0 });
+	}
+
+	noteColumn.Notes.erase(std::remove_if(noteColumn.Notes.begin(), noteColumn.Notes.end(), [this, &notesToErase, InColumn](const Note& InNote)
+	{
+		const bool isHoldPart = InNote.Type != Note::EType::Common;
+		auto keyIt = notesToErase.find({ InNote.TimePoint, InNote.Type, isHoldPart ? InNote.TimePointBegin : 0, isHoldPart ? InNote.TimePointEnd : 0 });
+
+		if (keyIt == notesToErase.end())
+			return false;
+
+		notesToErase.erase(keyIt);
+
+		RecordEditAction({ EditAction::EType::RemoveNote, InColumn, InNote });
+		ReleaseNoteHandle(InNote.Handle);
+
+		return true;
+	}), noteColumn.Notes.end());
+
+	noteColumn.Holds.Rebuild(noteColumn.Notes);
+
+	ReindexNoteColumn(InColumn);
+}
+
+void Chart::ApplyEditActions(const std::vector<EditAction>& InActions, const bool InIsUndo)
+{
+	//consecutive note actions of the same kind are replayed column by column, so a large undo doesn't shift the columns once per note
+	std::map<Column, std::vector<Note>> notesPerColumn;
+	bool isInsertingRun = false;
+
+	auto flushRun = [this, &notesPerColumn, &isInsertingRun]()
+	{
+		for (auto &[column, notes] : notesPerColumn)
+			isInsertingRun ? MergeNotes(column, notes) : SweepNotes(column, notes);
+
+		notesPerColumn.clear();
+	};
+
+	for (size_t index = 0; index < InActions.size(); ++index)
+	{
+		const EditAction &action = InActions[InIsUndo ? InActions.size() - 1 - index : index];
+
+		if (action.Type != EditAction::EType::PlaceNote && action.Type != EditAction::EType::RemoveNote)
+		{
+			flushRun();
+			ApplyEditAction(action, InIsUndo);
+
+			continue;
+		}
+
+		const bool isInserting = (action.Type == EditAction::EType::PlaceNote) != InIsUndo;
+
+		if (isInserting != isInsertingRun)
+		{
+			flushRun();
+			isInsertingRun = isInserting;
+		}
+
+		notesPerColumn[action.NoteColumn].push_back(action.ActionNote);
+	}
+
+	flushRun();
+}
+
+void Chart::ApplyEditAction(const EditAction& InAction, const bool InIsUndo)
+{
+	switch (InAction.Type)
+	{
+	case EditAction::EType::PlaceNote:
+		InIsUndo ? (void)EraseNote(InAction.NoteColumn, InAction.ActionNote) : (void)InsertNote(InAction.NoteColumn, InAction.ActionNote);
+		break;
+
+	case EditAction::EType::RemoveNote:
+		InIsUndo ? (void)InsertNote(InAction.NoteColumn, InAction.ActionNote) : (void)EraseNote(InAction.NoteColumn, InAction.ActionNote);
+		break;
+
+	//the note actions above get reported by InsertNote and EraseNote, bpm points have to report what actually happened on their own
+	case EditAction::EType::PlaceBpmPoint:
+		InIsUndo ? (void)EraseBpmPoint(InAction.FormerBpmPoint.TimePoint) : (void)InsertBpmPoint(InAction.FormerBpmPoint);
+
+		if (_OnEditAction)
+			_OnEditAction({ InIsUndo ? EditAction::EType::RemoveBpmPoint : EditAction::EType::PlaceBpmPoint, 0, Note(), InAction.FormerBpmPoint });
+		break;
+
+	case EditAction::EType::RemoveBpmPoint:
+		InIsUndo ? (void)InsertBpmPoint(InAction.FormerBpmPoint) : (void)EraseBpmPoint(InAction.FormerBpmPoint.TimePoint);
+
+		if (_OnEditAction)
+			_OnEditAction({ InIsUndo ? EditAction::EType::PlaceBpmPoint : EditAction::EType::RemoveBpmPoint, 0, Note(), InAction.FormerBpmPoint });
+		break;
+
+	case EditAction::EType::ModifyBpmPoint:
+	{
+		const BpmPoint &bpmPointFrom = InIsUndo ? InAction.LatterBpmPoint : InAction.FormerBpmPoint;
+		const BpmPoint &bpmPointTo = InIsUndo ? InAction.FormerBpmPoint : InAction.LatterBpmPoint;
+
+		EraseBpmPoint(bpmPointFrom.TimePoint);
+		InsertBpmPoint(bpmPointTo);
+
+		if (_OnEditAction)
+			_OnEditAction({ EditAction::EType::ModifyBpmPoint, 0, Note(), bpmPointFrom, bpmPointTo });
+	}
+	break;
+
+	case EditAction::EType::PlaceScrollVelocity:
+	case EditAction::EType::RemoveScrollVelocity:
+	{
+		const bool isInserting = (InAction.Type == EditAction::EType::PlaceScrollVelocity) != InIsUndo;
+
+		if (isInserting)
+			_ScrollVelocityMap.Insert(InAction.ActionScrollVelocity);
+		else
+			_ScrollVelocityMap.Erase(InAction.ActionScrollVelocity.TimePoint);
+
+		if (_OnEditAction)
+		{
+			EditAction appliedAction = {};
+			appliedAction.Type = isInserting ? EditAction::EType::PlaceScrollVelocity : EditAction::EType::RemoveScrollVelocity;
+			appliedAction.ActionScrollVelocity = InAction.ActionScrollVelocity;
+
+			_OnEditAction(appliedAction);
+		}
+	}
+	break;
+	}
+}
+
+void Chart::RevaluateBpmPoint(BpmPoint &InFormerBpmPoint, BpmPoint &InMovedBpmPoint)
+{
+	//the point has been moved in place, the tempo map only has to catch up on its order
+	RegisterBpmPointModification(InFormerBpmPoint, InMovedBpmPoint);
+}
+
+void Chart::RegisterBpmPointModification(const BpmPoint& InFormerBpmPoint, const BpmPoint& InModifiedBpmPoint)
+{
+	EditAction action = {};
+	action.Type = EditAction::EType::ModifyBpmPoint;
+	action.FormerBpmPoint = InFormerBpmPoint;
+	action.LatterBpmPoint = InModifiedBpmPoint;
+
+	RecordEditAction(action);
+
+	_TempoMap.Refresh();
+}
+
+void Chart::BeginEditHistoryEntry(const EditCoalesceKey& InCoalesceKey)
+{
+	_EditHistory.BeginEntry(InCoalesceKey);
+}
+
+void Chart::SetEditHistoryCoalesceKey(const EditCoalesceKey& InCoalesceKey)
+{
+	_EditHistory.SetCoalesceKey(InCoalesceKey);
+}
+
+void Chart::SetEditHistoryMemoryBudget(const size_t InBytes)
+{
+	_EditHistory.SetMemoryBudget(InBytes);
+}
+
+bool Chart::Undo()
+{
+	_EditHistory.EndEntry();
+
+	if (!_EditHistory.CanUndo())
+		return false;
+
+	EditHistoryEntry entry = _EditHistory.TakeUndoEntry();
+
+	BeginTransaction();
+
+	ApplyEditActions(entry.Actions, true);
+	MarkModified(entry.TimePointMin, entry.TimePointMax);
+
+	CommitTransaction();
+
+	_EditHistory.PushRedoEntry(std::move(entry));
+
+	return true;
+}
+
+bool Chart::Redo()
+{
+	_EditHistory.EndEntry();
+
+	if (!_EditHistory.CanRedo())
+		return false;
+
+	EditHistoryEntry entry = _EditHistory.TakeRedoEntry();
+
+	BeginTransaction();
+
+	ApplyEditActions(entry.Actions, false);
+	MarkModified(entry.TimePointMin, entry.TimePointMax);
+
+	CommitTransaction();
+
+	_EditHistory.PushUndoEntry(std::move(entry));
+
+	return true;
+}
+
+void Chart::GetBpmPointsRelatedToTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::vector<BpmPoint*>& OutBpmPoints)
+{
+	_TempoMap.GetPointsRelatedToTimeRange(InTimeBegin, InTimeEnd, OutBpmPoints);
+}
+
+BpmPoint *Chart::GetPreviousBpmPointFromTimePoint(const Time InTime)
+{
+	return _TempoMap.GetPreviousPoint(InTime);
+}
+
+BpmPoint *Chart::GetNextBpmPointFromTimePoint(const Time InTime)
+{
+	return _TempoMap.GetNextPoint(InTime);
+}
+
+double Chart::GetBeatFromTimePoint(const Time InTime)
+{
+	return _TempoMap.GetBeatFromTimePoint(InTime);
+}
+
+double Chart::GetTimePointFromBeat(const double InBeat)
+{
+	return _TempoMap.GetTimePointFromBeat(InBeat);
+}
+
+void Chart::RefreshTempoMap()
+{
+	_TempoMap.Refresh();
+}
+
+bool Chart::PlaceScrollVelocity(const double InTime, const double InMultiplier, const bool InSkipHistoryRegistering)
+{
+	const ScrollVelocityMultiplier* previousPoint = _ScrollVelocityMap.GetPreviousPoint(InTime);
+
+	//volume, samples and kiai go on as they were, only the multiplier changes
+	ScrollVelocityMultiplier point = previousPoint ? *previousPoint : ScrollVelocityMultiplier();
+
+	const bool isReplacing = previousPoint && previousPoint->TimePoint == InTime;
+
+	if (isReplacing && point.Multiplier == InMultiplier)
+		return false;
+
+	if (!InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+
+	if (isReplacing)
+		EjectScrollVelocity(point);
+
+	point.TimePoint = InTime;
+	point.Multiplier = InMultiplier;
+	point.BeatLength = 0.0;
+
+	InjectScrollVelocity(point);
+
+	return true;
+}
+
+bool Chart::RemoveScrollVelocity(const double InTime, const bool InSkipHistoryRegistering)
+{
+	const ScrollVelocityMultiplier* point = _ScrollVelocityMap.Find(InTime);
+
+	if (!point)
+		return false;
+
+	if (!InSkipHistoryRegistering)
+		BeginEditHistoryEntry();
+
+	EjectScrollVelocity(*point);
+
+	return true;
+}
+
+void Chart::AdoptScrollVelocities(std::vector<ScrollVelocityMultiplier>&& InPoints)
+{
+	_ScrollVelocityMap.Assign(std::move(InPoints));
+}
+
+const ScrollVelocityMap& Chart::GetScrollVelocityMap() const
+{
+	return _ScrollVelocityMap;
+}
+
+void Chart::InjectScrollVelocity(const ScrollVelocityMultiplier& InPoint)
+{
+	EditAction action = {};
+	action.Type = EditAction::EType::PlaceScrollVelocity;
+	action.ActionScrollVelocity = InPoint;
+
+	RecordEditAction(action);
+
+	_ScrollVelocityMap.Insert(InPoint);
+}
+
+void Chart::EjectScrollVelocity(const ScrollVelocityMultiplier& InPoint)
+{
+	EditAction action = {};
+	action.Type = EditAction::EType::RemoveScrollVelocity;
+	action.ActionScrollVelocity = InPoint;
+
+	RecordEditAction(action);
+
+	_ScrollVelocityMap.Erase(action.ActionScrollVelocity.TimePoint);
+}
+
+size_t Chart::GetBpmPointAmount() const
+{
+	return _TempoMap.GetSize();
+}
+
+ChartSnapshot Chart::TakeSnapshot() const
+{
+	ChartSnapshot snapshot;
+
+	snapshot.ArtistUnicode = ArtistUnicode;
+	snapshot.Artist = Artist;
+	snapshot.SongtitleUnicode = SongtitleUnicode;
+	snapshot.SongTitle = SongTitle;
+	snapshot.Charter = Charter;
+	snapshot.DifficultyName = DifficultyName;
+	snapshot.Source = Source;
+	snapshot.Tags = Tags;
+	snapshot.BeatmapID = BeatmapID;
+	snapshot.BeatmapSetID = BeatmapSetID;
+	snapshot.AudioPath = AudioPath;
+	snapshot.BackgroundPath = BackgroundPath;
+	snapshot.KeyAmount = KeyAmount;
+	snapshot.HasScratchKey = HasScratchKey;
+	snapshot.HP = HP;
+	snapshot.OD = OD;
+
+	snapshot.BpmPoints.reserve(GetBpmPointAmount());
+	IterateAllBpmPoints([&snapshot](const BpmPoint& InBpmPoint) { snapshot.BpmPoints.push_back(InBpmPoint); });
+
+	snapshot.ScrollVelocities = _ScrollVelocityMap.GetPoints();
+
+	size_t noteAmount = 0;
+	for (const auto& noteColumn : NoteColumns)
+		noteAmount += noteColumn.Notes.size();
+
+	snapshot.Notes.reserve(noteAmount);
+	IterateAllNotes([&snapshot](const Note& InNote, const Column InColumn) { snapshot.Notes.push_back({ InColumn, InNote }); });
+
+	return snapshot;
 }
 
 Chart::Chart()
 {
-	_OnModified = [](TimeSlice &InOutTimeSlice) {};
+	_OnModified = [](const Time InTimeBegin, const Time InTimeEnd) {};
 }
 
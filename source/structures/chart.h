@@ -2,13 +2,16 @@
 
 #include <map>
 #include <vector>
-#include <stack>
+#include <deque>
+#include <list>
 #include <map>
 #include <string>
 #include <utility>
 #include <functional>
 #include <unordered_set>
 #include <filesystem>
+#include <cstdint>
+#include <limits>
 
 /*
 * these types should not have any dependencies on any systems or modules.
@@ -16,18 +19,58 @@
 * worth to note is that this datastructure makes assumptions in which type certain metrics are.
 */
 
+/*
+* time slices are no containers, only the grid a modified time range gets widened to before the listeners redo their snaps and minimap around it.
+* the default length, every chart can change its own at runtime within the bounds below.
+*/
 #define TIMESLICE_LENGTH 500
+#define TIMESLICE_LENGTH_MIN 100
+#define TIMESLICE_LENGTH_MAX 4000
+//the amount of notes an adapted slice holds on average
+#define TIMESLICE_TARGET_NOTE_AMOUNT 24
 
 typedef int Time;
 typedef size_t Column;
 
+/*
+* refers to a note through the chart's slot map instead of its address, so it survives the column being shifted around.
+* once the note is removed the slot's generation moves on and the handle simply stops resolving.
+*/
+struct NoteHandle
+{
+	uint32_t Index = std::numeric_limits<uint32_t>::max();
+	uint32_t Generation = 0;
+
+	bool IsValid() const
+	{
+		return Index != std::numeric_limits<uint32_t>::max();
+	}
+
+	bool operator==(const NoteHandle& InOther) const
+	{
+		return Index == InOther.Index && Generation == InOther.Generation;
+	}
+
+	bool operator!=(const NoteHandle& InOther) const
+	{
+		return !(*this == InOther);
+	}
+};
+
+struct NoteHandleHash
+{
+	size_t operator()(const NoteHandle& InHandle) const
+	{
+		return std::hash<uint64_t>()((uint64_t(InHandle.Generation) << 32) | InHandle.Index);
+	}
+};
+
 struct Note
 {
 	enum class EType
 	{
 		Common,
 		HoldBegin,
-		HoldIntermediate,
 		HoldEnd,
 
 		COUNT
@@ -38,6 +81,8 @@ struct Note
 
 	Time TimePointBegin = 0;
 	Time TimePointEnd = 0;
+
+	NoteHandle Handle;
 };
 
 struct BpmPoint
@@ -53,32 +98,297 @@ struct BpmPoint
 	}
 };
 
+/*
+* a scroll velocity point, in effect from its time point on until the next one.
+* the time point keeps its fraction since quaver and osu!lazer write scroll velocities off the millisecond grid.
+*/
 struct ScrollVelocityMultiplier
 {
-	Time TimePoint;
-	double Multiplier;
+	double TimePoint = 0.0;
+	double Multiplier = 1.0;
+
+	//the beat length of the osu line the point was read from, so it gets written back digit for digit. 0 once the multiplier is edited
+	double BeatLength = 0.0;
+
+	//the rest of an osu timing point, the editor has no use for them but saving must not lose them
+	int Meter = 4;
+	int SampleSet = 0;
+	int SampleIndex = 0;
+	int Volume = 10;
+	int Effects = 0;
 };
 
-struct TimeSlice
+struct Hold
 {
-	Time TimePoint;
+	Time TimePointBegin;
+	Time TimePointEnd;
 
-	int Index;
+	bool operator<(const Hold& InOther) const
+	{
+		return TimePointBegin < InOther.TimePointBegin || (TimePointBegin == InOther.TimePointBegin && TimePointEnd < InOther.TimePointEnd);
+	}
+};
+
+/*
+* every hold of one column stored once as a begin/end pair, sorted by begin and augmented with the running maximum end.
+* the maximum ends are ascending, so the first hold that could reach into a range is binary searched as well.
+*/
+struct HoldIndex
+{
+	void Insert(const Time InTimeBegin, const Time InTimeEnd);
+	bool Erase(const Time InTimeBegin, const Time InTimeEnd);
+	void Rebuild(const std::vector<Note>& InNotes);
+
+	template<typename TWork>
+	void IterateOverlapping(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork) const
+	{
+		size_t first, last;
+		GetOverlappingRange(InTimeBegin, InTimeEnd, first, last);
+
+		for (size_t index = first; index < last; ++index)
+			if (Holds[index].TimePointEnd >= InTimeBegin)
+				InWork(Holds[index]);
+	}
+
+	std::vector<Hold> Holds;
+	std::vector<Time> MaxTimePointEnds;
+
+private:
+
+	void GetOverlappingRange(const Time InTimeBegin, const Time InTimeEnd, size_t& OutFirst, size_t& OutLast) const;
+	void UpdateMaxTimePointEnds(const size_t InFromIndex);
+};
+
+/*
+* all notes of one column, stored contiguously and sorted by time point.
+* range queries are binary searched, so a query only ever touches the notes it actually returns.
+* holds are represented by their begin and end note, their body lives in the hold index.
+*/
+struct NoteColumn
+{
+	typedef std::vector<Note>::iterator Iterator;
+	typedef std::vector<Note>::const_iterator ConstIterator;
+
+	Iterator LowerBound(const Time InTime);
+	Iterator UpperBound(const Time InTime);
+	ConstIterator LowerBound(const Time InTime) const;
+	ConstIterator UpperBound(const Time InTime) const;
+
+	Note& Insert(const Note& InNote);
+	void Merge(std::vector<Note>& InOutNotes);
+
+	Note* Find(const Time InTime);
+	const Note* Find(const Time InTime) const;
+	Note* FindHoldBegin(const Time InTimeBegin, const Time InTimeEnd);
+	const Note* FindHoldBegin(const Time InTimeBegin, const Time InTimeEnd) const;
+	Note* FindHoldEnd(const Time InTimeBegin, const Time InTimeEnd);
+	const Note* FindHoldEnd(const Time InTimeBegin, const Time InTimeEnd) const;
+	bool Contains(const Time InTime) const;
 	
-	std::map<Column, std::vector<Note>> Notes;
+	std::vector<Note> Notes;
+	HoldIndex Holds;
+};
 
-	std::vector<BpmPoint> BpmPoints;
-	std::vector<ScrollVelocityMultiplier> SvMultipliers;
+struct TempoMapPoint
+{
+	std::list<BpmPoint>::iterator Point;
+	double Beat = 0.0;
+};
+
+/*
+* every bpm point of the chart sorted by time point, each augmented with the amount of beats that have passed since the first one.
+* the points themselves never move in memory, so pointers to them stay valid until that very point gets erased.
+* points edited in place through such a pointer need a Refresh afterwards to restore the order and the beats.
+*/
+class TempoMap
+{
+public:
+
+	BpmPoint* Insert(const BpmPoint& InBpmPoint);
+	bool Erase(const Time InTime);
+	void Refresh();
+
+	BpmPoint* GetPreviousPoint(const Time InTime) const;
+	BpmPoint* GetNextPoint(const Time InTime) const;
+	void GetPointsRelatedToTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::vector<BpmPoint*>& OutBpmPoints) const;
+
+	double GetBeatFromTimePoint(const Time InTime) const;
+	double GetTimePointFromBeat(const double InBeat) const;
+
+	template<typename TWork>
+	void IterateAll(TWork&& InWork) const
+	{
+		for (const auto& tempoMapPoint : _SortedPoints)
+			InWork(*tempoMapPoint.Point);
+	}
+
+	size_t GetSize() const;
+
+private:
+
+	size_t GetUpperBoundIndex(const Time InTime) const;
+	void UpdateBeats(const size_t InFromIndex);
+
+	std::list<BpmPoint> _Points;
+	std::vector<TempoMapPoint> _SortedPoints;
+};
+
+/*
+* every scroll velocity point of the chart sorted by time point, each augmented with the scroll position it is reached at.
+* the scroll position is the integral of the multipliers over time, so mapping a time point onto it is one binary search.
+* before the first point everything scrolls with a multiplier of 1, without any points the scroll position is the time point itself.
+* negative multipliers scroll backwards, which is why the reverse lookups go through the running extremes of the positions instead.
+*/
+class ScrollVelocityMap
+{
+public:
+
+	void Assign(std::vector<ScrollVelocityMultiplier>&& InPoints);
+	void Insert(const ScrollVelocityMultiplier& InPoint);
+	bool Erase(const double InTime);
+
+	const ScrollVelocityMultiplier* Find(const double InTime) const;
+	const ScrollVelocityMultiplier* GetPreviousPoint(const double InTime) const;
+
+	double GetScrollPosition(const double InTime) const;
+
+	//the earliest time point at or past the scroll position and the latest one at or before it, infinite if there is none
+	double GetFirstTimePointReaching(const double InScrollPosition) const;
+	double GetLastTimePointBelow(const double InScrollPosition) const;
+
+	template<typename TWork>
+	void IterateInTimeRange(const double InTimeBegin, const double InTimeEnd, TWork&& InWork) const
+	{
+		for (size_t index = GetLowerBoundIndex(InTimeBegin); index < _Points.size() && _Points[index].TimePoint <= InTimeEnd; ++index)
+			InWork(_Points[index]);
+	}
+
+	const std::vector<ScrollVelocityMultiplier>& GetPoints() const;
+	size_t GetSize() const;
+
+private:
+
+	size_t GetLowerBoundIndex(const double InTime) const;
+	size_t GetUpperBoundIndex(const double InTime) const;
+	void UpdatePositions();
+
+	std::vector<ScrollVelocityMultiplier> _Points;
+	std::vector<double> _Positions;
+
+	//the maximum of every position up to a point and the minimum of every position from a point on, both ascending
+	std::vector<double> _MaxPositions;
+	std::vector<double> _MinPositions;
+};
+
+/*
+* a single change to the chart, holds are recorded as their begin and end note.
+* undoing applies the inverse of every action in reverse order, redoing applies them as recorded.
+*/
+struct EditAction
+{
+	enum class EType
+	{
+		PlaceNote,
+		RemoveNote,
+		PlaceBpmPoint,
+		RemoveBpmPoint,
+		ModifyBpmPoint,
+		PlaceScrollVelocity,
+		RemoveScrollVelocity,
+
+		COUNT
+	} Type;
+
+	Column NoteColumn = 0;
+	Note ActionNote;
+
+	BpmPoint FormerBpmPoint;
+	BpmPoint LatterBpmPoint;
+
+	ScrollVelocityMultiplier ActionScrollVelocity;
+};
+
+//entries only coalesce when the new one continues exactly where the previous one has left off
+struct EditCoalesceKey
+{
+	enum class EType
+	{
+		None,
+		NoteDrag,
+		SelectionDrag,
+		BpmPointDrag,
+		ScrollVelocityEdit,
+
+		COUNT
+	} Type = EType::None;
+
+	Time TimePoint = 0;
+	Column NoteColumn = 0;
+
+	bool operator==(const EditCoalesceKey& InOther) const
+	{
+		return Type == InOther.Type && TimePoint == InOther.TimePoint && NoteColumn == InOther.NoteColumn;
+	}
+};
+
+struct EditHistoryEntry
+{
+	size_t GetMemoryFootprint() const;
+
+	std::vector<EditAction> Actions;
+	EditCoalesceKey CoalesceKey;
+
+	Time TimePointMin;
+	Time TimePointMax;
+};
+
+/*
+* undo and redo history made out of deltas. only the currently open entry gets recorded into, actions done without one are not undoable.
+* once the memory budget is exceeded the oldest entries get evicted first.
+*/
+class EditHistory
+{
+public:
+
+	void BeginEntry(const EditCoalesceKey& InCoalesceKey = EditCoalesceKey());
+	void EndEntry();
+	void SetCoalesceKey(const EditCoalesceKey& InCoalesceKey);
+	void RecordAction(const EditAction& InAction);
+
+	bool CanUndo();
+	bool CanRedo();
+
+	EditHistoryEntry TakeUndoEntry();
+	EditHistoryEntry TakeRedoEntry();
+
+	void PushUndoEntry(EditHistoryEntry&& InEntry);
+	void PushRedoEntry(EditHistoryEntry&& InEntry);
+
+	void Clear();
+	void SetMemoryBudget(const size_t InBytes);
+	size_t GetMemoryUsage();
+
+private:
+
+	void EnforceMemoryBudget();
+
+	std::deque<EditHistoryEntry> _UndoEntries;
+	std::deque<EditHistoryEntry> _RedoEntries;
+
+	bool _IsEntryOpen = false;
+
+	size_t _MemoryUsage = 0;
+	size_t _MemoryBudget = 64 * 1024 * 1024;
 };
 
 struct NoteReferenceCollection
 {
-	void PushNote(Column InColumn, Note* InNote);
+	void PushNote(Column InColumn, const Note& InNote);
 	void Clear();
 
 	void TrySetMinMaxTime(Time InTime);
 
-	std::unordered_map<Column, std::unordered_set<Note *>> Notes;
+	std::unordered_map<Column, std::unordered_set<NoteHandle, NoteHandleHash>> Notes;
 	std::unordered_map<Column, int> ColumnNoteCount;
 
 	Time MinTimePoint;
@@ -90,6 +400,42 @@ struct NoteReferenceCollection
 	int HighestColumnAmount = 0;
 };
 
+/*
+* a plain copy of everything a chart gets exported from, it shares nothing with the chart it was taken from.
+* taking one is a few vector copies, which makes it cheap enough to hand a chart over to a saving thread while editing goes on.
+*/
+struct ChartSnapshot
+{
+	std::string ArtistUnicode;
+	std::string Artist;
+	
+	std::string SongtitleUnicode;
+	std::string SongTitle;
+
+	std::string Charter;
+	std::string DifficultyName;
+
+	std::string Source;
+	std::string Tags;
+
+	std::string BeatmapID;
+	std::string BeatmapSetID;
+
+	std::filesystem::path AudioPath;
+	std::filesystem::path BackgroundPath;
+
+	int KeyAmount = 0;
+	bool HasScratchKey = false;
+
+	float HP = 0;
+	float OD = 0;
+
+	//all in time order
+	std::vector<BpmPoint> BpmPoints;
+	std::vector<ScrollVelocityMultiplier> ScrollVelocities;
+	std::vector<std::pair<Column, Note>> Notes;
+};
+
 struct Chart
 {
 public: //meta
@@ -115,25 +461,26 @@ public: //meta
 	std::filesystem::path BackgroundPath;
 
 	int KeyAmount = 0;
+	//only quaver has one, it is the last column and counted in the key amount
+	bool HasScratchKey = false;
 
 	float HP = 0;
 	float OD = 0;
 
-	std::vector<std::string> InheritedTimingPoints;
-
 public: //accessors
 
-	bool PlaceNote(const Time InTime, const Column InColumn, const int InBeatSnap = -1);
+	bool PlaceNote(const Time InTime, const Column InColumn, const int InBeatSnap = -1, const bool InSkipHistoryRegistering = false);
 	bool PlaceHold(const Time InTimeBegin, const Time InTimeEnd, const Column InColumn, const int InBeatSnapBegin = -1, const int InBeatSnapEnd = -1);
-	bool PlaceBpmPoint(const Time InTime, const double InBpm, const double InBeatLength);
+	bool PlaceBpmPoint(const Time InTime, const double InBpm, const double InBeatLength, const bool InSkipHistoryRegistering = false);
 
 	void BulkPlaceNotes(const std::vector<std::pair<Column, Note>>& InNotes, const bool InSkipHistoryRegistering = false, const bool InSkipOnModified = false);
+	void AdoptNoteColumn(const Column InColumn, const Note* InNotes, const size_t InNoteAmount);
 	void MirrorNotes(NoteReferenceCollection& OutNotes);
 	void MirrorNotes(std::vector<std::pair<Column, Note>>& OutNotes);
 
 	bool RemoveNote(const Time InTime, const Column InColumn, const bool InIgnoreHoldChecks = false, const bool InSkipHistoryRegistering = false, const bool InSkipOnModified = false);
 	bool RemoveBpmPoint(BpmPoint& InBpmPoint, const bool InSkipHistoryRegistering = false);
-	bool BulkRemoveNotes(NoteReferenceCollection& InNotes, const bool InSkipHistoryRegistering = false);
+	bool BulkRemoveNotes(NoteReferenceCollection& InNotes, const bool InSkipHistoryRegistering = false, const bool InSkipOnModified = false);
 
 	Note& InjectNote(const Time InTime, const Column InColumn, const Note::EType InNoteType, const Time InTimeBegin = -1, const Time InTimeEnd = -1, const int InBeatSnap = -1, const bool InSkipOnModified = false);
 	Note& InjectHold(const Time InTimeBegin, const Time InTimeEnd, const Column InColumn,  const int InBeatSnapBegin = -1, const int InBeatSnapEnd = -1, const bool InSkipOnModified = false);
@@ -141,43 +488,201 @@ public: //accessors
 
 	Note* MoveNote(const Time InTimeFrom, const Time InTimeTo, const Column InColumnFrom, const Column InColumnTo, const int InNewBeatSnap);
 	Note* FindNote(const Time InTime, const Column InColumn);
-	bool IsAPotentialNoteDuplicate(const Time InTime, const Column InColumn);
-	TimeSlice& FindOrAddTimeSlice(const Time InTime);
+	const Note* FindNote(const Time InTime, const Column InColumn) const;
+	Note* ResolveNote(const NoteHandle InHandle, Column* OutColumn = nullptr);
+	const Note* ResolveNote(const NoteHandle InHandle, Column* OutColumn = nullptr) const;
+	bool IsAPotentialNoteDuplicate(const Time InTime, const Column InColumn) const;
+
+	Time GetTimeSliceLength() const;
+	void SetTimeSliceLength(const Time InTimeSliceLength);
+	void AdaptTimeSliceLength();
 	
 	void FillNoteCollectionWithAllNotes(NoteReferenceCollection& OutNotes);
+	Time GetLastNoteTimePoint() const;
 
 	void RevaluateBpmPoint(BpmPoint& InFormerBpmPoint, BpmPoint& InMovedBpmPoint);
-	void PushTimeSliceHistoryIfNotAdded(const Time InTime);
-	void RegisterTimeSliceHistory(const Time InTime);
-	void RegisterTimeSliceHistoryRanged(const Time InTimeBegin, const Time InTimeEnd);
+	void RegisterBpmPointModification(const BpmPoint& InFormerBpmPoint, const BpmPoint& InModifiedBpmPoint);
+
+	void BeginEditHistoryEntry(const EditCoalesceKey& InCoalesceKey = EditCoalesceKey());
+	void SetEditHistoryCoalesceKey(const EditCoalesceKey& InCoalesceKey);
+	void SetEditHistoryMemoryBudget(const size_t InBytes);
 
 	bool Undo();
+	bool Redo();
+
+	void BeginTransaction();
+	void CommitTransaction();
 
-	void IterateTimeSlicesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::function<void(TimeSlice&)> InWork);
-	void IterateNotesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::function<void(Note&, const Column)> InWork);
+	//the read api never inserts anything, the visitors get inlined and the const overloads hand out const notes
+	template<typename TWork> void IterateNotesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork);
+	template<typename TWork> void IterateNotesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork) const;
+	template<typename TWork> void IterateHoldsInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork);
+	template<typename TWork> void IterateHoldsInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork) const;
 
-	void IterateAllNotes(std::function<void(Note&, const Column)> InWork);
-	void IterateAllBpmPoints(std::function<void(BpmPoint&)> InWork);
+	template<typename TWork> void IterateAllNotes(TWork&& InWork);
+	template<typename TWork> void IterateAllNotes(TWork&& InWork) const;
+	template<typename TWork> void IterateAllBpmPoints(TWork&& InWork) const;
+	size_t GetBpmPointAmount() const;
 
-	std::vector<BpmPoint*>& GetBpmPointsRelatedToTimeRange(const Time InTimeBegin, const Time InTimeEnd);
+	ChartSnapshot TakeSnapshot() const;
+
+	void GetBpmPointsRelatedToTimeRange(const Time InTimeBegin, const Time InTimeEnd, std::vector<BpmPoint*>& OutBpmPoints);
 	BpmPoint* GetPreviousBpmPointFromTimePoint(const Time InTime);
 	BpmPoint* GetNextBpmPointFromTimePoint(const Time InTime);
 
+	double GetBeatFromTimePoint(const Time InTime);
+	double GetTimePointFromBeat(const double InBeat);
+	void RefreshTempoMap();
+
+	//placing onto an existing point replaces its multiplier, the other osu fields carry over from the point in effect
+	bool PlaceScrollVelocity(const double InTime, const double InMultiplier, const bool InSkipHistoryRegistering = false);
+	bool RemoveScrollVelocity(const double InTime, const bool InSkipHistoryRegistering = false);
+
+	//takes over the points as they were parsed, outside of the history
+	void AdoptScrollVelocities(std::vector<ScrollVelocityMultiplier>&& InPoints);
+	const ScrollVelocityMap& GetScrollVelocityMap() const;
+
 	void DebugPrint();
-	void RegisterOnModifiedCallback(std::function<void(TimeSlice&)> InCallback);
+	void RegisterOnModifiedCallback(std::function<void(const Time, const Time)> InCallback);
+
+	//called for every change as it gets applied, including the ones done by undo and redo and the ones outside of the history
+	void RegisterOnEditActionCallback(std::function<void(const EditAction&)> InCallback);
+	void ReplayEditActions(const std::vector<EditAction>& InActions);
 
 public: //data ownership
 
-	std::map<int, TimeSlice> TimeSlices;
+	std::vector<NoteColumn> NoteColumns;
+
+private:
 
-	std::stack<std::vector<TimeSlice>> TimeSliceHistory;
+	NoteColumn& GetNoteColumn(const Column InColumn);
+	const NoteColumn* FindNoteColumn(const Column InColumn) const;
+	int GetTimeSliceIndex(const Time InTime) const;
 
-	std::vector<BpmPoint*> CachedBpmPoints;
+	struct NoteSlot
+	{
+		Column NoteColumn = 0;
+		size_t NoteIndex = 0;
+		uint32_t Generation = 0;
+		bool IsOccupied = false;
+	};
 
-private:
+	NoteHandle AllocateNoteHandle();
+	void ReleaseNoteHandle(const NoteHandle InHandle);
+	void ReindexNoteColumn(const Column InColumn, const size_t InFromIndex = 0);
+	void CollectHandlesWithHoldParts(NoteReferenceCollection& InNotes, std::unordered_set<NoteHandle, NoteHandleHash>& OutHandles);
 
-	std::function<void(TimeSlice&)> _OnModified;	
+	Note& InsertNote(const Column InColumn, const Note& InNote);
+	bool EraseNote(const Column InColumn, const Note& InNote);
+	BpmPoint* InsertBpmPoint(const BpmPoint& InBpmPoint);
+	bool EraseBpmPoint(const Time InTime);
+	void InjectScrollVelocity(const ScrollVelocityMultiplier& InPoint);
+	void EjectScrollVelocity(const ScrollVelocityMultiplier& InPoint);
 
-	int _BpmPointCounter = 0;
+	void MarkModified(const Time InTimeBegin, const Time InTimeEnd);
+
+	void MergeNotes(const Column InColumn, std::vector<Note>& InOutNotes);
+	void SweepNotes(const Column InColumn, const std::vector<Note>& InNotes);
+
+	void ApplyEditActions(const std::vector<EditAction>& InActions, const bool InIsUndo);
+	void ApplyEditAction(const EditAction& InAction, const bool InIsUndo);
+
+	void RecordEditAction(const EditAction& InAction);
+
+	std::function<void(const Time, const Time)> _OnModified;	
+	std::function<void(const EditAction&)> _OnEditAction;
+
+	int _TransactionDepth = 0;
+	bool _HasDirtyTimeRange = false;
+	Time _DirtyTimeBegin = 0;
+	Time _DirtyTimeEnd = 0;
+
+	EditHistory _EditHistory;
+
+	std::vector<NoteSlot> _NoteSlots;
+	std::vector<uint32_t> _FreeNoteSlots;
+
+	TempoMap _TempoMap;
 	bool _HasNegativePlacedBpmPoint = false;
-};
\ No newline at end of file
+
+	ScrollVelocityMap _ScrollVelocityMap;
+
+	Time _TimeSliceLength = TIMESLICE_LENGTH;
+};
+
+template<typename TWork>
+void Chart::IterateNotesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork)
+{
+	std::as_const(*this).IterateNotesInTimeRange(InTimeBegin, InTimeEnd, [&InWork](const Note& InNote, const Column InColumn) { InWork(const_cast<Note&>(InNote), InColumn); });
+}
+
+template<typename TWork>
+void Chart::IterateNotesInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork) const
+{
+	for (Column column = 0; column < NoteColumns.size(); ++column)
+	{
+		const auto &noteColumn = NoteColumns[column];
+
+		for (auto noteIt = noteColumn.LowerBound(InTimeBegin), noteEndIt = noteColumn.UpperBound(InTimeEnd); noteIt != noteEndIt; ++noteIt)
+			InWork(*noteIt, column);
+	}
+}
+
+template<typename TWork>
+void Chart::IterateHoldsInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork)
+{
+	std::as_const(*this).IterateHoldsInTimeRange(InTimeBegin, InTimeEnd, [&InWork](const Note& InNote, const Column InColumn) { InWork(const_cast<Note&>(InNote), InColumn); });
+}
+
+template<typename TWork>
+void Chart::IterateHoldsInTimeRange(const Time InTimeBegin, const Time InTimeEnd, TWork&& InWork) const
+{
+	for (Column column = 0; column < NoteColumns.size(); ++column)
+	{
+		const auto &noteColumn = NoteColumns[column];
+
+		noteColumn.Holds.IterateOverlapping(InTimeBegin, InTimeEnd, [&noteColumn, &InWork, column](const Hold& InHold)
+		{
+			if (const Note* holdBegin = noteColumn.FindHoldBegin(InHold.TimePointBegin, InHold.TimePointEnd))
+				InWork(*holdBegin, column);
+		});
+	}
+}
+
+template<typename TWork>
+void Chart::IterateAllNotes(TWork&& InWork)
+{
+	std::as_const(*this).IterateAllNotes([&InWork](const Note& InNote, const Column InColumn) { InWork(const_cast<Note&>(InNote), InColumn); });
+}
+
+template<typename TWork>
+void Chart::IterateAllNotes(TWork&& InWork) const
+{
+	//merges the columns on the fly, so the notes are visited in time order (the exporter relies on it)
+	std::vector<size_t> indices(NoteColumns.size(), 0);
+
+	while (true)
+	{
+		Column earliestColumn = NoteColumns.size();
+
+		for (Column column = 0; column < NoteColumns.size(); ++column)
+		{
+			if (indices[column] >= NoteColumns[column].Notes.size())
+				continue;
+
+			if (earliestColumn == NoteColumns.size() || NoteColumns[column].Notes[indices[column]].TimePoint < NoteColumns[earliestColumn].Notes[indices[earliestColumn]].TimePoint)
+				earliestColumn = column;
+		}
+
+		if (earliestColumn == NoteColumns.size())
+			return;
+
+		InWork(NoteColumns[earliestColumn].Notes[indices[earliestColumn]++], earliestColumn);
+	}
+}
+
+template<typename TWork>
+void Chart::IterateAllBpmPoints(TWork&& InWork) const
+{
+	_TempoMap.IterateAll(InWork);
+}
\ No newline at end of file
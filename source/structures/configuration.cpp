@@ -38,6 +38,18 @@ bool Configuration::Load()
 		UseAutoTiming = configFile["UseAutoTiming"].as<bool>();
 	if (configFile["ShowColumnHeatmap"])
 		ShowColumnHeatmap = configFile["ShowColumnHeatmap"].as<bool>();
+	if (configFile["PreviewScrollVelocities"])
+		PreviewScrollVelocities = configFile["PreviewScrollVelocities"].as<bool>();
+	if (configFile["ShowSpectrogram"])
+		ShowSpectrogram = configFile["ShowSpectrogram"].as<bool>();
+	if (configFile["SpectrogramWindowSize"])
+		SpectrogramWindowSize = configFile["SpectrogramWindowSize"].as<int>();
+	if (configFile["SpectrogramHopSize"])
+		SpectrogramHopSize = configFile["SpectrogramHopSize"].as<int>();
+	if (configFile["EditHistoryMemoryBudgetMegaBytes"])
+		EditHistoryMemoryBudgetMegaBytes = configFile["EditHistoryMemoryBudgetMegaBytes"].as<int>();
+	if (configFile["TimeSliceLength"])
+		TimeSliceLength = configFile["TimeSliceLength"].as<int>();
 
 	return true;
 }
@@ -61,6 +73,18 @@ void Configuration::Save()
 	out << YAML::Value << UseAutoTiming;
 	out << YAML::Key << "ShowColumnHeatmap";
 	out << YAML::Value << ShowColumnHeatmap;
+	out << YAML::Key << "PreviewScrollVelocities";
+	out << YAML::Value << PreviewScrollVelocities;
+	out << YAML::Key << "ShowSpectrogram";
+	out << YAML::Value << ShowSpectrogram;
+	out << YAML::Key << "SpectrogramWindowSize";
+	out << YAML::Value << SpectrogramWindowSize;
+	out << YAML::Key << "SpectrogramHopSize";
+	out << YAML::Value << SpectrogramHopSize;
+	out << YAML::Key << "EditHistoryMemoryBudgetMegaBytes";
+	out << YAML::Value << EditHistoryMemoryBudgetMegaBytes;
+	out << YAML::Key << "TimeSliceLength";
+	out << YAML::Value << TimeSliceLength;
 	out << YAML::EndMap;
 
 	std::ofstream configFile("config.yaml");
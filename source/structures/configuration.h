@@ -14,6 +14,18 @@ struct Configuration
 	bool ShowWaveform = true;
 	bool UseAutoTiming = false;
 	bool ShowColumnHeatmap = false;
+	bool PreviewScrollVelocities = false;
+	bool ShowSpectrogram = false;
+
+	//in samples, powers of two. a longer window separates frequencies finer and a shorter hop separates time finer
+	int SpectrogramWindowSize = 2048;
+	int SpectrogramHopSize = 256;
+
+	//undo history gets trimmed oldest first past this
+	int EditHistoryMemoryBudgetMegaBytes = 64;
+
+	//in ms, the granularity a modified range gets redone in. 0 shortens it for dense charts as they are opened
+	int TimeSliceLength = 0;
 
 	const int RecentFilePathsMaxSize = 10;
 	//FIFO, but needs to remove invalid paths on access (like if the files have moved)
@@ -17,7 +17,8 @@ struct Cursor
 	Time UnsnappedTimePoint = 0;
 	Column CursorColumn = 0;
 
-	std::vector<const Note*> HoveredNotes;
+	//sorted by time point, resolved through the chart since the notes they refer to may have been edited since
+	std::vector<NoteHandle> HoveredNotes;
 
 	int BeatSnap = -1;
 	int TimeFieldY = 0;
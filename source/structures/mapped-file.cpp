@@ -0,0 +1,128 @@
+#include "mapped-file.h"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path& InPath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileW(InPath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	_FileHandle = fileHandle;
+	_Size = size_t(fileSize.QuadPart);
+
+	//empty files can't be mapped, they are simply an empty view
+	if (_Size == 0)
+		return true;
+
+	HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (!mappingHandle)
+	{
+		Close();
+		return false;
+	}
+
+	_MappingHandle = mappingHandle;
+	_Data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+	if (!_Data)
+	{
+		Close();
+		return false;
+	}
+#else
+	const int fileDescriptor = open(InPath.c_str(), O_RDONLY);
+
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat fileStatus;
+
+	if (fstat(fileDescriptor, &fileStatus) != 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	_Size = size_t(fileStatus.st_size);
+
+	//empty files can't be mapped, they are simply an empty view
+	if (_Size == 0)
+	{
+		close(fileDescriptor);
+		return true;
+	}
+
+	void* data = mmap(nullptr, _Size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	//the mapping keeps the file referenced on its own
+	close(fileDescriptor);
+
+	if (data == MAP_FAILED)
+	{
+		_Size = 0;
+		return false;
+	}
+
+	madvise(data, _Size, MADV_SEQUENTIAL);
+
+	_Data = static_cast<const char*>(data);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (_Data)
+		UnmapViewOfFile(_Data);
+
+	if (_MappingHandle)
+		CloseHandle(_MappingHandle);
+
+	if (_FileHandle)
+		CloseHandle(_FileHandle);
+#else
+	if (_Data)
+		munmap(const_cast<char*>(_Data), _Size);
+#endif
+
+	_Data = nullptr;
+	_Size = 0;
+
+	_FileHandle = nullptr;
+	_MappingHandle = nullptr;
+}
+
+std::string_view MappedFile::GetView() const
+{
+	return _Data ? std::string_view(_Data, _Size) : std::string_view();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+/*
+* a read-only view of a whole file mapped into memory, so parsing doesn't have to copy it into strings first.
+* the view stays valid until the file gets closed, which also happens on destruction.
+*/
+struct MappedFile
+{
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::filesystem::path& InPath);
+	void Close();
+
+	std::string_view GetView() const;
+
+private:
+
+	const char* _Data = nullptr;
+	size_t _Size = 0;
+
+	void* _FileHandle = nullptr;
+	void* _MappingHandle = nullptr;
+};
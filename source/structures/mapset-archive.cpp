@@ -0,0 +1,304 @@
+#include "mapset-archive.h"
+
+#include "atomic-file.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+#include "../utilities/imgui/addons/imguifilesystem/minizip/unzip.h"
+#include "../utilities/imgui/addons/imguifilesystem/minizip/zip.h"
+
+#define ARCHIVE_EXTENSION ".osz"
+#define ARCHIVE_CHUNK_SIZE (64 * 1024)
+#define ARCHIVE_MAX_NAME_LENGTH 1024
+
+//minizip compares entry names the way windows compares file names, which is what the charts reference them by
+#define ARCHIVE_CASE_INSENSITIVE 2
+
+static bool HasExtension(const std::filesystem::path& InPath, const std::string_view InExtension)
+{
+	std::string extension = InPath.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char InCharacter) { return char(std::tolower(InCharacter)); });
+
+	return extension == InExtension;
+}
+
+//songs and images are compressed already, deflating them again only costs time
+static bool IsCompressedAlready(const std::filesystem::path& InPath)
+{
+	return HasExtension(InPath, ".mp3") || HasExtension(InPath, ".ogg") || HasExtension(InPath, ".jpg") || HasExtension(InPath, ".jpeg") || HasExtension(InPath, ".png");
+}
+
+bool SplitArchivePath(const std::filesystem::path& InPath, std::filesystem::path& OutArchivePath, std::string& OutEntryName)
+{
+	std::error_code errorCode;
+
+	for (std::filesystem::path archivePath = InPath.parent_path(); !archivePath.empty() && archivePath != archivePath.parent_path(); archivePath = archivePath.parent_path())
+	{
+		if (!HasExtension(archivePath, ARCHIVE_EXTENSION) || !std::filesystem::is_regular_file(archivePath, errorCode))
+			continue;
+
+		OutArchivePath = archivePath;
+		OutEntryName = InPath.lexically_relative(archivePath).generic_u8string();
+
+		return true;
+	}
+
+	return false;
+}
+
+bool ReadFileOrArchiveEntry(const std::filesystem::path& InPath, std::string& OutContent)
+{
+	std::filesystem::path archivePath;
+	std::string entryName;
+
+	if (SplitArchivePath(InPath, archivePath, entryName))
+	{
+		ArchiveReader archiveReader;
+		return archiveReader.Open(archivePath) && archiveReader.ReadEntry(entryName, OutContent);
+	}
+
+	std::ifstream file(InPath, std::ios::binary);
+
+	if (!file)
+		return false;
+
+	OutContent.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	return !file.bad();
+}
+
+ArchiveReader::~ArchiveReader()
+{
+	Close();
+}
+
+bool ArchiveReader::Open(const std::filesystem::path& InPath)
+{
+	Close();
+
+	_Handle = unzOpen64(InPath.u8string().c_str());
+
+	if (!_Handle)
+		return false;
+
+	char entryName[ARCHIVE_MAX_NAME_LENGTH];
+	unz_file_info64 entryInfo;
+
+	for (int result = unzGoToFirstFile(_Handle); result == UNZ_OK; result = unzGoToNextFile(_Handle))
+	{
+		if (unzGetCurrentFileInfo64(_Handle, &entryInfo, entryName, sizeof(entryName), nullptr, 0, nullptr, 0) != UNZ_OK)
+			break;
+
+		const size_t entryNameLength = std::strlen(entryName);
+
+		//folders are only implied by the names of the files in them
+		if (entryNameLength > 0 && entryName[entryNameLength - 1] != '/' && entryName[entryNameLength - 1] != '\\')
+			_EntryNames.emplace_back(entryName, entryNameLength);
+	}
+
+	return true;
+}
+
+void ArchiveReader::Close()
+{
+	if (_Handle)
+		unzClose(_Handle);
+
+	_Handle = nullptr;
+	_EntryNames.clear();
+}
+
+const std::vector<std::string>& ArchiveReader::GetEntryNames() const
+{
+	return _EntryNames;
+}
+
+bool ArchiveReader::ReadEntry(const std::string& InEntryName, std::string& OutContent)
+{
+	unz_file_info64 entryInfo;
+
+	if (!_Handle || unzLocateFile(_Handle, InEntryName.c_str(), ARCHIVE_CASE_INSENSITIVE) != UNZ_OK)
+		return false;
+
+	if (unzGetCurrentFileInfo64(_Handle, &entryInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK || unzOpenCurrentFile(_Handle) != UNZ_OK)
+		return false;
+
+	OutContent.resize(size_t(entryInfo.uncompressed_size));
+
+	size_t readBytes = 0;
+	int result = 0;
+
+	while (readBytes < OutContent.size() && (result = unzReadCurrentFile(_Handle, OutContent.data() + readBytes, unsigned(std::min<size_t>(OutContent.size() - readBytes, ARCHIVE_CHUNK_SIZE)))) > 0)
+		readBytes += size_t(result);
+
+	//closing checks the crc of everything that has been read
+	const bool hasSucceeded = unzCloseCurrentFile(_Handle) == UNZ_OK && result >= 0 && readBytes == OutContent.size();
+
+	if (!hasSucceeded)
+		OutContent.clear();
+
+	return hasSucceeded;
+}
+
+ArchiveWriter::~ArchiveWriter()
+{
+	//an archive that never got committed is left unfinished, it must not replace anything
+	if (_Handle)
+	{
+		zipClose(_Handle, nullptr);
+
+		std::error_code errorCode;
+		std::filesystem::remove(_TemporaryPath, errorCode);
+	}
+}
+
+bool ArchiveWriter::Open(const std::filesystem::path& InPath)
+{
+	_Path = InPath;
+	_TemporaryPath = InPath;
+	_TemporaryPath += ".tmp";
+
+	_Handle = zipOpen64(_TemporaryPath.u8string().c_str(), APPEND_STATUS_CREATE);
+
+	return _Handle != nullptr;
+}
+
+bool ArchiveWriter::Commit()
+{
+	if (!_Handle)
+		return false;
+
+	const bool hasClosed = zipClose(_Handle, nullptr) == ZIP_OK;
+	_Handle = nullptr;
+
+	if (!hasClosed)
+	{
+		std::error_code errorCode;
+		std::filesystem::remove(_TemporaryPath, errorCode);
+
+		return false;
+	}
+
+	return CommitFileAtomically(_TemporaryPath, _Path);
+}
+
+bool ArchiveWriter::OpenEntry(const std::string& InEntryName, const int InMethod)
+{
+	const std::time_t currentTime = std::time(nullptr);
+	const std::tm* localTime = std::localtime(&currentTime);
+
+	zip_fileinfo entryInfo = {};
+	entryInfo.tmz_date.tm_sec = localTime->tm_sec;
+	entryInfo.tmz_date.tm_min = localTime->tm_min;
+	entryInfo.tmz_date.tm_hour = localTime->tm_hour;
+	entryInfo.tmz_date.tm_mday = localTime->tm_mday;
+	entryInfo.tmz_date.tm_mon = localTime->tm_mon;
+	entryInfo.tmz_date.tm_year = localTime->tm_year + 1900;
+
+	return zipOpenNewFileInZip64(_Handle, InEntryName.c_str(), &entryInfo, nullptr, 0, nullptr, 0, nullptr, InMethod, Z_DEFAULT_COMPRESSION, 0) == ZIP_OK;
+}
+
+bool ArchiveWriter::AddEntry(const std::string& InEntryName, std::string_view InContent)
+{
+	if (!_Handle || !OpenEntry(InEntryName, Z_DEFLATED))
+		return false;
+
+	bool hasSucceeded = true;
+
+	while (hasSucceeded && !InContent.empty())
+	{
+		const size_t chunkSize = std::min<size_t>(InContent.size(), ARCHIVE_CHUNK_SIZE);
+
+		hasSucceeded = zipWriteInFileInZip(_Handle, InContent.data(), unsigned(chunkSize)) == ZIP_OK;
+		InContent.remove_prefix(chunkSize);
+	}
+
+	return zipCloseFileInZip(_Handle) == ZIP_OK && hasSucceeded;
+}
+
+bool ArchiveWriter::AddFile(const std::string& InEntryName, const std::filesystem::path& InFilePath)
+{
+	std::ifstream file(InFilePath, std::ios::binary);
+
+	if (!_Handle || !file || !OpenEntry(InEntryName, IsCompressedAlready(InFilePath) ? 0 : Z_DEFLATED))
+		return false;
+
+	char chunk[ARCHIVE_CHUNK_SIZE];
+	bool hasSucceeded = true;
+
+	while (hasSucceeded && file)
+	{
+		file.read(chunk, sizeof(chunk));
+
+		if (file.gcount() > 0)
+			hasSucceeded = zipWriteInFileInZip(_Handle, chunk, unsigned(file.gcount())) == ZIP_OK;
+	}
+
+	hasSucceeded = hasSucceeded && !file.bad();
+
+	return zipCloseFileInZip(_Handle) == ZIP_OK && hasSucceeded;
+}
+
+bool ArchiveWriter::CopyEntry(ArchiveReader& InReader, const std::string& InEntryName)
+{
+	unz_file_info64 entryInfo;
+	int method = 0;
+	int level = 0;
+
+	if (!_Handle || !InReader._Handle || unzLocateFile(InReader._Handle, InEntryName.c_str(), ARCHIVE_CASE_INSENSITIVE) != UNZ_OK)
+		return false;
+
+	if (unzGetCurrentFileInfo64(InReader._Handle, &entryInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK || unzOpenCurrentFile2(InReader._Handle, &method, &level, 1) != UNZ_OK)
+		return false;
+
+	zip_fileinfo copiedEntryInfo = {};
+	copiedEntryInfo.dosDate = entryInfo.dosDate;
+	copiedEntryInfo.internal_fa = entryInfo.internal_fa;
+	copiedEntryInfo.external_fa = entryInfo.external_fa;
+
+	if (zipOpenNewFileInZip2_64(_Handle, InEntryName.c_str(), &copiedEntryInfo, nullptr, 0, nullptr, 0, nullptr, method, level, 1, entryInfo.uncompressed_size >= 0xffffffff) != ZIP_OK)
+	{
+		unzCloseCurrentFile(InReader._Handle);
+		return false;
+	}
+
+	char chunk[ARCHIVE_CHUNK_SIZE];
+	bool hasSucceeded = true;
+	int readBytes = 0;
+
+	while (hasSucceeded && (readBytes = unzReadCurrentFile(InReader._Handle, chunk, sizeof(chunk))) > 0)
+		hasSucceeded = zipWriteInFileInZip(_Handle, chunk, unsigned(readBytes)) == ZIP_OK;
+
+	hasSucceeded = hasSucceeded && readBytes == 0;
+
+	unzCloseCurrentFile(InReader._Handle);
+
+	return zipCloseFileInZipRaw64(_Handle, entryInfo.uncompressed_size, entryInfo.crc) == ZIP_OK && hasSucceeded;
+}
+
+bool ReplaceArchiveEntry(const std::filesystem::path& InArchivePath, const std::string& InEntryName, std::string_view InContent)
+{
+	ArchiveReader archiveReader;
+	ArchiveWriter archiveWriter;
+
+	if (!archiveReader.Open(InArchivePath) || !archiveWriter.Open(InArchivePath))
+		return false;
+
+	for (const std::string& entryName : archiveReader.GetEntryNames())
+	{
+		if (entryName != InEntryName && !archiveWriter.CopyEntry(archiveReader, entryName))
+			return false;
+	}
+
+	if (!archiveWriter.AddEntry(InEntryName, InContent))
+		return false;
+
+	//windows can't rename over a file that is still open
+	archiveReader.Close();
+
+	return archiveWriter.Commit();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+* a mapset archive (.osz) is a zip of the chart files with their song and background.
+* a file inside of one is addressed as if the archive was a folder, "mapset.osz/chart.osu" is the entry chart.osu of mapset.osz.
+*/
+
+//true if the path points into an archive, the entry name is relative to the archive root
+bool SplitArchivePath(const std::filesystem::path& InPath, std::filesystem::path& OutArchivePath, std::string& OutEntryName);
+
+//reads a whole file, either from disk or inflated out of the archive it is in
+bool ReadFileOrArchiveEntry(const std::filesystem::path& InPath, std::string& OutContent);
+
+/*
+* reads single entries out of an archive without extracting the rest of it.
+* only the central directory gets read on opening, an entry gets inflated straight into the given buffer when it is asked for.
+*/
+struct ArchiveReader
+{
+	ArchiveReader() = default;
+	~ArchiveReader();
+
+	ArchiveReader(const ArchiveReader&) = delete;
+	ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+	bool Open(const std::filesystem::path& InPath);
+	void Close();
+
+	const std::vector<std::string>& GetEntryNames() const;
+	bool ReadEntry(const std::string& InEntryName, std::string& OutContent);
+
+private:
+
+	friend struct ArchiveWriter;
+
+	void* _Handle = nullptr;
+	std::vector<std::string> _EntryNames;
+};
+
+/*
+* writes an archive entry by entry, files get read and compressed in fixed size chunks so a large song never has to fit into memory.
+* everything goes into a temporary file next to the target, which only replaces the target once the archive is committed.
+*/
+struct ArchiveWriter
+{
+	ArchiveWriter() = default;
+	~ArchiveWriter();
+
+	ArchiveWriter(const ArchiveWriter&) = delete;
+	ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+	bool Open(const std::filesystem::path& InPath);
+	bool Commit();
+
+	bool AddEntry(const std::string& InEntryName, std::string_view InContent);
+	bool AddFile(const std::string& InEntryName, const std::filesystem::path& InFilePath);
+
+	//copies the entry over as it is compressed, without inflating and deflating it again
+	bool CopyEntry(ArchiveReader& InReader, const std::string& InEntryName);
+
+private:
+
+	bool OpenEntry(const std::string& InEntryName, const int InMethod);
+
+	void* _Handle = nullptr;
+
+	std::filesystem::path _Path;
+	std::filesystem::path _TemporaryPath;
+};
+
+//rewrites the archive with the entry replaced or added, every other entry is copied over still compressed
+bool ReplaceArchiveEntry(const std::filesystem::path& InArchivePath, const std::string& InEntryName, std::string_view InContent);
@@ -0,0 +1,293 @@
+#include "spectrogram-data.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#define SPECTROGRAM_MIN_WINDOW_SIZE 256
+#define SPECTROGRAM_MAX_WINDOW_SIZE 8192
+#define SPECTROGRAM_MIN_HOP_SIZE 64
+
+//in hz, the bands spread logarithmically in between
+#define SPECTROGRAM_LOWEST_FREQUENCY 30.0
+#define SPECTROGRAM_HIGHEST_FREQUENCY 16000.0
+
+//relative to a full scale sine, anything quieter is an intensity of 0
+#define SPECTROGRAM_FLOOR_DECIBELS -96.0f
+
+static int RoundDownToPowerOfTwo(const int InValue)
+{
+	int powerOfTwo = 1;
+
+	while (powerOfTwo * 2 <= InValue)
+		powerOfTwo *= 2;
+
+	return powerOfTwo;
+}
+
+//spelled out, the operator checks for infinities and nans on every product unless the whole build runs with fast math
+static std::complex<float> MultiplyComplex(const std::complex<float>& InFirst, const std::complex<float>& InSecond)
+{
+	return std::complex<float>(InFirst.real() * InSecond.real() - InFirst.imag() * InSecond.imag(), InFirst.real() * InSecond.imag() + InFirst.imag() * InSecond.real());
+}
+
+void SpectrogramData::Reset(const size_t InFrameAmount, const int InChannelAmount, const double InSampleRate, const int InWindowSize, const int InHopSize)
+{
+	Clear();
+
+	_ChannelAmount = InChannelAmount;
+	_SampleRate = InSampleRate;
+	_WindowSize = RoundDownToPowerOfTwo(std::clamp(InWindowSize, SPECTROGRAM_MIN_WINDOW_SIZE, SPECTROGRAM_MAX_WINDOW_SIZE));
+	_HopSize = RoundDownToPowerOfTwo(std::clamp(InHopSize, SPECTROGRAM_MIN_HOP_SIZE, _WindowSize));
+
+	if (InFrameAmount == 0 || InChannelAmount <= 0 || InSampleRate <= 0.0)
+		return;
+
+	_ColumnAmount = (InFrameAmount + _HopSize - 1) / _HopSize;
+	_Columns.resize(_ColumnAmount * SPECTROGRAM_BAND_AMOUNT);
+
+	const int halfSize = _WindowSize / 2;
+	const double tau = 6.283185307179586;
+
+	//a periodic hann window sums up to half its length, a full scale sine then peaks at a power of 1
+	_WindowFunction.resize(_WindowSize);
+
+	for (int sampleIndex = 0; sampleIndex < _WindowSize; ++sampleIndex)
+		_WindowFunction[sampleIndex] = float(0.5 - 0.5 * std::cos(tau * sampleIndex / _WindowSize));
+
+	_PowerScale = 16.0f / (float(_WindowSize) * float(_WindowSize));
+
+	int bitAmount = 0;
+	while ((1 << bitAmount) < halfSize)
+		++bitAmount;
+
+	_BitReversal.resize(halfSize);
+
+	for (int index = 0; index < halfSize; ++index)
+	{
+		uint32_t reversed = 0;
+
+		for (int bit = 0; bit < bitAmount; ++bit)
+			reversed |= uint32_t((index >> bit) & 1) << (bitAmount - 1 - bit);
+
+		_BitReversal[index] = reversed;
+	}
+
+	_FftTwiddles.resize(halfSize / 2);
+
+	for (int index = 0; index < halfSize / 2; ++index)
+		_FftTwiddles[index] = std::polar(1.0f, float(-tau * index / halfSize));
+
+	_SplitTwiddles.resize(halfSize);
+
+	for (int index = 0; index < halfSize; ++index)
+		_SplitTwiddles[index] = std::polar(1.0f, float(-tau * index / _WindowSize));
+
+	_Spectrum.resize(halfSize);
+	_BinPowers.resize(halfSize);
+
+	const double binFrequency = _SampleRate / double(_WindowSize);
+	const double highestFrequency = std::min(SPECTROGRAM_HIGHEST_FREQUENCY, _SampleRate * 0.5);
+	const double frequencyRatio = std::max(highestFrequency / SPECTROGRAM_LOWEST_FREQUENCY, 1.0);
+
+	//bands narrower than a bin at the low end share that bin, the dc offset is left out
+	_BandRanges.resize(SPECTROGRAM_BAND_AMOUNT);
+
+	for (int band = 0; band < SPECTROGRAM_BAND_AMOUNT; ++band)
+	{
+		const double lowFrequency = SPECTROGRAM_LOWEST_FREQUENCY * std::pow(frequencyRatio, double(band) / SPECTROGRAM_BAND_AMOUNT);
+		const double highFrequency = SPECTROGRAM_LOWEST_FREQUENCY * std::pow(frequencyRatio, double(band + 1) / SPECTROGRAM_BAND_AMOUNT);
+
+		BandRange& range = _BandRanges[band];
+		range.FirstBin = std::clamp(int(lowFrequency / binFrequency + 0.5), 1, halfSize - 1);
+		range.EndBin = std::clamp(int(highFrequency / binFrequency + 0.5), range.FirstBin + 1, halfSize);
+	}
+
+	//the first window starts before the song, so every column is centered on the middle of its hop
+	_WindowSamples.assign(_WindowSize, 0.0f);
+	_WindowSampleAmount = (_WindowSize - _HopSize) / 2;
+}
+
+void SpectrogramData::Clear()
+{
+	_Columns.clear();
+	_Columns.shrink_to_fit();
+	_ColumnAmount = 0;
+	_DoneColumnAmount.store(0);
+
+	_WindowSamples.clear();
+	_WindowSampleAmount = 0;
+}
+
+void SpectrogramData::AppendFrames(const float* InSamples, const size_t InFrameAmount)
+{
+	if (_ColumnAmount == 0)
+		return;
+
+	if (_ChannelAmount == 1)
+	{
+		AppendMonoSamples(InSamples, InFrameAmount);
+		return;
+	}
+
+	_MonoSamples.resize(InFrameAmount);
+
+	if (_ChannelAmount == 2)
+	{
+		_Kernels->DownmixStereo(InSamples, InFrameAmount, _MonoSamples.data());
+	}
+	else
+	{
+		for (size_t frameIndex = 0; frameIndex < InFrameAmount; ++frameIndex)
+		{
+			float sum = 0.0f;
+
+			for (int channel = 0; channel < _ChannelAmount; ++channel)
+				sum += InSamples[frameIndex * _ChannelAmount + channel];
+
+			_MonoSamples[frameIndex] = sum / float(_ChannelAmount);
+		}
+	}
+
+	AppendMonoSamples(_MonoSamples.data(), InFrameAmount);
+}
+
+void SpectrogramData::Finish()
+{
+	//the windows of the last columns reach past the end of the song
+	while (_DoneColumnAmount.load(std::memory_order_relaxed) < _ColumnAmount)
+	{
+		std::fill(_WindowSamples.begin() + _WindowSampleAmount, _WindowSamples.end(), 0.0f);
+		_WindowSampleAmount = _WindowSize;
+
+		ComputeColumn();
+	}
+}
+
+int SpectrogramData::GetWindowSize() const
+{
+	return _WindowSize;
+}
+
+int SpectrogramData::GetHopSize() const
+{
+	return _HopSize;
+}
+
+double SpectrogramData::GetColumnDuration() const
+{
+	return double(_HopSize) / _SampleRate * 1000.0;
+}
+
+size_t SpectrogramData::GetColumnAmount() const
+{
+	return _ColumnAmount;
+}
+
+size_t SpectrogramData::GetDoneColumnAmount() const
+{
+	//pairs with the release in ComputeColumn, every column below the amount is completely written
+	return _DoneColumnAmount.load(std::memory_order_acquire);
+}
+
+const uint8_t* SpectrogramData::GetColumn(const size_t InColumnIndex) const
+{
+	return _Columns.data() + InColumnIndex * SPECTROGRAM_BAND_AMOUNT;
+}
+
+void SpectrogramData::AppendMonoSamples(const float* InSamples, const size_t InSampleAmount)
+{
+	for (size_t sampleIndex = 0; sampleIndex < InSampleAmount && _DoneColumnAmount.load(std::memory_order_relaxed) < _ColumnAmount;)
+	{
+		const size_t sampleAmount = std::min(InSampleAmount - sampleIndex, size_t(_WindowSize) - _WindowSampleAmount);
+
+		std::memcpy(_WindowSamples.data() + _WindowSampleAmount, InSamples + sampleIndex, sampleAmount * sizeof(float));
+		_WindowSampleAmount += sampleAmount;
+		sampleIndex += sampleAmount;
+
+		if (_WindowSampleAmount == size_t(_WindowSize))
+			ComputeColumn();
+	}
+}
+
+void SpectrogramData::ComputeColumn()
+{
+	//only the appending thread ever writes the amount
+	const size_t columnIndex = _DoneColumnAmount.load(std::memory_order_relaxed);
+	const int halfSize = _WindowSize / 2;
+
+	for (int index = 0; index < halfSize; ++index)
+	{
+		const float evenSample = _WindowSamples[2 * index] * _WindowFunction[2 * index];
+		const float oddSample = _WindowSamples[2 * index + 1] * _WindowFunction[2 * index + 1];
+
+		_Spectrum[_BitReversal[index]] = std::complex<float>(evenSample, oddSample);
+	}
+
+	TransformSpectrum();
+
+	//the even samples went in as the real part and the odd ones as the imaginary part, their spectra are the symmetric and antisymmetric halves
+	for (int bin = 0; bin < halfSize; ++bin)
+	{
+		const std::complex<float> mirrored = std::conj(_Spectrum[(halfSize - bin) & (halfSize - 1)]);
+
+		const std::complex<float> evenSpectrum = (_Spectrum[bin] + mirrored) * 0.5f;
+		const std::complex<float> difference = _Spectrum[bin] - mirrored;
+		const std::complex<float> oddSpectrum(difference.imag() * 0.5f, -difference.real() * 0.5f);
+
+		_BinPowers[bin] = std::norm(evenSpectrum + MultiplyComplex(_SplitTwiddles[bin], oddSpectrum)) * _PowerScale;
+	}
+
+	uint8_t* const column = _Columns.data() + columnIndex * SPECTROGRAM_BAND_AMOUNT;
+
+	for (int band = 0; band < SPECTROGRAM_BAND_AMOUNT; ++band)
+	{
+		const BandRange& range = _BandRanges[band];
+		const float power = *std::max_element(_BinPowers.begin() + range.FirstBin, _BinPowers.begin() + range.EndBin);
+
+		const float decibels = 10.0f * std::log10(std::max(power, 1e-20f));
+		const float intensity = std::clamp(1.0f - decibels / SPECTROGRAM_FLOOR_DECIBELS, 0.0f, 1.0f);
+
+		column[band] = uint8_t(std::lround(intensity * 255.0f));
+	}
+
+	//the next window overlaps this one by everything but a hop
+	std::memmove(_WindowSamples.data(), _WindowSamples.data() + _HopSize, (_WindowSize - _HopSize) * sizeof(float));
+	_WindowSampleAmount -= _HopSize;
+
+	_DoneColumnAmount.store(columnIndex + 1, std::memory_order_release);
+}
+
+void SpectrogramData::TransformSpectrum()
+{
+	//iterative radix 2, the input already sits in bit reversed order. runs on the interleaved floats, a complex array is laid out as one
+	const size_t size = _Spectrum.size();
+	float* const values = reinterpret_cast<float*>(_Spectrum.data());
+	const float* const twiddles = reinterpret_cast<const float*>(_FftTwiddles.data());
+
+	for (size_t length = 2; length <= size; length *= 2)
+	{
+		const size_t halfLength = length / 2;
+		const size_t twiddleStep = size / length;
+
+		for (size_t start = 0; start < size; start += length)
+		{
+			float* const evens = values + 2 * start;
+			float* const odds = values + 2 * (start + halfLength);
+
+			for (size_t index = 0; index < halfLength; ++index)
+			{
+				const float twiddleReal = twiddles[2 * index * twiddleStep];
+				const float twiddleImaginary = twiddles[2 * index * twiddleStep + 1];
+
+				const float oddReal = odds[2 * index] * twiddleReal - odds[2 * index + 1] * twiddleImaginary;
+				const float oddImaginary = odds[2 * index] * twiddleImaginary + odds[2 * index + 1] * twiddleReal;
+
+				odds[2 * index] = evens[2 * index] - oddReal;
+				odds[2 * index + 1] = evens[2 * index + 1] - oddImaginary;
+				evens[2 * index] += oddReal;
+				evens[2 * index + 1] += oddImaginary;
+			}
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "audio-kernels.h"
+
+//frequency bands of every column, spaced logarithmically so the low end where kicks and snares sit isn't squeezed into a few pixels
+#define SPECTROGRAM_BAND_AMOUNT 128
+
+/*
+* the short time fourier transform of a whole song, one column of band intensities per hop.
+* every column covers the hop it starts on, its window is centered on the middle of that hop and reaches into the hops around it.
+* the intensities are quantized from decibels to a byte, so a column is as large as the amount of bands.
+*
+* the columns get filled in while the song is still being decoded. one thread appends samples, any other thread can already read the columns that are done.
+*/
+class SpectrogramData
+{
+public:
+
+	//the window and hop get rounded down to powers of two, the hop is never longer than the window
+	void Reset(const size_t InFrameAmount, const int InChannelAmount, const double InSampleRate, const int InWindowSize, const int InHopSize);
+	void Clear();
+
+	//takes interleaved float samples, all channels get mixed down into one
+	void AppendFrames(const float* InSamples, const size_t InFrameAmount);
+	void Finish();
+
+	int GetWindowSize() const;
+	int GetHopSize() const;
+
+	//in ms
+	double GetColumnDuration() const;
+
+	//the amount of columns of the whole song and the ones that are done, the rest is still being decoded
+	size_t GetColumnAmount() const;
+	size_t GetDoneColumnAmount() const;
+
+	//SPECTROGRAM_BAND_AMOUNT intensities between 0 and 255, the lowest band first
+	const uint8_t* GetColumn(const size_t InColumnIndex) const;
+
+private:
+
+	struct BandRange
+	{
+		int FirstBin = 0;
+		int EndBin = 0;
+	};
+
+	void AppendMonoSamples(const float* InSamples, const size_t InSampleAmount);
+	void ComputeColumn();
+	void TransformSpectrum();
+
+	std::vector<uint8_t> _Columns;
+	size_t _ColumnAmount = 0;
+	std::atomic<size_t> _DoneColumnAmount = 0;
+
+	//the samples of the next window, it is complete once it holds as many as the window is long
+	std::vector<float> _WindowSamples;
+	size_t _WindowSampleAmount = 0;
+
+	std::vector<float> _MonoSamples;
+
+	//a real window of n samples is transformed as a complex one of n / 2, the split twiddles pull the two halves apart again
+	std::vector<float> _WindowFunction;
+	std::vector<std::complex<float>> _Spectrum;
+	std::vector<std::complex<float>> _FftTwiddles;
+	std::vector<std::complex<float>> _SplitTwiddles;
+	std::vector<uint32_t> _BitReversal;
+	std::vector<float> _BinPowers;
+
+	std::vector<BandRange> _BandRanges;
+	float _PowerScale = 1.0f;
+
+	const AudioKernels* _Kernels = &GetAudioKernels();
+
+	int _ChannelAmount = 2;
+	double _SampleRate = 44100.0;
+	int _WindowSize = 1024;
+	int _HopSize = 256;
+};
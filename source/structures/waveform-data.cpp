@@ -0,0 +1,351 @@
+#include "waveform-data.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "atomic-file.h"
+#include "binary-io.h"
+
+//sample frames per bucket of the finest level, below a millisecond for any common sample rate
+#define WAVEFORM_BUCKET_FRAME_AMOUNT 32
+
+#define WAVEFORM_CACHE_MAGIC "LRW1"
+#define WAVEFORM_CACHE_VERSION 1
+#define WAVEFORM_MAX_LEVEL_AMOUNT 64
+
+/*
+* layout: the header, the offset of every level and then the buckets of all levels as one raw array.
+* the offsets keep the buckets two byte aligned, so they get drawn straight out of the mapped file.
+*/
+struct WaveFormCacheHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint32_t BucketSize;
+	uint32_t LevelAmount;
+	uint64_t BucketAmount;
+	double SampleRate;
+
+	uint64_t SourceSize;
+	uint64_t SourceHash;
+};
+
+static int16_t QuantizePeak(const float InValue)
+{
+	return int16_t(std::lround(std::clamp(InValue, -1.0f, 1.0f) * WAVEFORM_PEAK_SCALE));
+}
+
+static float DequantizePeak(const int16_t InValue)
+{
+	return float(InValue) / WAVEFORM_PEAK_SCALE;
+}
+
+static WaveFormPeak MergePeaks(const WaveFormPeak& InFirst, const WaveFormPeak& InSecond)
+{
+	const float firstRms = DequantizePeak(InFirst.Rms);
+	const float secondRms = DequantizePeak(InSecond.Rms);
+
+	WaveFormPeak peak;
+	peak.Min = std::min(InFirst.Min, InSecond.Min);
+	peak.Max = std::max(InFirst.Max, InSecond.Max);
+	peak.Rms = QuantizePeak(std::sqrt((firstRms * firstRms + secondRms * secondRms) * 0.5f));
+
+	return peak;
+}
+
+void WaveFormData::Reset(const size_t InFrameAmount, const int InChannelAmount, const double InSampleRate)
+{
+	Clear();
+
+	_ChannelAmount = InChannelAmount;
+	_SampleRate = InSampleRate;
+
+	if (InFrameAmount == 0 || InChannelAmount <= 0 || InSampleRate <= 0.0)
+		return;
+
+	size_t bucketAmount = (InFrameAmount + WAVEFORM_BUCKET_FRAME_AMOUNT - 1) / WAVEFORM_BUCKET_FRAME_AMOUNT;
+	size_t totalBucketAmount = bucketAmount;
+
+	_LevelOffsets.push_back(0);
+
+	while (bucketAmount > 1)
+	{
+		_LevelOffsets.push_back(totalBucketAmount);
+
+		bucketAmount = (bucketAmount + 1) / 2;
+		totalBucketAmount += bucketAmount;
+	}
+
+	_Buckets.resize(totalBucketAmount);
+	_BucketData = _Buckets.data();
+	_BucketAmount = _Buckets.size();
+
+	_DoneBucketAmounts = std::make_unique<std::atomic<size_t>[]>(_LevelOffsets.size());
+
+	for (int level = 0; level < GetLevelAmount(); ++level)
+		_DoneBucketAmounts[level].store(0);
+}
+
+void WaveFormData::Clear()
+{
+	_Buckets.clear();
+	_Buckets.shrink_to_fit();
+	_BucketData = nullptr;
+	_BucketAmount = 0;
+
+	_LevelOffsets.clear();
+	_DoneBucketAmounts.reset();
+
+	_CacheFile.Close();
+
+	_PendingBucket.FrameAmount = 0;
+}
+
+void WaveFormData::AppendFrames(const float* InSamples, const size_t InFrameAmount)
+{
+	if (GetLevelAmount() == 0)
+		return;
+
+	for (size_t frameIndex = 0; frameIndex < InFrameAmount;)
+	{
+		const size_t frameAmount = std::min(InFrameAmount - frameIndex, WAVEFORM_BUCKET_FRAME_AMOUNT - _PendingBucket.FrameAmount);
+
+		ReduceIntoPendingBucket(InSamples + frameIndex * _ChannelAmount, frameAmount);
+		frameIndex += frameAmount;
+
+		if (_PendingBucket.FrameAmount == WAVEFORM_BUCKET_FRAME_AMOUNT)
+			FlushPendingBucket();
+	}
+
+	MergeLevels(false);
+}
+
+void WaveFormData::Finish()
+{
+	if (GetLevelAmount() == 0)
+		return;
+
+	if (_PendingBucket.FrameAmount > 0)
+		FlushPendingBucket();
+
+	MergeLevels(true);
+}
+
+int WaveFormData::GetLevelAmount() const
+{
+	return int(_LevelOffsets.size());
+}
+
+int WaveFormData::GetLevelForDuration(const double InMilliSeconds) const
+{
+	//the finest level with buckets at least as long as asked for, anything shorter would need several buckets for one pixel
+	for (int level = 0; level < GetLevelAmount(); ++level)
+	{
+		if (GetBucketDuration(level) >= InMilliSeconds)
+			return level;
+	}
+
+	return GetLevelAmount() - 1;
+}
+
+double WaveFormData::GetBucketDuration(const int InLevel) const
+{
+	return std::ldexp(double(WAVEFORM_BUCKET_FRAME_AMOUNT), InLevel) / _SampleRate * 1000.0;
+}
+
+size_t WaveFormData::GetBucketAmount(const int InLevel) const
+{
+	if (InLevel < 0 || InLevel >= GetLevelAmount())
+		return 0;
+
+	return _DoneBucketAmounts[InLevel].load(std::memory_order_acquire);
+}
+
+const WaveFormBucket* WaveFormData::GetBuckets(const int InLevel) const
+{
+	if (InLevel < 0 || InLevel >= GetLevelAmount())
+		return nullptr;
+
+	return _BucketData + _LevelOffsets[InLevel];
+}
+
+bool WaveFormData::StoreCache(const std::filesystem::path& InPath, const uint64_t InSourceHash, const uint64_t InSourceSize) const
+{
+	if (GetLevelAmount() == 0)
+		return false;
+
+	WaveFormCacheHeader header;
+	std::memcpy(header.Magic, WAVEFORM_CACHE_MAGIC, sizeof(header.Magic));
+	header.Version = WAVEFORM_CACHE_VERSION;
+	header.BucketSize = sizeof(WaveFormBucket);
+	header.LevelAmount = uint32_t(GetLevelAmount());
+	header.BucketAmount = _BucketAmount;
+	header.SampleRate = _SampleRate;
+	header.SourceSize = InSourceSize;
+	header.SourceHash = InSourceHash;
+
+	std::string buffer;
+	buffer.reserve(sizeof(header) + _LevelOffsets.size() * sizeof(uint64_t) + _BucketAmount * sizeof(WaveFormBucket));
+
+	WriteBinaryValue(buffer, header);
+
+	for (const size_t levelOffset : _LevelOffsets)
+		WriteBinaryValue(buffer, uint64_t(levelOffset));
+
+	buffer.append(reinterpret_cast<const char*>(_BucketData), _BucketAmount * sizeof(WaveFormBucket));
+
+	return WriteFileAtomically(InPath, buffer);
+}
+
+bool WaveFormData::LoadCache(const std::filesystem::path& InPath, const uint64_t InSourceHash, const uint64_t InSourceSize)
+{
+	Clear();
+
+	if (!_CacheFile.Open(InPath))
+		return false;
+
+	std::string_view content = _CacheFile.GetView();
+
+	WaveFormCacheHeader header;
+
+	//a cache of another song, an older version or a broken file is no cache at all, the song simply gets decoded again
+	const bool isValid = ReadBinaryValue(content, header)
+		&& std::memcmp(header.Magic, WAVEFORM_CACHE_MAGIC, sizeof(header.Magic)) == 0
+		&& header.Version == WAVEFORM_CACHE_VERSION
+		&& header.BucketSize == sizeof(WaveFormBucket)
+		&& header.SourceHash == InSourceHash
+		&& header.SourceSize == InSourceSize
+		&& header.LevelAmount > 0 && header.LevelAmount <= WAVEFORM_MAX_LEVEL_AMOUNT
+		&& header.SampleRate > 0.0
+		&& content.size() >= header.LevelAmount * sizeof(uint64_t)
+		&& (content.size() - header.LevelAmount * sizeof(uint64_t)) / sizeof(WaveFormBucket) >= header.BucketAmount;
+
+	if (!isValid)
+	{
+		Clear();
+		return false;
+	}
+
+	_LevelOffsets.resize(header.LevelAmount);
+
+	for (size_t& levelOffset : _LevelOffsets)
+	{
+		uint64_t offset = 0;
+		ReadBinaryValue(content, offset);
+
+		levelOffset = size_t(offset);
+	}
+
+	_BucketData = reinterpret_cast<const WaveFormBucket*>(content.data());
+	_BucketAmount = size_t(header.BucketAmount);
+	_SampleRate = header.SampleRate;
+
+	//every level has to halve the one below it, anything else would read past the buckets
+	bool hasValidLevels = _LevelOffsets[0] == 0 && GetLevelCapacity(GetLevelAmount() - 1) == 1;
+
+	for (int level = 0; hasValidLevels && level + 1 < GetLevelAmount(); ++level)
+		hasValidLevels = _LevelOffsets[level + 1] > _LevelOffsets[level] && _LevelOffsets[level + 1] < _BucketAmount && GetLevelCapacity(level + 1) == (GetLevelCapacity(level) + 1) / 2;
+
+	if (!hasValidLevels)
+	{
+		Clear();
+		return false;
+	}
+
+	_DoneBucketAmounts = std::make_unique<std::atomic<size_t>[]>(_LevelOffsets.size());
+
+	for (int level = 0; level < GetLevelAmount(); ++level)
+		_DoneBucketAmounts[level].store(GetLevelCapacity(level));
+
+	return true;
+}
+
+void WaveFormData::ReduceIntoPendingBucket(const float* InSamples, const size_t InFrameAmount)
+{
+	PendingBucket& bucket = _PendingBucket;
+
+	if (bucket.FrameAmount == 0)
+	{
+		bucket.Left = ChannelPeaks();
+		bucket.Right = ChannelPeaks();
+	}
+
+	if (_ChannelAmount == 2)
+	{
+		_Kernels->ReduceStereo(InSamples, InFrameAmount, bucket.Left, bucket.Right);
+	}
+	else if (_ChannelAmount == 1)
+	{
+		_Kernels->ReduceChannel(InSamples, InFrameAmount, bucket.Left);
+		bucket.Right = bucket.Left;
+	}
+	else
+	{
+		//anything past stereo only shows its first two channels, frame by frame
+		for (size_t frameIndex = 0; frameIndex < InFrameAmount; ++frameIndex)
+			_Kernels->ReduceStereo(InSamples + frameIndex * _ChannelAmount, 1, bucket.Left, bucket.Right);
+	}
+
+	bucket.FrameAmount += InFrameAmount;
+}
+
+void WaveFormData::FlushPendingBucket()
+{
+	const PendingBucket& pendingBucket = _PendingBucket;
+	const size_t bucketIndex = _DoneBucketAmounts[0].load(std::memory_order_relaxed);
+
+	//a decoder can hand out a little more than the length it reported, that tail has no bucket to go into
+	if (bucketIndex < GetLevelCapacity(0))
+	{
+		const double frameAmount = double(pendingBucket.FrameAmount);
+
+		WaveFormBucket& bucket = _Buckets[bucketIndex];
+		bucket.Left.Min = QuantizePeak(pendingBucket.Left.Min);
+		bucket.Left.Max = QuantizePeak(pendingBucket.Left.Max);
+		bucket.Left.Rms = QuantizePeak(float(std::sqrt(pendingBucket.Left.SquareSum / frameAmount)));
+		bucket.Right.Min = QuantizePeak(pendingBucket.Right.Min);
+		bucket.Right.Max = QuantizePeak(pendingBucket.Right.Max);
+		bucket.Right.Rms = QuantizePeak(float(std::sqrt(pendingBucket.Right.SquareSum / frameAmount)));
+
+		_DoneBucketAmounts[0].store(bucketIndex + 1, std::memory_order_release);
+	}
+
+	_PendingBucket.FrameAmount = 0;
+}
+
+void WaveFormData::MergeLevels(const bool InIsFinished)
+{
+	for (int level = 0; level + 1 < GetLevelAmount(); ++level)
+	{
+		const WaveFormBucket* const lowerBuckets = _Buckets.data() + _LevelOffsets[level];
+		WaveFormBucket* const upperBuckets = _Buckets.data() + _LevelOffsets[level + 1];
+
+		const size_t lowerBucketAmount = _DoneBucketAmounts[level].load(std::memory_order_relaxed);
+		size_t upperBucketAmount = _DoneBucketAmounts[level + 1].load(std::memory_order_relaxed);
+
+		//an odd bucket at the end of a level waits for its partner, unless the song is over and it gets carried up on its own
+		const size_t mergeableBucketAmount = InIsFinished ? (lowerBucketAmount + 1) / 2 : lowerBucketAmount / 2;
+
+		for (; upperBucketAmount < mergeableBucketAmount; ++upperBucketAmount)
+		{
+			const size_t lowerBucketIndex = upperBucketAmount * 2;
+
+			const WaveFormBucket& first = lowerBuckets[lowerBucketIndex];
+			const WaveFormBucket& second = lowerBucketIndex + 1 < lowerBucketAmount ? lowerBuckets[lowerBucketIndex + 1] : first;
+
+			upperBuckets[upperBucketAmount].Left = MergePeaks(first.Left, second.Left);
+			upperBuckets[upperBucketAmount].Right = MergePeaks(first.Right, second.Right);
+		}
+
+		_DoneBucketAmounts[level + 1].store(upperBucketAmount, std::memory_order_release);
+	}
+}
+
+size_t WaveFormData::GetLevelCapacity(const int InLevel) const
+{
+	const size_t levelEnd = InLevel + 1 < GetLevelAmount() ? _LevelOffsets[InLevel + 1] : _BucketAmount;
+
+	return levelEnd - _LevelOffsets[InLevel];
+}
@@ -1,7 +1,92 @@
 #pragma once
 
-struct WaveFormData
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "audio-kernels.h"
+#include "mapped-file.h"
+
+//a peak of 1 in the float samples
+#define WAVEFORM_PEAK_SCALE 32767.0f
+
+//the peaks of one channel over a bucket of samples, scaled from [-1, 1] up to the range of an int16 to keep the pyramid small
+struct WaveFormPeak
 {
-		float Right = 0;
-		float Left = 0;
-};
\ No newline at end of file
+	int16_t Min = 0;
+	int16_t Max = 0;
+	int16_t Rms = 0;
+};
+
+struct WaveFormBucket
+{
+	WaveFormPeak Left;
+	WaveFormPeak Right;
+};
+
+/*
+* the waveform of a whole song as a pyramid of min/max/rms peaks.
+* the finest level reduces a fixed amount of sample frames into each bucket, every level above merges two buckets of the one below.
+* drawing picks the level whose buckets are about as long as a pixel, so the amount of drawn buckets is bound by the screen and not by the song length.
+*
+* the pyramid gets filled in while the song is still being decoded. one thread appends samples, any other thread can already draw the buckets that are done.
+*/
+class WaveFormData
+{
+public:
+
+	//sizes every level for the length of the song up front, the buckets never move while they get filled in
+	void Reset(const size_t InFrameAmount, const int InChannelAmount, const double InSampleRate);
+	void Clear();
+
+	//takes interleaved float samples, a mono song fills both channels
+	void AppendFrames(const float* InSamples, const size_t InFrameAmount);
+	void Finish();
+
+	int GetLevelAmount() const;
+	int GetLevelForDuration(const double InMilliSeconds) const;
+	double GetBucketDuration(const int InLevel) const;
+
+	//only the buckets that are done, the rest of the level is still being decoded
+	size_t GetBucketAmount(const int InLevel) const;
+	const WaveFormBucket* GetBuckets(const int InLevel) const;
+
+	//a finished pyramid gets written out as it is and mapped back in later, the source hash and size tell which song it belongs to
+	bool StoreCache(const std::filesystem::path& InPath, const uint64_t InSourceHash, const uint64_t InSourceSize) const;
+	bool LoadCache(const std::filesystem::path& InPath, const uint64_t InSourceHash, const uint64_t InSourceSize);
+
+private:
+
+	struct PendingBucket
+	{
+		ChannelPeaks Left;
+		ChannelPeaks Right;
+
+		size_t FrameAmount = 0;
+	};
+
+	void ReduceIntoPendingBucket(const float* InSamples, const size_t InFrameAmount);
+	void FlushPendingBucket();
+	void MergeLevels(const bool InIsFinished);
+
+	size_t GetLevelCapacity(const int InLevel) const;
+
+	//all levels back to back, the finest one first. either decoded into memory or used straight out of a mapped cache file
+	std::vector<WaveFormBucket> _Buckets;
+	const WaveFormBucket* _BucketData = nullptr;
+	size_t _BucketAmount = 0;
+
+	std::vector<size_t> _LevelOffsets;
+	std::unique_ptr<std::atomic<size_t>[]> _DoneBucketAmounts;
+
+	MappedFile _CacheFile;
+
+	PendingBucket _PendingBucket;
+	const AudioKernels* _Kernels = &GetAudioKernels();
+
+	int _ChannelAmount = 2;
+	double _SampleRate = 44100.0;
+};